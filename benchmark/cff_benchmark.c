@@ -0,0 +1,550 @@
+#include "cff.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Size of the ring buffer used by the preamble scan and streaming benchmarks
+#define BENCHMARK_RING_SIZE_BYTES (64 * 1024)
+
+// Size of the ring buffer and linear buffer used by the frame benchmarks, large enough for several of the largest
+// possible frames
+#define BENCHMARK_FRAME_BUFFER_SIZE_BYTES (256 * 1024)
+
+// Size of the frame stream fed through the ring buffer by the streaming benchmarks
+#define BENCHMARK_STREAM_SIZE_BYTES (256 * 1024)
+
+// Default minimum wall-clock time spent on each benchmark, to smooth out timer resolution and noise
+#define BENCHMARK_MIN_SECONDS 0.5
+
+// Output --------------------------------------------------------------------------------------------------------------
+
+typedef enum output_format_en_t {
+    output_format_text = 0,
+    output_format_csv,
+    output_format_json,
+} output_format_en_t;
+
+static output_format_en_t output_format = output_format_text;
+static double min_seconds = BENCHMARK_MIN_SECONDS;
+static size_t results_reported = 0;
+
+static void output_begin(void)
+{
+    if (output_format == output_format_csv) {
+        printf("group,name,value,unit\n");
+    }
+    else if (output_format == output_format_json) {
+        printf("{\n  \"crc_backend\": %d,\n  \"min_seconds\": %g,\n  \"results\": [", CFF_CRC_BACKEND, min_seconds);
+    }
+}
+
+static void output_end(void)
+{
+    if (output_format == output_format_json) {
+        printf("\n  ]\n}\n");
+    }
+}
+
+static void output_group(const char *title)
+{
+    if (output_format == output_format_text) {
+        printf("%s%s:\n", results_reported > 0 ? "\n" : "", title);
+    }
+}
+
+// Report one measurement. Group, name and unit together identify it, so keep them stable between releases.
+static void report(const char *group, const char *name, double value, const char *unit)
+{
+    switch (output_format) {
+    case output_format_text:
+        printf("  %-40s %14.1f %s\n", name, value, unit);
+        break;
+    case output_format_csv:
+        printf("%s,\"%s\",%.1f,%s\n", group, name, value, unit);
+        break;
+    case output_format_json:
+        printf("%s\n    {\"group\": \"%s\", \"name\": \"%s\", \"value\": %.1f, \"unit\": \"%s\"}",
+               results_reported > 0 ? "," : "", group, name, value, unit);
+        break;
+    }
+    results_reported++;
+}
+
+// Helpers -------------------------------------------------------------------------------------------------------------
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static void frame_sink(const cff_frame_t *frame)
+{
+    (void) frame;
+}
+
+static cff_callback_result_en_t frame_sink_ex(const cff_frame_t *frame, void *user)
+{
+    (void) frame;
+    (void) user;
+    return cff_callback_continue;
+}
+
+// Fill a buffer with pseudo-random bytes. Deterministic so runs are comparable.
+static void fill_random(uint8_t *buffer, size_t size_bytes, uint32_t seed)
+{
+    for (size_t i = 0; i < size_bytes; i++) {
+        seed = seed * 1103515245 + 12345;
+        buffer[i] = (uint8_t) (seed >> 16);
+    }
+}
+
+// Move an empty ring buffer's indices to position in its storage. Committing without writing and advancing past it
+// copies nothing.
+static void ring_buffer_move_to(cff_ring_buffer_t *ring_buffer, uint32_t position)
+{
+    cff_ring_buffer_advance(ring_buffer, cff_ring_buffer_available_data(ring_buffer));
+    uint32_t current = ring_buffer->append_index % ring_buffer->buffer_size;
+    uint32_t skip = (position + ring_buffer->buffer_size - current) % ring_buffer->buffer_size;
+    cff_ring_buffer_commit(ring_buffer, skip);
+    cff_ring_buffer_advance(ring_buffer, skip);
+}
+
+// Make the size_bytes already in a ring buffer's storage from position available again, so a parse benchmark can
+// repeat over the same data without copying it in every time
+static void ring_buffer_refill(cff_ring_buffer_t *ring_buffer, uint32_t position, uint32_t size_bytes)
+{
+    ring_buffer_move_to(ring_buffer, position);
+    cff_ring_buffer_commit(ring_buffer, size_bytes);
+}
+
+// Build back to back frames with payload_size_bytes payloads into buffer, as many as fit, and return their total size
+static size_t build_frames(uint8_t *buffer, size_t buffer_size, size_t payload_size_bytes, size_t *frame_count)
+{
+    static uint8_t payload[CFF_MAX_PAYLOAD_SIZE_BYTES];
+    size_t frame_size_bytes = cff_calculate_frame_size_bytes(payload_size_bytes);
+    size_t size = 0;
+    cff_frame_builder_t builder;
+
+    fill_random(payload, payload_size_bytes, 3);
+    *frame_count = 0;
+    while (size + frame_size_bytes <= buffer_size) {
+        cff_frame_builder_init(&builder, &buffer[size], buffer_size - size);
+        builder.frame_counter = (uint16_t) *frame_count;
+        cff_build_frame(&builder, payload, payload_size_bytes);
+        size += frame_size_bytes;
+        (*frame_count)++;
+    }
+
+    return size;
+}
+
+// Payload sizes covered by the build and parse benchmarks, from empty to the largest the format allows
+static const size_t payload_sizes[] = {0, 16, 64, 256, 1024, 4096, 16384, CFF_MAX_PAYLOAD_SIZE_BYTES};
+
+#define PAYLOAD_SIZE_COUNT (sizeof(payload_sizes) / sizeof(payload_sizes[0]))
+
+// CRC -----------------------------------------------------------------------------------------------------------------
+
+static void benchmark_crc(void)
+{
+    static const struct {
+        cff_crc_backend_en_t backend;
+        const char *name;
+    } backends[] = {
+        {cff_crc_backend_bytewise, "bytewise"},
+        {cff_crc_backend_slicing_by_4, "slicing-by-4"},
+        {cff_crc_backend_slicing_by_8, "slicing-by-8"},
+        {cff_crc_backend_clmul, "clmul"},
+    };
+    static const size_t sizes[] = {16, 256, 4096, 65536};
+    static uint8_t data[65536];
+    char name[64];
+
+    fill_random(data, sizeof(data), 4);
+    output_group("CRC throughput by backend and block size");
+
+    for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+        if (!cff_crc16_backend_available(backends[b].backend)) {
+            continue;
+        }
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            size_t bytes_hashed = 0;
+            uint16_t crc;
+            double start = now_seconds();
+            double elapsed = 0;
+            while (elapsed < min_seconds) {
+                for (size_t i = 0; i < 65536 / sizes[s] + 1; i++) {
+                    cff_crc16_with_backend(backends[b].backend, data, sizes[s], &crc);
+                    bytes_hashed += sizes[s];
+                }
+                elapsed = now_seconds() - start;
+            }
+            snprintf(name, sizeof(name), "%s, %u bytes", backends[b].name, (unsigned) sizes[s]);
+            report("crc", name, (double) bytes_hashed / elapsed / 1e6, "MB/s");
+        }
+    }
+
+    // The ring buffer variant, with the data in one piece and split around the end of the storage
+    static uint8_t ring_storage[BENCHMARK_RING_SIZE_BYTES];
+    cff_ring_buffer_t ring_buffer;
+    const uint32_t size = 4096;
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+    for (int wrapped = 0; wrapped <= 1; wrapped++) {
+        ring_buffer_move_to(&ring_buffer, wrapped ? (uint32_t) sizeof(ring_storage) - size / 2 : 0);
+        cff_ring_buffer_append(&ring_buffer, data, size);
+
+        size_t bytes_hashed = 0;
+        uint16_t crc;
+        double start = now_seconds();
+        double elapsed = 0;
+        while (elapsed < min_seconds) {
+            for (int i = 0; i < 64; i++) {
+                cff_crc16_ring_buffer(&ring_buffer, 0, size, &crc);
+                bytes_hashed += size;
+            }
+            elapsed = now_seconds() - start;
+        }
+        report("crc", wrapped ? "ring buffer, 4096 bytes, wrapped" : "ring buffer, 4096 bytes, contiguous",
+               (double) bytes_hashed / elapsed / 1e6, "MB/s");
+    }
+}
+
+// Build ---------------------------------------------------------------------------------------------------------------
+
+static void benchmark_build(void)
+{
+    static uint8_t buffer[CFF_MAX_PAYLOAD_SIZE_BYTES + CFF_MIN_FRAME_SIZE_BYTES];
+    static uint8_t payload[CFF_MAX_PAYLOAD_SIZE_BYTES];
+    cff_frame_builder_t builder;
+    char name[64];
+
+    fill_random(payload, sizeof(payload), 5);
+    cff_frame_builder_init(&builder, buffer, sizeof(buffer));
+    output_group("cff_build_frame() by payload size");
+
+    for (size_t s = 0; s < PAYLOAD_SIZE_COUNT; s++) {
+        size_t frame_size_bytes = cff_calculate_frame_size_bytes(payload_sizes[s]);
+        size_t batch = BENCHMARK_FRAME_BUFFER_SIZE_BYTES / frame_size_bytes + 1;
+        size_t frames_built = 0;
+        double start = now_seconds();
+        double elapsed = 0;
+        while (elapsed < min_seconds) {
+            for (size_t i = 0; i < batch; i++) {
+                cff_build_frame(&builder, payload, payload_sizes[s]);
+            }
+            frames_built += batch;
+            elapsed = now_seconds() - start;
+        }
+
+        snprintf(name, sizeof(name), "%u byte payload", (unsigned) payload_sizes[s]);
+        report("build_frames", name, (double) frames_built / elapsed, "frames/s");
+        report("build_bytes", name, (double) (frames_built * frame_size_bytes) / elapsed / 1e6, "MB/s");
+    }
+}
+
+// Parse ---------------------------------------------------------------------------------------------------------------
+
+typedef enum parse_layout_en_t {
+    parse_layout_contiguous = 0, //!< Frames start at the start of the ring buffer storage
+    parse_layout_wrapped,        //!< The first frame is split around the end of the storage
+    parse_layout_linear,         //!< Frames are parsed in place with cff_parse_buffer()
+} parse_layout_en_t;
+
+static void benchmark_parse(parse_layout_en_t layout)
+{
+    static const char *const layout_names[] = {"contiguous", "wrapped", "linear"};
+    static uint8_t stream[BENCHMARK_FRAME_BUFFER_SIZE_BYTES];
+    static uint8_t ring_storage[BENCHMARK_FRAME_BUFFER_SIZE_BYTES];
+    cff_ring_buffer_t ring_buffer;
+    char title[64];
+    char name[64];
+
+    snprintf(title, sizeof(title), "Parsing frames by payload size, %s", layout_names[layout]);
+    output_group(title);
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+
+    for (size_t s = 0; s < PAYLOAD_SIZE_COUNT; s++) {
+        size_t frame_size_bytes = cff_calculate_frame_size_bytes(payload_sizes[s]);
+        size_t frame_count;
+        // Leave room for the first frame to be split around the end of the storage
+        size_t size = build_frames(stream, sizeof(stream) - frame_size_bytes, payload_sizes[s], &frame_count);
+        uint32_t position = 0;
+        if (layout == parse_layout_wrapped) {
+            position = (uint32_t) (sizeof(ring_storage) - frame_size_bytes / 2);
+        }
+
+        if (layout != parse_layout_linear) {
+            ring_buffer_move_to(&ring_buffer, position);
+            cff_ring_buffer_append(&ring_buffer, stream, (uint32_t) size);
+        }
+
+        size_t frames_parsed = 0;
+        double start = now_seconds();
+        double elapsed = 0;
+        while (elapsed < min_seconds) {
+            if (layout == parse_layout_linear) {
+                cff_parse_buffer(stream, size, frame_sink_ex, NULL, NULL);
+            }
+            else {
+                ring_buffer_refill(&ring_buffer, position, (uint32_t) size);
+                cff_parse_frames(&ring_buffer, frame_sink);
+            }
+            frames_parsed += frame_count;
+            elapsed = now_seconds() - start;
+        }
+
+        snprintf(name, sizeof(name), "%u byte payload, %s", (unsigned) payload_sizes[s], layout_names[layout]);
+        report("parse_frames", name, (double) frames_parsed / elapsed, "frames/s");
+        report("parse_bytes", name, (double) (frames_parsed * frame_size_bytes) / elapsed / 1e6, "MB/s");
+    }
+}
+
+// Streaming -----------------------------------------------------------------------------------------------------------
+
+// Build a stream of frames with 64 byte payloads. A noisy stream has up to 31 bytes of line noise between frames and
+// a corrupted payload in every eighth frame, roughly what a marginal UART link delivers.
+static size_t build_stream(uint8_t *stream, size_t stream_size, int noisy)
+{
+    uint8_t payload[64];
+    uint8_t noise[32];
+    size_t frame_size_bytes = cff_calculate_frame_size_bytes(sizeof(payload));
+    size_t size = 0;
+    uint32_t seed = 6;
+    cff_frame_builder_t builder;
+
+    for (size_t i = 0;; i++) {
+        size_t noise_size = 0;
+        if (noisy) {
+            seed = seed * 1103515245 + 12345;
+            noise_size = (seed >> 16) % sizeof(noise);
+            fill_random(noise, noise_size, seed);
+        }
+        if (size + noise_size + frame_size_bytes > stream_size) {
+            break;
+        }
+        memcpy(&stream[size], noise, noise_size);
+        size += noise_size;
+
+        fill_random(payload, sizeof(payload), (uint32_t) i);
+        cff_frame_builder_init(&builder, &stream[size], stream_size - size);
+        builder.frame_counter = (uint16_t) i;
+        cff_build_frame(&builder, payload, sizeof(payload));
+        if (noisy && i % 8 == 7) {
+            stream[size + CFF_HEADER_SIZE_BYTES] ^= 0x01;
+        }
+        size += frame_size_bytes;
+    }
+
+    return size;
+}
+
+// Measure parsing a stream appended in odd-sized chunks, as a UART driver would, with the stream parsed after every
+// chunk. The result includes copying the stream into the ring buffer.
+static void benchmark_stream(const char *name, const uint8_t *stream, size_t stream_size, uint32_t ring_size,
+                             uint32_t chunk_size)
+{
+    static uint8_t ring_storage[BENCHMARK_RING_SIZE_BYTES];
+    cff_ring_buffer_t ring_buffer;
+    cff_parser_t parser;
+    size_t bytes_streamed = 0;
+    size_t frames_parsed = 0;
+
+    cff_ring_buffer_init(&ring_buffer, ring_storage, ring_size);
+    cff_parser_init(&parser, &ring_buffer);
+
+    double start = now_seconds();
+    double elapsed = 0;
+    while (elapsed < min_seconds) {
+        for (size_t offset = 0; offset < stream_size; offset += chunk_size) {
+            uint32_t size = (uint32_t) CFF_MIN(chunk_size, stream_size - offset);
+            cff_ring_buffer_append(&ring_buffer, &stream[offset], size);
+            frames_parsed += cff_parser_parse_frames(&parser, frame_sink);
+        }
+        bytes_streamed += stream_size;
+        elapsed = now_seconds() - start;
+    }
+
+    report("stream_bytes", name, (double) bytes_streamed / elapsed / 1e6, "MB/s");
+    report("stream_frames", name, (double) frames_parsed / elapsed, "frames/s");
+}
+
+// Measure ring buffer index overhead on a given storage size. Running the same workload with a power-of-two size and
+// a size one smaller compares the masked and compared index paths.
+static void benchmark_ring_indices(const char *name, uint32_t ring_size)
+{
+    static uint8_t ring_storage[BENCHMARK_RING_SIZE_BYTES];
+    cff_ring_buffer_t ring_buffer;
+    size_t operations = 0;
+    uint8_t byte = 0;
+
+    cff_ring_buffer_init(&ring_buffer, ring_storage, ring_size);
+
+    // Single-element operations, where index arithmetic is most of the cost
+    double start = now_seconds();
+    double elapsed = 0;
+    while (elapsed < min_seconds) {
+        for (int i = 0; i < 100000; i++) {
+            cff_ring_buffer_append(&ring_buffer, &byte, 1);
+            cff_ring_buffer_consume(&ring_buffer, &byte, 1);
+        }
+        operations += 100000;
+        elapsed = now_seconds() - start;
+    }
+
+    report("ring_append_consume", name, (double) operations / elapsed / 1e6, "Mops/s");
+}
+
+static void benchmark_streaming(void)
+{
+    static uint8_t stream[BENCHMARK_STREAM_SIZE_BYTES];
+    size_t stream_size;
+
+    output_group("Streaming parse, 64 byte payloads appended in 61 byte chunks");
+    stream_size = build_stream(stream, sizeof(stream), 0);
+    benchmark_stream("clean, 4096 byte ring (power of two)", stream, stream_size, 4096, 61);
+    benchmark_stream("clean, 4095 byte ring", stream, stream_size, 4095, 61);
+    benchmark_stream("clean, 256 byte ring (power of two)", stream, stream_size, 256, 61);
+    benchmark_stream("clean, 255 byte ring", stream, stream_size, 255, 61);
+
+    stream_size = build_stream(stream, sizeof(stream), 1);
+    benchmark_stream("noisy, 4096 byte ring (power of two)", stream, stream_size, 4096, 61);
+    benchmark_stream("noisy, 255 byte ring", stream, stream_size, 255, 61);
+
+    output_group("Single-element append and consume by ring buffer size");
+    benchmark_ring_indices("4096 bytes (power of two)", 4096);
+    benchmark_ring_indices("4095 bytes", 4095);
+    benchmark_ring_indices("256 bytes (power of two)", 256);
+    benchmark_ring_indices("255 bytes", 255);
+}
+
+// Resync --------------------------------------------------------------------------------------------------------------
+
+// Measure how fast cff_parse_frames() skips over data that contains no valid frame, which is the cost of resyncing
+// after a line glitch
+static void benchmark_preamble_scan(const char *name, const uint8_t *garbage, uint32_t garbage_size,
+                                    uint32_t start_index)
+{
+    static uint8_t ring_storage[BENCHMARK_RING_SIZE_BYTES];
+    cff_ring_buffer_t ring_buffer;
+    size_t bytes_scanned = 0;
+
+    // Position the data so that it wraps around the end of the storage at start_index
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+    ring_buffer_move_to(&ring_buffer, start_index);
+    cff_ring_buffer_append(&ring_buffer, garbage, garbage_size);
+
+    double start = now_seconds();
+    double elapsed = 0;
+    while (elapsed < min_seconds) {
+        ring_buffer_refill(&ring_buffer, start_index, garbage_size);
+        cff_parse_frames(&ring_buffer, frame_sink);
+        bytes_scanned += garbage_size;
+        elapsed = now_seconds() - start;
+    }
+
+    report("resync", name, (double) bytes_scanned / elapsed / 1e6, "MB/s");
+}
+
+static void benchmark_resync(void)
+{
+    static uint8_t garbage[BENCHMARK_RING_SIZE_BYTES];
+
+    output_group("Resync: skipping data that contains no valid frame");
+
+    // Random line noise, containing the occasional false preamble
+    fill_random(garbage, sizeof(garbage), 1);
+    benchmark_preamble_scan("random, contiguous", garbage, sizeof(garbage), 0);
+    benchmark_preamble_scan("random, wrapped", garbage, sizeof(garbage), sizeof(garbage) / 2);
+
+    // Worst case for memchr: every other byte is the first preamble byte
+    for (size_t i = 0; i < sizeof(garbage); i++) {
+        garbage[i] = (i % 2 == 0) ? CFF_PREAMBLE_BYTE_0 : 0x00;
+    }
+    benchmark_preamble_scan("0xFA every other byte", garbage, sizeof(garbage), 0);
+
+    // Worst case for header validation: every candidate is a full preamble with a bad header behind it
+    for (size_t i = 0; i < sizeof(garbage); i++) {
+        garbage[i] = (i % 2 == 0) ? CFF_PREAMBLE_BYTE_0 : CFF_PREAMBLE_BYTE_1;
+    }
+    benchmark_preamble_scan("false preamble every other byte", garbage, sizeof(garbage), 0);
+
+    memset(garbage, 0, sizeof(garbage));
+    benchmark_preamble_scan("all zero", garbage, sizeof(garbage), 0);
+}
+
+// Main ----------------------------------------------------------------------------------------------------------------
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "Usage: %s [--format text|csv|json] [--min-time seconds] [--only crc|build|parse|stream|resync]\n",
+            program);
+}
+
+int main(int argc, char **argv)
+{
+    const char *only = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            const char *format = argv[++i];
+            if (strcmp(format, "text") == 0) {
+                output_format = output_format_text;
+            }
+            else if (strcmp(format, "csv") == 0) {
+                output_format = output_format_csv;
+            }
+            else if (strcmp(format, "json") == 0) {
+                output_format = output_format_json;
+            }
+            else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            min_seconds = atof(argv[++i]);
+            if (min_seconds <= 0) {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--only") == 0 && i + 1 < argc) {
+            only = argv[++i];
+            if (strcmp(only, "crc") != 0 && strcmp(only, "build") != 0 && strcmp(only, "parse") != 0 &&
+                strcmp(only, "stream") != 0 && strcmp(only, "resync") != 0) {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    output_begin();
+    if (only == NULL || strcmp(only, "crc") == 0) {
+        benchmark_crc();
+    }
+    if (only == NULL || strcmp(only, "build") == 0) {
+        benchmark_build();
+    }
+    if (only == NULL || strcmp(only, "parse") == 0) {
+        benchmark_parse(parse_layout_contiguous);
+        benchmark_parse(parse_layout_wrapped);
+        benchmark_parse(parse_layout_linear);
+    }
+    if (only == NULL || strcmp(only, "stream") == 0) {
+        benchmark_streaming();
+    }
+    if (only == NULL || strcmp(only, "resync") == 0) {
+        benchmark_resync();
+    }
+    output_end();
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+#include "cff_async.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+// Many links served by one thread: a coroutine per link co_awaits its frames, while the loop below plays the part of
+// the event loop, committing whatever each link received in chunks that rarely line up with frames
+
+// Smallest coroutine type for the example: starts immediately, destroys itself when it returns
+struct Task {
+    struct promise_type {
+        Task get_return_object() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+        }
+    };
+};
+
+struct Link {
+    cff::RingBuffer<512> ring_buffer;
+    cff::FrameStream stream{ring_buffer};
+    std::vector<std::uint8_t> input; // What the link will receive
+    std::size_t received = 0;
+    std::size_t commits = 0;
+    std::size_t payload_bytes = 0;
+    bool finished = false;
+};
+
+static Task receive(Link &link)
+{
+    while (std::optional<cff::Frame> frame = co_await link.stream.next_frame()) {
+        link.payload_bytes += frame->payload().size();
+    }
+    link.finished = true;
+}
+
+int main()
+{
+    constexpr std::size_t link_count = 1000;
+    constexpr std::size_t frames_per_link = 50;
+
+    std::array<std::uint8_t, 256> build_buffer;
+    std::array<std::uint8_t, 200> payload;
+    cff::FrameBuilder builder(build_buffer);
+    std::vector<std::unique_ptr<Link>> links;
+    std::uint32_t random_state = 1;
+
+    for (std::size_t i = 0; i < link_count; i++) {
+        auto link = std::make_unique<Link>();
+        for (std::size_t n = 0; n < frames_per_link; n++) {
+            random_state = random_state * 1103515245 + 12345;
+            builder.build(std::span(payload).first((random_state >> 8) % payload.size()));
+            link->input.insert(link->input.end(), builder.frame().begin(), builder.frame().end());
+        }
+        receive(*link);
+        links.push_back(std::move(link));
+    }
+
+    // Round robin over the links, committing a few bytes at a time as reads from sockets or UARTs would
+    bool active = true;
+    while (active) {
+        active = false;
+        for (auto &link : links) {
+            std::span<std::uint8_t> region = link->stream.reserve();
+            random_state = random_state * 1103515245 + 12345;
+            std::size_t chunk = std::min({region.size(), link->input.size() - link->received,
+                                          static_cast<std::size_t>(1 + (random_state >> 8) % 64)});
+            if (chunk == 0) {
+                continue;
+            }
+            std::copy_n(link->input.begin() + static_cast<std::ptrdiff_t>(link->received), chunk, region.begin());
+            link->received += chunk;
+            link->commits++;
+            link->stream.commit(chunk);
+            active = true;
+        }
+    }
+
+    std::size_t commits = 0;
+    std::size_t frames = 0;
+    std::size_t finished = 0;
+    for (auto &link : links) {
+        link->stream.close();
+        commits += link->commits;
+        frames += link->stream.frames_delivered();
+        finished += link->finished ? 1 : 0;
+    }
+
+    std::printf("%zu links, %zu commits, %zu coroutine resumes with a frame, %zu receivers finished\n", link_count,
+                commits, frames, finished);
+    return frames == link_count * frames_per_link && finished == link_count ? 0 : -1;
+}
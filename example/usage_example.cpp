@@ -0,0 +1,126 @@
+#include "cff.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+static std::size_t frames_seen = 0;
+
+static bool count_frame(const cff::Frame &)
+{
+    frames_seen++;
+    return true;
+}
+
+// Every parse entry point takes any callable: a lambda, a const lambda, a function or a function pointer. Each is
+// handed one frame at a time.
+template <typename Handler>
+static bool parse_one_frame_each_way(std::span<const std::uint8_t> frame, Handler &&handler)
+{
+    cff::RingBuffer<64> ring_buffer;
+    ring_buffer.append(frame);
+    bool ok = cff::parse(ring_buffer, handler) == 1;
+    ok = ok && cff::parse(frame, handler) == frame.size();
+
+    cff::Parser parser(ring_buffer);
+    ring_buffer.append(frame);
+    return ok && parser.parse(handler) == 1;
+}
+
+static bool parse_with_every_handler_kind(std::span<const std::uint8_t> frame)
+{
+    std::size_t lambda_frames = 0;
+    auto lambda = [&](const cff::Frame &) { lambda_frames++; };
+    const auto const_lambda = [](const cff::Frame &) { return cff_callback_continue; };
+    bool (*function_pointer)(const cff::Frame &) = count_frame;
+
+    bool ok = parse_one_frame_each_way(frame, lambda) && parse_one_frame_each_way(frame, const_lambda) &&
+              parse_one_frame_each_way(frame, count_frame) && parse_one_frame_each_way(frame, function_pointer);
+    return ok && lambda_frames == 3 && frames_seen == 6;
+}
+
+// The inline index arithmetic must agree with the C API it replaces, across the wrap of the storage and of the indices
+template <std::size_t N>
+static bool indices_match_c_api()
+{
+    cff::RingBuffer<N> ring_buffer;
+    const cff_ring_buffer_t *c_ring_buffer = ring_buffer.get();
+    for (std::size_t step = 0; step < 4 * N; step++) {
+        std::span<std::uint8_t> region = ring_buffer.reserve();
+        std::size_t count = std::min(region.size(), 1 + step % 5);
+        if (ring_buffer.commit(count) != cff_error_none || ring_buffer.advance(count / 2 + 1) != cff_error_none) {
+            return false;
+        }
+        if (ring_buffer.available() != cff_ring_buffer_available_data(c_ring_buffer) ||
+            ring_buffer.free_space() != cff_ring_buffer_free_space(c_ring_buffer)) {
+            return false;
+        }
+    }
+    return ring_buffer.commit(ring_buffer.free_space() + 1) == cff_error_insufficient_space &&
+           ring_buffer.advance(ring_buffer.available() + 1) == cff_error_insufficient_space;
+}
+
+// The C usage example, written against the C++ wrapper
+int main()
+{
+    std::array<std::uint8_t, 256> build_buffer;
+    cff::FrameBuilder builder(build_buffer);
+    cff::RingBuffer<1024> ring_buffer;
+
+    // Build frames straight into the ring buffer's stream
+    constexpr std::string_view messages[] = {"Hello, World!", "CFF Frame 2", "Final message"};
+    for (std::string_view message : messages) {
+        auto payload = std::span(reinterpret_cast<const std::uint8_t *>(message.data()), message.size());
+        if (builder.build(payload) != cff_error_none || ring_buffer.append(builder.frame()) != cff_error_none) {
+            std::printf("Failed to build frame \"%.*s\"\n", static_cast<int>(message.size()), message.data());
+            return -1;
+        }
+        std::printf("Built frame %zu bytes: \"%.*s\"\n", builder.frame().size(), static_cast<int>(message.size()),
+                    message.data());
+    }
+
+    // A payload written in pieces
+    const char *pieces[] = {"Streamed ", "in ", "pieces"};
+    std::size_t streamed_size = 0;
+    for (const char *piece : pieces) {
+        streamed_size += std::strlen(piece);
+    }
+    builder.begin(streamed_size);
+    for (const char *piece : pieces) {
+        builder.append(std::span(reinterpret_cast<const std::uint8_t *>(piece), std::strlen(piece)));
+    }
+    if (builder.end() != cff_error_none || ring_buffer.append(builder.frame()) != cff_error_none) {
+        std::printf("Failed to build streamed frame\n");
+        return -1;
+    }
+
+    std::printf("\nParsing %zu bytes:\n", ring_buffer.available());
+
+    // The handler is called inline, no function pointer or user pointer needed
+    std::size_t payload_bytes = 0;
+    std::size_t parsed_frames = cff::parse(ring_buffer, [&](const cff::Frame &frame) {
+        std::array<std::uint8_t, 256> text;
+        cff::PayloadView payload = frame.payload();
+        payload_bytes += payload.size();
+        if (payload.copy_to(text) == cff_error_none) {
+            std::printf("Received frame %u: %.*s\n", frame.frame_counter(), static_cast<int>(payload.size()),
+                        reinterpret_cast<const char *>(text.data()));
+        }
+    });
+
+    std::printf("\nParsed %zu frames, %zu payload bytes\n", parsed_frames, payload_bytes);
+
+    if (!indices_match_c_api<16>() || !indices_match_c_api<12>()) {
+        std::printf("Ring buffer indices differ from the C API\n");
+        return -1;
+    }
+
+    const std::uint8_t ping[] = {0x01};
+    builder.build(ping);
+    if (!parse_with_every_handler_kind(builder.frame())) {
+        std::printf("Parsing with every handler kind failed\n");
+        return -1;
+    }
+    return parsed_frames == std::size(messages) + 1 ? 0 : -1;
+}
@@ -0,0 +1,451 @@
+#include "cff_fuzz.h"
+#include "cff.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Ring buffer sizes selected by the first input byte: tiny, odd, a power of two, and big enough for the largest frame
+static const uint32_t ring_sizes[] = {64, 1000, 4096, CFF_MAX_PAYLOAD_SIZE_BYTES + CFF_MIN_FRAME_SIZE_BYTES + 7};
+
+#define RING_SIZE_COUNT (sizeof(ring_sizes) / sizeof(ring_sizes[0]))
+
+// Counting CRC provider -----------------------------------------------------------------------------------------------
+
+// An independent table-driven CRC-16/CCITT-FALSE, which also checks the library's CRC backends, that counts the bytes
+// fed to it. Bytes hashed are the work that can blow up on hostile input: every byte of the stream is scanned for a
+// preamble once, but a header or payload can be hashed again for every candidate frame it belongs to.
+static uint16_t crc_table[256];
+static size_t bytes_hashed = 0;
+
+static uint16_t counting_crc_begin(void *context)
+{
+    (void) context;
+    return CFF_CRC_INIT;
+}
+
+static uint16_t counting_crc_update(void *context, uint16_t crc, const uint8_t *data, size_t data_size_bytes)
+{
+    (void) context;
+    for (size_t i = 0; i < data_size_bytes; i++) {
+        crc = (uint16_t) ((crc << 8) ^ crc_table[(uint8_t) ((crc >> 8) ^ data[i])]);
+    }
+    bytes_hashed += data_size_bytes;
+    return crc;
+}
+
+static uint16_t counting_crc_finish(void *context, uint16_t crc)
+{
+    (void) context;
+    return crc;
+}
+
+static const cff_crc_provider_t counting_crc_provider = {
+    counting_crc_begin,
+    counting_crc_update,
+    counting_crc_finish,
+    NULL,
+};
+
+static void counting_crc_install(void)
+{
+    static bool initialized = false;
+    if (!initialized) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint16_t crc = (uint16_t) (i << 8);
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (uint16_t) ((crc & 0x8000) ? (crc << 1) ^ CFF_CRC_POLYNOMIAL : crc << 1);
+            }
+            crc_table[i] = crc;
+        }
+        initialized = true;
+    }
+    cff_crc_set_provider(&counting_crc_provider);
+}
+
+static uint16_t reference_crc(const uint8_t *data, size_t size)
+{
+    size_t saved = bytes_hashed;
+    uint16_t crc = counting_crc_update(NULL, CFF_CRC_INIT, data, size);
+    bytes_hashed = saved;
+    return crc;
+}
+
+// Reference parser ----------------------------------------------------------------------------------------------------
+
+typedef struct fuzz_frame_t {
+    size_t offset;
+    uint16_t frame_counter;
+    uint16_t payload_size_bytes;
+} fuzz_frame_t;
+
+typedef struct fuzz_frames_t {
+    fuzz_frame_t *frames;
+    size_t count;
+    size_t capacity;
+} fuzz_frames_t;
+
+static uint16_t get_uint16_le(const uint8_t *data)
+{
+    return (uint16_t) (data[0] | (data[1] << 8));
+}
+
+// The simplest parser that follows the format: try every position in turn and take the first valid frame. Frames
+// longer than max_frame_size can't fit in the ring buffer and are rejected. Returns the offset of the first byte left
+// unparsed, a frame that ran past the end of the stream or a trailing first preamble byte, and counts the bytes a
+// parser has to hash: each candidate's header, and each candidate's payload as far as it has arrived.
+static size_t reference_parse(const uint8_t *stream, size_t size, size_t max_frame_size, fuzz_frames_t *frames,
+                              size_t *hashed)
+{
+    size_t i = 0;
+    frames->count = 0;
+    *hashed = 0;
+
+    while (i < size) {
+        if (stream[i] != CFF_PREAMBLE_BYTE_0) {
+            i++;
+            continue;
+        }
+        if (size - i < CFF_PREAMBLE_SIZE_BYTES) {
+            return i;
+        }
+        if (stream[i + 1] != CFF_PREAMBLE_BYTE_1) {
+            i++;
+            continue;
+        }
+        if (size - i < CFF_HEADER_SIZE_BYTES) {
+            return i;
+        }
+
+        // The second preamble byte can't start a preamble, so moving on by one is the same as skipping the preamble
+        *hashed += CFF_HEADER_SIZE_BYTES - CFF_HEADER_CRC_SIZE_BYTES;
+        if (reference_crc(&stream[i], 6) != get_uint16_le(&stream[i + 6])) {
+            i++;
+            continue;
+        }
+
+        uint16_t payload_size_bytes = get_uint16_le(&stream[i + 4]);
+        size_t frame_size_bytes = cff_calculate_frame_size_bytes(payload_size_bytes);
+        if (frame_size_bytes > max_frame_size) {
+            i++;
+            continue;
+        }
+        if (size - i < frame_size_bytes) {
+            *hashed += CFF_MIN(size - i - CFF_HEADER_SIZE_BYTES, (size_t) payload_size_bytes);
+            return i;
+        }
+
+        *hashed += payload_size_bytes;
+        const uint8_t *payload = &stream[i + CFF_HEADER_SIZE_BYTES];
+        if (reference_crc(payload, payload_size_bytes) != get_uint16_le(&payload[payload_size_bytes])) {
+            i++;
+            continue;
+        }
+
+        fuzz_frame_t *frame = &frames->frames[frames->count++];
+        frame->offset = i;
+        frame->frame_counter = get_uint16_le(&stream[i + 2]);
+        frame->payload_size_bytes = payload_size_bytes;
+        i += frame_size_bytes;
+    }
+
+    return size;
+}
+
+// Checks --------------------------------------------------------------------------------------------------------------
+
+// State shared by the checks of one entry point
+typedef struct fuzz_run_t {
+    const char *name;              // Entry point being checked
+    const uint8_t *stream;         // Whole stream, to compare payloads against
+    size_t stream_size;            // Size of the stream
+    const fuzz_frames_t *expected; // Frames the reference found
+    size_t frames_seen;            // Frames delivered so far
+    size_t stream_appended;        // Bytes of the stream appended to the ring buffer so far
+    bool failed;                   // Whether a check has failed
+} fuzz_run_t;
+
+static void fail(fuzz_run_t *run, const char *message, size_t value)
+{
+    if (!run->failed) {
+        fprintf(stderr, "%s: %s (%zu)\n", run->name, message, value);
+    }
+    run->failed = true;
+}
+
+// Compare a delivered frame, found offset bytes into the stream, with the next one the reference found
+static void check_frame(fuzz_run_t *run, const cff_frame_t *frame, size_t offset)
+{
+    if (run->frames_seen >= run->expected->count) {
+        fail(run, "frame the reference doesn't have at offset", offset);
+        return;
+    }
+
+    const fuzz_frame_t *expected = &run->expected->frames[run->frames_seen++];
+    if (offset != expected->offset) {
+        fail(run, "frame at the wrong offset, expected", expected->offset);
+        return;
+    }
+    if (frame->header.frame_counter != expected->frame_counter ||
+        frame->payload_size_bytes != expected->payload_size_bytes) {
+        fail(run, "frame header doesn't match at offset", offset);
+        return;
+    }
+
+    // The payload must be readable in place and hold the stream's bytes
+    cff_span_t spans[CFF_PAYLOAD_SPAN_COUNT];
+    if (cff_frame_payload_spans(frame, spans) != cff_error_none) {
+        fail(run, "no payload spans at offset", offset);
+        return;
+    }
+    if (spans[0].size_bytes + spans[1].size_bytes != expected->payload_size_bytes) {
+        fail(run, "payload spans have the wrong size at offset", offset);
+        return;
+    }
+    const uint8_t *payload = &run->stream[offset + CFF_HEADER_SIZE_BYTES];
+    if (memcmp(spans[0].data, payload, spans[0].size_bytes) != 0 ||
+        (spans[1].size_bytes > 0 && memcmp(spans[1].data, &payload[spans[0].size_bytes], spans[1].size_bytes) != 0)) {
+        fail(run, "payload doesn't match at offset", offset);
+    }
+}
+
+static void check_end(fuzz_run_t *run, size_t remaining, size_t expected_remaining)
+{
+    if (run->frames_seen != run->expected->count) {
+        fail(run, "frames missing, found", run->frames_seen);
+    }
+    if (remaining != expected_remaining) {
+        fail(run, "wrong number of bytes left unparsed", remaining);
+    }
+}
+
+// The ring buffer holds the stream up to stream_appended, so its consume index is that far back from there
+static size_t stream_offset(const fuzz_run_t *run, const cff_ring_buffer_t *ring_buffer, uint32_t offset_bytes)
+{
+    return run->stream_appended - cff_ring_buffer_available_data(ring_buffer) + offset_bytes;
+}
+
+static void ring_frame_callback(const cff_frame_t *frame, fuzz_run_t *run)
+{
+    check_frame(run, frame, stream_offset(run, frame->ring_buffer, frame->offset_bytes));
+}
+
+static cff_callback_result_en_t ring_frame_callback_ex(const cff_frame_t *frame, void *user)
+{
+    ring_frame_callback(frame, (fuzz_run_t *) user);
+    return cff_callback_continue;
+}
+
+// A plain cff_callback_t has no user pointer
+static fuzz_run_t *current_run = NULL;
+
+static void ring_frame_callback_plain(const cff_frame_t *frame)
+{
+    ring_frame_callback(frame, current_run);
+}
+
+// Append at most chunk_size more bytes of the stream to the ring buffer, return whether there was anything to append
+static bool feed(cff_ring_buffer_t *ring_buffer, fuzz_run_t *run, size_t chunk_size)
+{
+    size_t size = CFF_MIN(chunk_size, run->stream_size - run->stream_appended);
+    size = CFF_MIN(size, (size_t) cff_ring_buffer_free_space(ring_buffer));
+    cff_ring_buffer_append(ring_buffer, &run->stream[run->stream_appended], (uint32_t) size);
+    run->stream_appended += size;
+    return size > 0;
+}
+
+typedef enum fuzz_mode_en_t {
+    fuzz_mode_parse_frames = 0, // cff_parse_frames() after every append
+    fuzz_mode_parser,           // cff_parser_parse_frames_ex() after every append
+    fuzz_mode_parse_frame,      // cff_parse_frame(), dropping a byte on every error
+} fuzz_mode_en_t;
+
+// Stream the input through a ring buffer with one of the ring buffer entry points
+static bool check_ring_buffer(fuzz_run_t *run, fuzz_mode_en_t mode, uint32_t ring_size, uint32_t start_position,
+                              size_t chunk_size, size_t expected_remaining)
+{
+    // Storage allocated to its exact size, so the sanitizers catch any access past it
+    uint8_t *storage = malloc(ring_size);
+    cff_ring_buffer_t ring_buffer;
+    cff_parser_t parser;
+    if (storage == NULL) {
+        return false;
+    }
+    cff_ring_buffer_init(&ring_buffer, storage, ring_size);
+    cff_parser_init(&parser, &ring_buffer);
+
+    // Start somewhere in the storage so the stream wraps around its end
+    cff_ring_buffer_commit(&ring_buffer, start_position);
+    cff_ring_buffer_advance(&ring_buffer, start_position);
+
+    for (;;) {
+        bool appended = feed(&ring_buffer, run, mode == fuzz_mode_parser ? chunk_size : SIZE_MAX);
+        if (!appended && run->stream_appended == run->stream_size) {
+            break;
+        }
+        if (!appended) {
+            fail(run, "ring buffer full and not parsing, at", run->stream_appended);
+            break;
+        }
+
+        if (mode == fuzz_mode_parse_frames) {
+            current_run = run;
+            cff_parse_frames(&ring_buffer, ring_frame_callback_plain);
+        }
+        else if (mode == fuzz_mode_parser) {
+            cff_parser_parse_frames_ex(&parser, ring_frame_callback_ex, run);
+        }
+        else {
+            for (;;) {
+                cff_frame_t frame;
+                size_t offset = stream_offset(run, &ring_buffer, 0);
+                cff_error_en_t error = cff_parse_frame(&ring_buffer, &frame);
+                if (error == cff_error_none) {
+                    // The frame has been consumed, but its bytes stay in the storage until the next append
+                    check_frame(run, &frame, offset);
+                }
+                else if (error == cff_error_incomplete_frame) {
+                    break;
+                }
+                else {
+                    cff_ring_buffer_advance(&ring_buffer, 1);
+                }
+            }
+        }
+    }
+
+    // A cff_parse_frame() loop waits for a whole header, even when the last bytes can't start one
+    if (mode == fuzz_mode_parse_frame) {
+        if (run->frames_seen != run->expected->count) {
+            fail(run, "frames missing, found", run->frames_seen);
+        }
+    }
+    else {
+        check_end(run, cff_ring_buffer_available_data(&ring_buffer), expected_remaining);
+    }
+
+    free(storage);
+    return !run->failed;
+}
+
+static cff_callback_result_en_t buffer_frame_callback(const cff_frame_t *frame, void *user)
+{
+    fuzz_run_t *run = user;
+    check_frame(run, frame, frame->offset_bytes);
+    return cff_callback_continue;
+}
+
+// Parse the input in place with cff_parse_buffer()
+static bool check_buffer(fuzz_run_t *run, size_t expected_remaining)
+{
+    // Copied to a buffer of its exact size, so the sanitizers catch any access past its end
+    uint8_t *copy = malloc(run->stream_size > 0 ? run->stream_size : 1);
+    if (copy == NULL) {
+        return false;
+    }
+    memcpy(copy, run->stream, run->stream_size);
+
+    size_t frames_parsed = 0;
+    size_t consumed = cff_parse_buffer(copy, run->stream_size, buffer_frame_callback, run, &frames_parsed);
+    check_end(run, run->stream_size - consumed, expected_remaining);
+    if (frames_parsed != run->frames_seen) {
+        fail(run, "wrong frame count returned", frames_parsed);
+    }
+
+    free(copy);
+    return !run->failed;
+}
+
+static void init_run(fuzz_run_t *run, const char *name, const uint8_t *stream, size_t size,
+                     const fuzz_frames_t *expected)
+{
+    memset(run, 0, sizeof(*run));
+    run->name = name;
+    run->stream = stream;
+    run->stream_size = size;
+    run->expected = expected;
+}
+
+// Fail if an entry point fed more bytes to the CRC than the reference had to
+static bool check_work(const char *name, size_t hashed, size_t reference_hashed, cff_fuzz_result_t *result)
+{
+    if (result != NULL && hashed > result->bytes_hashed) {
+        result->bytes_hashed = hashed;
+    }
+    if (hashed > reference_hashed) {
+        fprintf(stderr, "%s: hashed %zu bytes, the reference only needs %zu\n", name, hashed, reference_hashed);
+        return false;
+    }
+    return true;
+}
+
+int cff_fuzz_check(const uint8_t *data, size_t size, cff_fuzz_result_t *result)
+{
+    if (result != NULL) {
+        memset(result, 0, sizeof(*result));
+    }
+    if (size < CFF_FUZZ_CONFIG_SIZE_BYTES) {
+        return 0;
+    }
+
+    uint32_t ring_size = ring_sizes[data[0] % RING_SIZE_COUNT];
+    uint32_t start_position = (uint32_t) ((uint64_t) data[1] * ring_size / 256);
+    size_t chunk_size = data[2] > 0 ? data[2] : ring_size;
+    const uint8_t *stream = &data[CFF_FUZZ_CONFIG_SIZE_BYTES];
+    size_t stream_size = size - CFF_FUZZ_CONFIG_SIZE_BYTES;
+
+    counting_crc_install();
+
+    fuzz_frames_t expected;
+    expected.capacity = stream_size / CFF_MIN_FRAME_SIZE_BYTES + 1;
+    expected.frames = malloc(expected.capacity * sizeof(fuzz_frame_t));
+    if (expected.frames == NULL) {
+        return -1;
+    }
+
+    bool passed = true;
+    size_t reference_hashed;
+    fuzz_run_t run;
+
+    // Through a ring buffer, frames that can't fit in it are skipped
+    size_t remaining = stream_size - reference_parse(stream, stream_size, ring_size, &expected, &reference_hashed);
+    if (result != NULL) {
+        result->stream_size_bytes = stream_size;
+        result->frames = expected.count;
+        result->reference_bytes_hashed = reference_hashed;
+    }
+
+    // cff_parse_frames() and cff_parse_frame() keep no state between calls and validate a frame left incomplete
+    // again from scratch, so only the resumable parser is held to the bound
+    init_run(&run, "cff_parse_frames", stream, stream_size, &expected);
+    passed &= check_ring_buffer(&run, fuzz_mode_parse_frames, ring_size, start_position, chunk_size, remaining);
+
+    init_run(&run, "cff_parse_frame", stream, stream_size, &expected);
+    passed &= check_ring_buffer(&run, fuzz_mode_parse_frame, ring_size, start_position, chunk_size, remaining);
+
+    bytes_hashed = 0;
+    init_run(&run, "cff_parser_parse_frames_ex", stream, stream_size, &expected);
+    passed &= check_ring_buffer(&run, fuzz_mode_parser, ring_size, start_position, chunk_size, remaining);
+    passed &= check_work(run.name, bytes_hashed, reference_hashed, result);
+
+    // In place, frames of any size are accepted
+    size_t max_frame_size = cff_calculate_frame_size_bytes(CFF_MAX_PAYLOAD_SIZE_BYTES);
+    remaining = stream_size - reference_parse(stream, stream_size, max_frame_size, &expected, &reference_hashed);
+    bytes_hashed = 0;
+    init_run(&run, "cff_parse_buffer", stream, stream_size, &expected);
+    passed &= check_buffer(&run, remaining);
+    passed &= check_work(run.name, bytes_hashed, reference_hashed, result);
+
+    cff_crc_set_provider(NULL);
+    free(expected.frames);
+    return passed ? 0 : -1;
+}
+
+// libFuzzer entry point. Crashing on a failed check is how libFuzzer records the input.
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (cff_fuzz_check(data, size, NULL) != 0) {
+        abort();
+    }
+    return 0;
+}
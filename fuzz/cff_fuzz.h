@@ -0,0 +1,42 @@
+#ifndef CFF_FUZZ_H
+#define CFF_FUZZ_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! @brief Number of bytes at the start of a fuzz input that configure the run rather than form the stream
+#define CFF_FUZZ_CONFIG_SIZE_BYTES 3
+
+//! @brief Work done by the library while checking one input
+typedef struct cff_fuzz_result_t {
+    size_t stream_size_bytes;      //!< Bytes of stream data in the input
+    size_t frames;                 //!< Frames the reference parser found
+    size_t bytes_hashed;           //!< Most bytes fed to the CRC by any one of the parsers checked with the bound
+    size_t reference_bytes_hashed; //!< Bytes the reference parser had to feed to the CRC
+} cff_fuzz_result_t;
+
+//! @brief Parse one input with every parser entry point and compare them against a reference parser
+//!
+//! The first CFF_FUZZ_CONFIG_SIZE_BYTES bytes select the ring buffer size, where in the storage the stream starts and
+//! the chunk size it is appended in, the rest is the stream. Every frame delivered must be one the reference finds,
+//! at the same offset and with the same payload, and the bytes left unparsed must match. The resumable parser and
+//! cff_parse_buffer() must not feed more bytes to the CRC than the reference, which hashes each candidate header once
+//! and each candidate payload once, so rehashing data is caught as well as wrong results.
+//!
+//! Failures are printed to stderr.
+//!
+//! @param data Fuzz input
+//! @param size Size of the fuzz input in bytes
+//! @param result Receives the work done, may be NULL
+//! @return 0 if every check passed, -1 otherwise
+int cff_fuzz_check(const uint8_t *data, size_t size, cff_fuzz_result_t *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CFF_FUZZ_H
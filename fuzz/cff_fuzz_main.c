@@ -0,0 +1,241 @@
+#include "cff.h"
+#include "cff_fuzz.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Standalone driver for the fuzz harness, for compilers without libFuzzer. It replays input files (a libFuzzer
+// corpus or crash), reads one input from stdin for AFL, generates random inputs, or measures hostile streams.
+
+// Largest input read from a file or stdin
+#define MAX_INPUT_SIZE_BYTES (1024 * 1024)
+
+// Size of the hostile streams measured by --adversarial, enough for many candidates claiming the largest payload
+#define ADVERSARIAL_STREAM_SIZE_BYTES (96 * 1024)
+
+static uint32_t random_state = 1;
+
+static uint32_t next_random(void)
+{
+    random_state = random_state * 1103515245 + 12345;
+    return random_state >> 8;
+}
+
+static int run_file(FILE *file, const char *name)
+{
+    static uint8_t input[MAX_INPUT_SIZE_BYTES];
+    size_t size = fread(input, 1, sizeof(input), file);
+    if (cff_fuzz_check(input, size, NULL) != 0) {
+        fprintf(stderr, "%s: failed\n", name);
+        return 1;
+    }
+    return 0;
+}
+
+// Append a frame, valid or with one of its bytes flipped, to an input being generated
+static size_t append_frame(uint8_t *input, size_t size, size_t capacity, size_t payload_size_bytes, int corrupt)
+{
+    uint8_t payload[512];
+    size_t frame_size_bytes = cff_calculate_frame_size_bytes(payload_size_bytes);
+    cff_frame_builder_t builder;
+
+    if (size + frame_size_bytes > capacity) {
+        return size;
+    }
+    for (size_t i = 0; i < payload_size_bytes; i++) {
+        payload[i] = (uint8_t) next_random();
+    }
+    cff_frame_builder_init(&builder, &input[size], capacity - size);
+    builder.frame_counter = (uint16_t) next_random();
+    cff_build_frame(&builder, payload, payload_size_bytes);
+    if (corrupt) {
+        input[size + next_random() % frame_size_bytes] ^= (uint8_t) (1u << (next_random() % 8));
+    }
+    return size + frame_size_bytes;
+}
+
+// Generate an input mixing frames, corrupted frames, line noise and runs of preamble bytes
+static size_t generate_input(uint8_t *input, size_t capacity)
+{
+    size_t size = 0;
+    input[size++] = (uint8_t) next_random();
+    input[size++] = (uint8_t) next_random();
+    input[size++] = (uint8_t) (next_random() % 4 == 0 ? 0 : next_random());
+
+    size_t target = CFF_FUZZ_CONFIG_SIZE_BYTES + next_random() % (capacity - CFF_FUZZ_CONFIG_SIZE_BYTES);
+    while (size < target) {
+        switch (next_random() % 7) {
+        case 0:
+        case 1:
+            size = append_frame(input, size, target, next_random() % 512, 0);
+            break;
+        case 2:
+            size = append_frame(input, size, target, next_random() % 512, 1);
+            break;
+        case 3:
+            for (uint32_t n = next_random() % 32; n > 0 && size < target; n--) {
+                input[size++] = (uint8_t) next_random();
+            }
+            break;
+        case 4:
+            for (uint32_t n = next_random() % 16; n > 0 && size < target; n--) {
+                input[size++] = next_random() % 2 ? CFF_PREAMBLE_BYTE_0 : CFF_PREAMBLE_BYTE_1;
+            }
+            break;
+        case 5:
+            // A frame inside the payload of a corrupted one, as after a dropped byte, which resync has to find
+            if (target - size > 2 * CFF_MIN_FRAME_SIZE_BYTES) {
+                uint8_t inner[CFF_MIN_FRAME_SIZE_BYTES + 64];
+                size_t inner_size = append_frame(inner, 0, sizeof(inner), next_random() % 64, 0);
+                size_t end = append_frame(input, size, target, inner_size, 1);
+                if (end > size) {
+                    memcpy(&input[size + CFF_HEADER_SIZE_BYTES], inner, inner_size);
+                }
+                size = end;
+            }
+            else {
+                size = target;
+            }
+            break;
+        default:
+            // A frame cut short
+            if (target - size > CFF_HEADER_SIZE_BYTES) {
+                size_t end = append_frame(input, size, target, next_random() % 512, 0);
+                size = end > size ? size + (next_random() % (end - size)) : size;
+            }
+            else {
+                size = target;
+            }
+            break;
+        }
+    }
+    return size;
+}
+
+static int run_random(long count)
+{
+    static uint8_t input[8192];
+    int failures = 0;
+
+    for (long i = 0; i < count; i++) {
+        size_t size = generate_input(input, sizeof(input));
+        if (cff_fuzz_check(input, size, NULL) != 0) {
+            fprintf(stderr, "random input %ld failed\n", i);
+            failures++;
+        }
+    }
+    printf("%ld random inputs, %d failed\n", count, failures);
+    return failures > 0;
+}
+
+// Hostile streams -----------------------------------------------------------------------------------------------------
+
+typedef enum adversarial_en_t {
+    adversarial_all_preamble_byte = 0, // Every byte is the first preamble byte
+    adversarial_bad_header_crc,        // Preamble after preamble, every header CRC wrong
+    adversarial_largest_payload,       // Valid headers claiming 65535 byte payloads, back to back
+} adversarial_en_t;
+
+static size_t build_adversarial(adversarial_en_t pattern, uint8_t *input, size_t capacity)
+{
+    // The largest ring buffer, so that no frame is rejected as too large for it
+    input[0] = 3;
+    input[1] = 0;
+    input[2] = 0;
+
+    uint8_t *stream = &input[CFF_FUZZ_CONFIG_SIZE_BYTES];
+    size_t stream_size = capacity - CFF_FUZZ_CONFIG_SIZE_BYTES;
+    stream_size -= stream_size % CFF_HEADER_SIZE_BYTES;
+
+    if (pattern == adversarial_all_preamble_byte) {
+        memset(stream, CFF_PREAMBLE_BYTE_0, stream_size);
+    }
+    else {
+        // One header repeated, each copy is a candidate whose payload is the copies that follow
+        uint16_t payload_size_bytes = pattern == adversarial_largest_payload ? CFF_MAX_PAYLOAD_SIZE_BYTES : 0;
+        uint8_t header[CFF_HEADER_SIZE_BYTES] = {CFF_PREAMBLE_BYTE_0, CFF_PREAMBLE_BYTE_1, 0, 0,
+                                                 (uint8_t) payload_size_bytes, (uint8_t) (payload_size_bytes >> 8)};
+        uint16_t header_crc;
+        cff_crc16(header, 6, &header_crc);
+        if (pattern == adversarial_bad_header_crc) {
+            header_crc ^= 0x0001;
+        }
+        header[6] = (uint8_t) header_crc;
+        header[7] = (uint8_t) (header_crc >> 8);
+        for (size_t i = 0; i < stream_size; i += CFF_HEADER_SIZE_BYTES) {
+            memcpy(&stream[i], header, CFF_HEADER_SIZE_BYTES);
+        }
+    }
+    return CFF_FUZZ_CONFIG_SIZE_BYTES + stream_size;
+}
+
+static void frame_sink(const cff_frame_t *frame)
+{
+    (void) frame;
+}
+
+// Check the hostile streams against the reference and report how much hashing each input byte costs and how fast
+// cff_parse_frames() gets through them
+static int run_adversarial(void)
+{
+    static const char *const names[] = {"all 0xFA", "bad header CRCs", "65535 byte payload claims"};
+    static uint8_t input[ADVERSARIAL_STREAM_SIZE_BYTES];
+    static uint8_t storage[CFF_MAX_PAYLOAD_SIZE_BYTES + CFF_MIN_FRAME_SIZE_BYTES + 7];
+    int failures = 0;
+
+    for (int pattern = 0; pattern <= adversarial_largest_payload; pattern++) {
+        size_t size = build_adversarial((adversarial_en_t) pattern, input, sizeof(input));
+        cff_fuzz_result_t result;
+        if (cff_fuzz_check(input, size, &result) != 0) {
+            failures++;
+        }
+
+        // Time the default CRC backend, streaming through a ring buffer the size of the largest frame
+        cff_ring_buffer_t ring_buffer;
+        cff_parser_t parser;
+        cff_ring_buffer_init(&ring_buffer, storage, sizeof(storage));
+        cff_parser_init(&parser, &ring_buffer);
+        const uint8_t *stream = &input[CFF_FUZZ_CONFIG_SIZE_BYTES];
+        double start = (double) clock() / CLOCKS_PER_SEC;
+        for (size_t offset = 0; offset < result.stream_size_bytes;) {
+            uint32_t chunk = (uint32_t) CFF_MIN((size_t) cff_ring_buffer_free_space(&ring_buffer),
+                                                result.stream_size_bytes - offset);
+            cff_ring_buffer_append(&ring_buffer, &stream[offset], chunk);
+            cff_parser_parse_frames(&parser, frame_sink);
+            offset += chunk;
+        }
+        double elapsed = (double) clock() / CLOCKS_PER_SEC - start;
+
+        printf("%-28s %10.1f bytes hashed per input byte %10.1f MB/s\n", names[pattern],
+               (double) result.bytes_hashed / (double) result.stream_size_bytes,
+               (double) result.stream_size_bytes / (elapsed > 0 ? elapsed : 1e-9) / 1e6);
+    }
+    return failures > 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 1) {
+        return run_file(stdin, "stdin");
+    }
+    if (strcmp(argv[1], "--random") == 0) {
+        return run_random(argc > 2 ? atol(argv[2]) : 10000);
+    }
+    if (strcmp(argv[1], "--adversarial") == 0) {
+        return run_adversarial();
+    }
+
+    int failures = 0;
+    for (int i = 1; i < argc; i++) {
+        FILE *file = fopen(argv[i], "rb");
+        if (file == NULL) {
+            fprintf(stderr, "can't open %s\n", argv[i]);
+            failures++;
+            continue;
+        }
+        failures += run_file(file, argv[i]);
+        fclose(file);
+    }
+    return failures > 0;
+}
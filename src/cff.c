@@ -24,6 +24,84 @@
 #include <stdbool.h>
 #include <string.h>
 
+#if CFF_CRC_BACKEND >= CFF_CRC_BACKEND_CLMUL && defined(__GNUC__) && defined(__x86_64__)
+#define CFF_CRC_CLMUL_X86 1
+#include <immintrin.h>
+#elif CFF_CRC_BACKEND >= CFF_CRC_BACKEND_CLMUL && defined(__aarch64__) && defined(__ARM_FEATURE_CRYPTO)
+#define CFF_CRC_CLMUL_ARM 1
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#define CFF_PREAMBLE_SCAN_SSE2 1
+#include <emmintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__) && defined(__ARM_NEON)
+#define CFF_PREAMBLE_SCAN_NEON 1
+#include <arm_neon.h>
+#endif
+
+// The producer (cff_ring_buffer_append()) and the consumer (everything that reads or discards data) each write only
+// their own ring buffer index. Publishing it with release semantics, after the data accesses it covers, and reading the
+// other side's index with acquire semantics, before touching the data it covers, makes a ring buffer safe to share
+// between one producer and one consumer without locks. See cff_ring_buffer_t for overriding these.
+#if !defined(CFF_RING_BUFFER_LOAD_ACQUIRE) || !defined(CFF_RING_BUFFER_STORE_RELEASE)
+#if defined(__GNUC__) || defined(__clang__)
+#define CFF_RING_BUFFER_LOAD_ACQUIRE(index) __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+#define CFF_RING_BUFFER_STORE_RELEASE(index, value) __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+#define CFF_RING_BUFFER_LOAD_ACQUIRE(index) cff_ring_buffer_load_acquire(&(index))
+#define CFF_RING_BUFFER_STORE_RELEASE(index, value) cff_ring_buffer_store_release(&(index), (value))
+static inline uint32_t cff_ring_buffer_load_acquire(const uint32_t *index)
+{
+    uint32_t value = *(const volatile uint32_t *) index;
+    atomic_thread_fence(memory_order_acquire);
+    return value;
+}
+static inline void cff_ring_buffer_store_release(uint32_t *index, uint32_t value)
+{
+    atomic_thread_fence(memory_order_release);
+    *(volatile uint32_t *) index = value;
+}
+#else
+// Volatile accesses keep the compiler from caching or reordering the indices, which is enough on a single core MCU
+#define CFF_RING_BUFFER_LOAD_ACQUIRE(index) (*(const volatile uint32_t *) &(index))
+#define CFF_RING_BUFFER_STORE_RELEASE(index, value) (*(volatile uint32_t *) &(index) = (value))
+#endif
+#endif
+
+// Counters are only updated when built with CFF_ENABLE_STATS and a cff_stats_t is attached to the ring buffer or
+// builder, otherwise the updates compile to nothing
+#ifdef CFF_ENABLE_STATS
+#define CFF_STATS_ADD(object, counter, value)                                                                          \
+    do {                                                                                                               \
+        if ((object)->stats != NULL) {                                                                                 \
+            (object)->stats->counter += (value);                                                                       \
+        }                                                                                                              \
+    } while (0)
+#define CFF_STATS_MAX(object, counter, value)                                                                          \
+    do {                                                                                                               \
+        if ((object)->stats != NULL && (object)->stats->counter < (value)) {                                           \
+            (object)->stats->counter = (value);                                                                        \
+        }                                                                                                              \
+    } while (0)
+#else
+#define CFF_STATS_ADD(object, counter, value) ((void) 0)
+#define CFF_STATS_MAX(object, counter, value) ((void) 0)
+#endif
+
+// A frame pool is single-context unless the build supplies a critical section, see cff_frame_pool_t
+#ifndef CFF_FRAME_POOL_LOCK
+#define CFF_FRAME_POOL_LOCK(pool) ((void) (pool))
+#define CFF_FRAME_POOL_UNLOCK(pool) ((void) (pool))
+#endif
+
+// Likewise for the state a transmit queue shares with its DMA completion interrupt, see cff_tx_queue_t
+#ifndef CFF_TX_QUEUE_LOCK
+#define CFF_TX_QUEUE_LOCK(queue) ((void) (queue))
+#define CFF_TX_QUEUE_UNLOCK(queue) ((void) (queue))
+#endif
+
 // Binary Primitives ---------------------------------------------------------------------------------------------------
 
 static uint16_t cff_get_uint16_le(const uint8_t *data)
@@ -37,8 +115,70 @@ static void cff_set_uint16_le(uint8_t *data, uint16_t value)
     data[1] = (uint8_t) ((value >> 8) & 0xFF);
 }
 
+// Statistics ----------------------------------------------------------------------------------------------------------
+
+cff_error_en_t cff_stats_snapshot(const cff_stats_t *stats, cff_stats_t *snapshot)
+{
+    if (stats == NULL || snapshot == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    *snapshot = *stats;
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_stats_reset(cff_stats_t *stats)
+{
+    if (stats == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+
+    return cff_error_none;
+}
+
 // Ring Buffer Implementation ------------------------------------------------------------------------------------------
 
+// A mirrored ring buffer's storage is followed by a second mapping of itself, so regions never need to be split
+static bool cff_ring_buffer_is_mirrored(const cff_ring_buffer_t *ring_buffer)
+{
+    return (ring_buffer->flags & CFF_RING_BUFFER_FLAG_MIRRORED) != 0;
+}
+
+// The append and consume indices run from 0 to 2 * buffer_size - 1, so a full ring buffer (indices buffer_size apart)
+// can be told apart from an empty one (indices equal) without a fill counter that both sides would have to update.
+// With a power-of-two size, wrapping an index is a mask. Otherwise it is a conditional subtraction, which is still
+// much cheaper than the division a modulo costs on cores without a hardware divider.
+static uint32_t cff_ring_buffer_index_add(const cff_ring_buffer_t *ring_buffer, uint32_t index, uint32_t count)
+{
+    if (ring_buffer->index_mask != 0) {
+        return (index + count) & ring_buffer->index_mask;
+    }
+
+    // buffer_size is below 2^31 when it isn't a power of two, so the range fits and the sum is computed without
+    // overflowing
+    uint32_t index_range = 2 * ring_buffer->buffer_size;
+    return index >= index_range - count ? index - (index_range - count) : index + count;
+}
+
+// Position within the storage of the element an index refers to
+static uint32_t cff_ring_buffer_index_position(const cff_ring_buffer_t *ring_buffer, uint32_t index)
+{
+    if (ring_buffer->index_mask != 0) {
+        return index & (ring_buffer->index_mask >> 1);
+    }
+    return index >= ring_buffer->buffer_size ? index - ring_buffer->buffer_size : index;
+}
+
+// Position within the storage of the element offset elements past the consume index
+static uint32_t cff_ring_buffer_offset_position(const cff_ring_buffer_t *ring_buffer, uint32_t offset)
+{
+    return cff_ring_buffer_index_position(ring_buffer,
+                                          cff_ring_buffer_index_add(ring_buffer, ring_buffer->consume_index, offset));
+}
+
 cff_error_en_t cff_ring_buffer_init(cff_ring_buffer_t *ring_buffer, CFF_RB_T *buffer, uint32_t buffer_size)
 {
     if (ring_buffer == NULL || buffer == NULL) {
@@ -49,11 +189,20 @@ cff_error_en_t cff_ring_buffer_init(cff_ring_buffer_t *ring_buffer, CFF_RB_T *bu
         return cff_error_buffer_too_small;
     }
 
+    // Indices must be able to count to twice the size
+    if (buffer_size > CFF_RING_BUFFER_MAX_SIZE) {
+        return cff_error_not_supported;
+    }
+
     ring_buffer->buffer = buffer;
     ring_buffer->buffer_size = buffer_size;
     ring_buffer->append_index = 0;
     ring_buffer->consume_index = 0;
-    ring_buffer->free_space = buffer_size;
+    ring_buffer->index_mask = (buffer_size & (buffer_size - 1)) == 0 ? 2 * buffer_size - 1 : 0;
+    ring_buffer->flags = 0;
+#ifdef CFF_ENABLE_STATS
+    ring_buffer->stats = NULL;
+#endif
 
     // Initialize buffer to zero
     memset(buffer, 0, buffer_size * sizeof(CFF_RB_T));
@@ -61,30 +210,113 @@ cff_error_en_t cff_ring_buffer_init(cff_ring_buffer_t *ring_buffer, CFF_RB_T *bu
     return cff_error_none;
 }
 
+cff_error_en_t cff_ring_buffer_set_stats(cff_ring_buffer_t *ring_buffer, cff_stats_t *stats)
+{
+    if (ring_buffer == NULL) {
+        return cff_error_null_pointer;
+    }
+
+#ifdef CFF_ENABLE_STATS
+    ring_buffer->stats = stats;
+    return cff_error_none;
+#else
+    (void) stats;
+    return cff_error_not_supported;
+#endif
+}
+
+uint32_t cff_ring_buffer_available_data(const cff_ring_buffer_t *ring_buffer)
+{
+    if (ring_buffer == NULL) {
+        return 0;
+    }
+
+    // Either side may be asking, so both indices are read as the other side's
+    uint32_t append_index = CFF_RING_BUFFER_LOAD_ACQUIRE(ring_buffer->append_index);
+    uint32_t consume_index = CFF_RING_BUFFER_LOAD_ACQUIRE(ring_buffer->consume_index);
+    if (ring_buffer->index_mask != 0) {
+        return (append_index - consume_index) & ring_buffer->index_mask;
+    }
+    return append_index >= consume_index ? append_index - consume_index
+                                         : append_index + 2 * ring_buffer->buffer_size - consume_index;
+}
+
+uint32_t cff_ring_buffer_free_space(const cff_ring_buffer_t *ring_buffer)
+{
+    if (ring_buffer == NULL) {
+        return 0;
+    }
+    return ring_buffer->buffer_size - cff_ring_buffer_available_data(ring_buffer);
+}
+
 cff_error_en_t cff_ring_buffer_append(cff_ring_buffer_t *ring_buffer, const CFF_RB_T *items, uint32_t number_of_items)
 {
     if (ring_buffer == NULL || items == NULL) {
         return cff_error_null_pointer;
     }
 
-    if (number_of_items > ring_buffer->free_space) {
+    uint32_t free_space = cff_ring_buffer_free_space(ring_buffer);
+    if (number_of_items > free_space) {
+        CFF_STATS_ADD(ring_buffer, append_overflows, 1);
         return cff_error_insufficient_space;
     }
 
-    if (ring_buffer->append_index + number_of_items > ring_buffer->buffer_size) {
+    uint32_t position = cff_ring_buffer_index_position(ring_buffer, ring_buffer->append_index);
+
+    if (position + number_of_items > ring_buffer->buffer_size && !cff_ring_buffer_is_mirrored(ring_buffer)) {
         // Wrap-around
-        uint32_t amount_to_copy = CFF_MIN(number_of_items, ring_buffer->buffer_size - ring_buffer->append_index);
-        memcpy(ring_buffer->buffer + ring_buffer->append_index, items, amount_to_copy * sizeof(CFF_RB_T));
-        ring_buffer->append_index = (ring_buffer->append_index + amount_to_copy) % ring_buffer->buffer_size;
-        ring_buffer->free_space -= amount_to_copy;
-        number_of_items -= amount_to_copy;
-        items += amount_to_copy;
+        uint32_t amount_to_copy = ring_buffer->buffer_size - position;
+        memcpy(ring_buffer->buffer + position, items, amount_to_copy * sizeof(CFF_RB_T));
+        memcpy(ring_buffer->buffer, items + amount_to_copy, (number_of_items - amount_to_copy) * sizeof(CFF_RB_T));
+    }
+    else {
+        memcpy(ring_buffer->buffer + position, items, number_of_items * sizeof(CFF_RB_T));
     }
 
-    // Now append_index is before consume_index, so we can copy up to it
-    memcpy(ring_buffer->buffer + ring_buffer->append_index, items, number_of_items * sizeof(CFF_RB_T));
-    ring_buffer->append_index = (ring_buffer->append_index + number_of_items) % ring_buffer->buffer_size;
-    ring_buffer->free_space -= number_of_items;
+    // Publish the data to the consumer
+    uint32_t append_index = cff_ring_buffer_index_add(ring_buffer, ring_buffer->append_index, number_of_items);
+    CFF_RING_BUFFER_STORE_RELEASE(ring_buffer->append_index, append_index);
+
+    CFF_STATS_ADD(ring_buffer, bytes_appended, number_of_items);
+    CFF_STATS_MAX(ring_buffer, ring_high_water_mark, ring_buffer->buffer_size - free_space + number_of_items);
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_ring_buffer_reserve(cff_ring_buffer_t *ring_buffer, CFF_RB_T **region, uint32_t *region_size)
+{
+    if (ring_buffer == NULL || region == NULL || region_size == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    uint32_t free_space = cff_ring_buffer_free_space(ring_buffer);
+    uint32_t position = cff_ring_buffer_index_position(ring_buffer, ring_buffer->append_index);
+
+    *region = ring_buffer->buffer + position;
+    *region_size = cff_ring_buffer_is_mirrored(ring_buffer) ? free_space
+                                                            : CFF_MIN(free_space, ring_buffer->buffer_size - position);
+
+    return free_space == 0 ? cff_error_insufficient_space : cff_error_none;
+}
+
+cff_error_en_t cff_ring_buffer_commit(cff_ring_buffer_t *ring_buffer, uint32_t number_of_items)
+{
+    if (ring_buffer == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    uint32_t free_space = cff_ring_buffer_free_space(ring_buffer);
+    if (number_of_items > free_space) {
+        CFF_STATS_ADD(ring_buffer, append_overflows, 1);
+        return cff_error_insufficient_space;
+    }
+
+    // Publish the data to the consumer
+    uint32_t append_index = cff_ring_buffer_index_add(ring_buffer, ring_buffer->append_index, number_of_items);
+    CFF_RING_BUFFER_STORE_RELEASE(ring_buffer->append_index, append_index);
+
+    CFF_STATS_ADD(ring_buffer, bytes_appended, number_of_items);
+    CFF_STATS_MAX(ring_buffer, ring_high_water_mark, ring_buffer->buffer_size - free_space + number_of_items);
 
     return cff_error_none;
 }
@@ -95,24 +327,26 @@ cff_error_en_t cff_ring_buffer_consume(cff_ring_buffer_t *ring_buffer, CFF_RB_T
         return cff_error_null_pointer;
     }
 
-    if (number_of_items > (ring_buffer->buffer_size - ring_buffer->free_space)) {
+    if (number_of_items > cff_ring_buffer_available_data(ring_buffer)) {
         return cff_error_insufficient_space;
     }
 
-    if (ring_buffer->consume_index + number_of_items > ring_buffer->buffer_size) {
+    uint32_t position = cff_ring_buffer_index_position(ring_buffer, ring_buffer->consume_index);
+
+    if (position + number_of_items > ring_buffer->buffer_size && !cff_ring_buffer_is_mirrored(ring_buffer)) {
         // Wrap-around
-        uint32_t amount_to_consume = CFF_MIN(number_of_items, ring_buffer->buffer_size - ring_buffer->consume_index);
-        memcpy(items, ring_buffer->buffer + ring_buffer->consume_index, amount_to_consume * sizeof(CFF_RB_T));
-        ring_buffer->consume_index = (ring_buffer->consume_index + amount_to_consume) % ring_buffer->buffer_size;
-        ring_buffer->free_space += amount_to_consume;
-        number_of_items -= amount_to_consume;
-        items += amount_to_consume;
+        uint32_t amount_to_consume = ring_buffer->buffer_size - position;
+        memcpy(items, ring_buffer->buffer + position, amount_to_consume * sizeof(CFF_RB_T));
+        memcpy(items + amount_to_consume, ring_buffer->buffer,
+               (number_of_items - amount_to_consume) * sizeof(CFF_RB_T));
+    }
+    else {
+        memcpy(items, ring_buffer->buffer + position, number_of_items * sizeof(CFF_RB_T));
     }
 
-    // Now consume_index is before append_index, so we can consume up to it
-    memcpy(items, ring_buffer->buffer + ring_buffer->consume_index, number_of_items * sizeof(CFF_RB_T));
-    ring_buffer->consume_index = (ring_buffer->consume_index + number_of_items) % ring_buffer->buffer_size;
-    ring_buffer->free_space += number_of_items;
+    // Hand the space back to the producer
+    uint32_t consume_index = cff_ring_buffer_index_add(ring_buffer, ring_buffer->consume_index, number_of_items);
+    CFF_RING_BUFFER_STORE_RELEASE(ring_buffer->consume_index, consume_index);
 
     return cff_error_none;
 }
@@ -123,23 +357,19 @@ cff_error_en_t cff_ring_buffer_advance(cff_ring_buffer_t *ring_buffer, uint32_t
         return cff_error_null_pointer;
     }
 
-    if (number_of_items > (ring_buffer->buffer_size - ring_buffer->free_space)) {
+    if (number_of_items > cff_ring_buffer_available_data(ring_buffer)) {
         return cff_error_insufficient_space;
     }
 
-    ring_buffer->consume_index = (ring_buffer->consume_index + number_of_items) % ring_buffer->buffer_size;
-    ring_buffer->free_space += number_of_items;
+    // Hand the space back to the producer
+    uint32_t consume_index = cff_ring_buffer_index_add(ring_buffer, ring_buffer->consume_index, number_of_items);
+    CFF_RING_BUFFER_STORE_RELEASE(ring_buffer->consume_index, consume_index);
 
     return cff_error_none;
 }
 
 // Ring Buffer Helper Functions ----------------------------------------------------------------------------------------
 
-static uint32_t cff_ring_buffer_available_data(const cff_ring_buffer_t *ring_buffer)
-{
-    return ring_buffer->buffer_size - ring_buffer->free_space;
-}
-
 static cff_error_en_t cff_ring_buffer_peek(const cff_ring_buffer_t *ring_buffer, CFF_RB_T *items, uint32_t offset,
                                            uint32_t number_of_items)
 {
@@ -152,9 +382,9 @@ static cff_error_en_t cff_ring_buffer_peek(const cff_ring_buffer_t *ring_buffer,
         return cff_error_insufficient_space;
     }
 
-    uint32_t peek_index = (ring_buffer->consume_index + offset) % ring_buffer->buffer_size;
+    uint32_t peek_index = cff_ring_buffer_offset_position(ring_buffer, offset);
 
-    if (peek_index + number_of_items > ring_buffer->buffer_size) {
+    if (peek_index + number_of_items > ring_buffer->buffer_size && !cff_ring_buffer_is_mirrored(ring_buffer)) {
         // Wrap-around
         uint32_t amount_to_peek = ring_buffer->buffer_size - peek_index;
         memcpy(items, ring_buffer->buffer + peek_index, amount_to_peek * sizeof(CFF_RB_T));
@@ -167,6 +397,58 @@ static cff_error_en_t cff_ring_buffer_peek(const cff_ring_buffer_t *ring_buffer,
     return cff_error_none;
 }
 
+// Returns the offset of the first preamble that lies entirely within the contiguous region, or size if there is none.
+// Where SIMD is available, both preamble bytes are compared 16 positions at a time, so the scan speed doesn't depend on
+// the data. Elsewhere memchr does the heavy lifting: it is vectorized by every mainstream C library, so garbage that
+// contains few 0xFA bytes is skipped many bytes at a time instead of one comparison per byte.
+static uint32_t cff_find_preamble_linear(const CFF_RB_T *data, uint32_t size)
+{
+    if (size < CFF_PREAMBLE_SIZE_BYTES) {
+        return size;
+    }
+
+    const uint8_t *start = (const uint8_t *) data;
+    const uint8_t *cursor = start;
+    const uint8_t *last = start + size - 1; // The second preamble byte must also lie within the region
+
+#if defined(CFF_PREAMBLE_SCAN_SSE2)
+    const __m128i first_byte = _mm_set1_epi8((char) CFF_PREAMBLE_BYTE_0);
+    const __m128i second_byte = _mm_set1_epi8((char) CFF_PREAMBLE_BYTE_1);
+    while (last - cursor >= 16) {
+        __m128i first = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) cursor), first_byte);
+        __m128i second = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (cursor + 1)), second_byte);
+        int matches = _mm_movemask_epi8(_mm_and_si128(first, second));
+        if (matches != 0) {
+            return (uint32_t) (cursor - start) + (uint32_t) __builtin_ctz((unsigned) matches);
+        }
+        cursor += 16;
+    }
+#elif defined(CFF_PREAMBLE_SCAN_NEON)
+    const uint8x16_t first_byte = vdupq_n_u8(CFF_PREAMBLE_BYTE_0);
+    const uint8x16_t second_byte = vdupq_n_u8(CFF_PREAMBLE_BYTE_1);
+    while (last - cursor >= 16) {
+        uint8x16_t first = vceqq_u8(vld1q_u8(cursor), first_byte);
+        uint8x16_t second = vceqq_u8(vld1q_u8(cursor + 1), second_byte);
+        if (vmaxvq_u8(vandq_u8(first, second)) != 0) {
+            break; // The scalar loop below pinpoints the match within these 16 positions
+        }
+        cursor += 16;
+    }
+#endif
+
+    while (cursor < last) {
+        const uint8_t *candidate = (const uint8_t *) memchr(cursor, CFF_PREAMBLE_BYTE_0, (size_t) (last - cursor));
+        if (candidate == NULL) {
+            break;
+        }
+        if (candidate[1] == CFF_PREAMBLE_BYTE_1) {
+            return (uint32_t) (candidate - start);
+        }
+        cursor = candidate + 1;
+    }
+    return size;
+}
+
 static size_t cff_ring_buffer_find_preamble(const cff_ring_buffer_t *ring_buffer, uint32_t start_offset)
 {
     uint32_t available = cff_ring_buffer_available_data(ring_buffer);
@@ -175,41 +457,653 @@ static size_t cff_ring_buffer_find_preamble(const cff_ring_buffer_t *ring_buffer
         return available;
     }
 
-    for (uint32_t i = start_offset; i <= available - CFF_PREAMBLE_SIZE_BYTES; i++) {
-        CFF_RB_T preamble_bytes[CFF_PREAMBLE_SIZE_BYTES];
-        if (cff_ring_buffer_peek(ring_buffer, preamble_bytes, i, CFF_PREAMBLE_SIZE_BYTES) == cff_error_none) {
-            if (preamble_bytes[0] == CFF_PREAMBLE_BYTE_0 && preamble_bytes[1] == CFF_PREAMBLE_BYTE_1) {
-                return i;
-            }
-        }
+    // The searched region is at most two contiguous segments: up to the end of the storage, then from its start
+    uint32_t start = cff_ring_buffer_offset_position(ring_buffer, start_offset);
+    uint32_t region_size = available - start_offset;
+    if (cff_ring_buffer_is_mirrored(ring_buffer)) {
+        return start_offset + cff_find_preamble_linear(ring_buffer->buffer + start, region_size);
+    }
+    uint32_t first_segment_size = CFF_MIN(region_size, ring_buffer->buffer_size - start);
+    uint32_t second_segment_size = region_size - first_segment_size;
+
+    uint32_t found = cff_find_preamble_linear(ring_buffer->buffer + start, first_segment_size);
+    if (found < first_segment_size) {
+        return start_offset + found;
+    }
+
+    if (second_segment_size == 0) {
+        return available; // Not found
+    }
+
+    // The preamble may straddle the end of the storage
+    if (ring_buffer->buffer[ring_buffer->buffer_size - 1] == CFF_PREAMBLE_BYTE_0 &&
+        ring_buffer->buffer[0] == CFF_PREAMBLE_BYTE_1) {
+        return start_offset + first_segment_size - 1;
+    }
+
+    found = cff_find_preamble_linear(ring_buffer->buffer, second_segment_size);
+    if (found < second_segment_size) {
+        return start_offset + first_segment_size + found;
     }
     return available; // Not found
 }
 
 // CRC Calulation ------------------------------------------------------------------------------------------------------
 
-static uint16_t cff_crc_table[256] = {0};
-static bool cff_crc_table_initialized = 0;
+#if CFF_CRC_BACKEND >= CFF_CRC_BACKEND_SLICING_BY_8
+#define CFF_CRC_TABLE_SLICES 8
+#elif CFF_CRC_BACKEND >= CFF_CRC_BACKEND_SLICING_BY_4
+#define CFF_CRC_TABLE_SLICES 4
+#else
+#define CFF_CRC_TABLE_SLICES 1
+#endif
+
+// cff_crc_table[0] is the classic byte-wise table: entry i is the CRC of the byte i (shifted into the top of a zero
+// register). cff_crc_table[k] holds the CRC of a byte followed by k zero bytes, i.e.
+// cff_crc_table[k][i] = (cff_crc_table[k - 1][i] << 8) ^ cff_crc_table[0][cff_crc_table[k - 1][i] >> 8], which lets the
+// slicing backends fold several input bytes into the CRC with one lookup each. The tables are const so they live in
+// flash on MCUs and need no initialization, which also keeps the CRC functions free of shared mutable state.
+static const uint16_t cff_crc_table[CFF_CRC_TABLE_SLICES][256] = {
+    {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+        0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+        0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+        0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+        0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+        0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+        0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+        0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+        0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+        0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+        0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+        0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+        0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+        0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+        0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+        0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+        0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+        0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+        0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+        0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+        0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+        0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+        0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+        0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+        0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+        0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+        0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+        0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+        0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+        0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+        0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+    },
+#if CFF_CRC_TABLE_SLICES >= 4
+    {
+        0x0000, 0x3331, 0x6662, 0x5553, 0xCCC4, 0xFFF5, 0xAAA6, 0x9997,
+        0x89A9, 0xBA98, 0xEFCB, 0xDCFA, 0x456D, 0x765C, 0x230F, 0x103E,
+        0x0373, 0x3042, 0x6511, 0x5620, 0xCFB7, 0xFC86, 0xA9D5, 0x9AE4,
+        0x8ADA, 0xB9EB, 0xECB8, 0xDF89, 0x461E, 0x752F, 0x207C, 0x134D,
+        0x06E6, 0x35D7, 0x6084, 0x53B5, 0xCA22, 0xF913, 0xAC40, 0x9F71,
+        0x8F4F, 0xBC7E, 0xE92D, 0xDA1C, 0x438B, 0x70BA, 0x25E9, 0x16D8,
+        0x0595, 0x36A4, 0x63F7, 0x50C6, 0xC951, 0xFA60, 0xAF33, 0x9C02,
+        0x8C3C, 0xBF0D, 0xEA5E, 0xD96F, 0x40F8, 0x73C9, 0x269A, 0x15AB,
+        0x0DCC, 0x3EFD, 0x6BAE, 0x589F, 0xC108, 0xF239, 0xA76A, 0x945B,
+        0x8465, 0xB754, 0xE207, 0xD136, 0x48A1, 0x7B90, 0x2EC3, 0x1DF2,
+        0x0EBF, 0x3D8E, 0x68DD, 0x5BEC, 0xC27B, 0xF14A, 0xA419, 0x9728,
+        0x8716, 0xB427, 0xE174, 0xD245, 0x4BD2, 0x78E3, 0x2DB0, 0x1E81,
+        0x0B2A, 0x381B, 0x6D48, 0x5E79, 0xC7EE, 0xF4DF, 0xA18C, 0x92BD,
+        0x8283, 0xB1B2, 0xE4E1, 0xD7D0, 0x4E47, 0x7D76, 0x2825, 0x1B14,
+        0x0859, 0x3B68, 0x6E3B, 0x5D0A, 0xC49D, 0xF7AC, 0xA2FF, 0x91CE,
+        0x81F0, 0xB2C1, 0xE792, 0xD4A3, 0x4D34, 0x7E05, 0x2B56, 0x1867,
+        0x1B98, 0x28A9, 0x7DFA, 0x4ECB, 0xD75C, 0xE46D, 0xB13E, 0x820F,
+        0x9231, 0xA100, 0xF453, 0xC762, 0x5EF5, 0x6DC4, 0x3897, 0x0BA6,
+        0x18EB, 0x2BDA, 0x7E89, 0x4DB8, 0xD42F, 0xE71E, 0xB24D, 0x817C,
+        0x9142, 0xA273, 0xF720, 0xC411, 0x5D86, 0x6EB7, 0x3BE4, 0x08D5,
+        0x1D7E, 0x2E4F, 0x7B1C, 0x482D, 0xD1BA, 0xE28B, 0xB7D8, 0x84E9,
+        0x94D7, 0xA7E6, 0xF2B5, 0xC184, 0x5813, 0x6B22, 0x3E71, 0x0D40,
+        0x1E0D, 0x2D3C, 0x786F, 0x4B5E, 0xD2C9, 0xE1F8, 0xB4AB, 0x879A,
+        0x97A4, 0xA495, 0xF1C6, 0xC2F7, 0x5B60, 0x6851, 0x3D02, 0x0E33,
+        0x1654, 0x2565, 0x7036, 0x4307, 0xDA90, 0xE9A1, 0xBCF2, 0x8FC3,
+        0x9FFD, 0xACCC, 0xF99F, 0xCAAE, 0x5339, 0x6008, 0x355B, 0x066A,
+        0x1527, 0x2616, 0x7345, 0x4074, 0xD9E3, 0xEAD2, 0xBF81, 0x8CB0,
+        0x9C8E, 0xAFBF, 0xFAEC, 0xC9DD, 0x504A, 0x637B, 0x3628, 0x0519,
+        0x10B2, 0x2383, 0x76D0, 0x45E1, 0xDC76, 0xEF47, 0xBA14, 0x8925,
+        0x991B, 0xAA2A, 0xFF79, 0xCC48, 0x55DF, 0x66EE, 0x33BD, 0x008C,
+        0x13C1, 0x20F0, 0x75A3, 0x4692, 0xDF05, 0xEC34, 0xB967, 0x8A56,
+        0x9A68, 0xA959, 0xFC0A, 0xCF3B, 0x56AC, 0x659D, 0x30CE, 0x03FF,
+    },
+    {
+        0x0000, 0x3730, 0x6E60, 0x5950, 0xDCC0, 0xEBF0, 0xB2A0, 0x8590,
+        0xA9A1, 0x9E91, 0xC7C1, 0xF0F1, 0x7561, 0x4251, 0x1B01, 0x2C31,
+        0x4363, 0x7453, 0x2D03, 0x1A33, 0x9FA3, 0xA893, 0xF1C3, 0xC6F3,
+        0xEAC2, 0xDDF2, 0x84A2, 0xB392, 0x3602, 0x0132, 0x5862, 0x6F52,
+        0x86C6, 0xB1F6, 0xE8A6, 0xDF96, 0x5A06, 0x6D36, 0x3466, 0x0356,
+        0x2F67, 0x1857, 0x4107, 0x7637, 0xF3A7, 0xC497, 0x9DC7, 0xAAF7,
+        0xC5A5, 0xF295, 0xABC5, 0x9CF5, 0x1965, 0x2E55, 0x7705, 0x4035,
+        0x6C04, 0x5B34, 0x0264, 0x3554, 0xB0C4, 0x87F4, 0xDEA4, 0xE994,
+        0x1DAD, 0x2A9D, 0x73CD, 0x44FD, 0xC16D, 0xF65D, 0xAF0D, 0x983D,
+        0xB40C, 0x833C, 0xDA6C, 0xED5C, 0x68CC, 0x5FFC, 0x06AC, 0x319C,
+        0x5ECE, 0x69FE, 0x30AE, 0x079E, 0x820E, 0xB53E, 0xEC6E, 0xDB5E,
+        0xF76F, 0xC05F, 0x990F, 0xAE3F, 0x2BAF, 0x1C9F, 0x45CF, 0x72FF,
+        0x9B6B, 0xAC5B, 0xF50B, 0xC23B, 0x47AB, 0x709B, 0x29CB, 0x1EFB,
+        0x32CA, 0x05FA, 0x5CAA, 0x6B9A, 0xEE0A, 0xD93A, 0x806A, 0xB75A,
+        0xD808, 0xEF38, 0xB668, 0x8158, 0x04C8, 0x33F8, 0x6AA8, 0x5D98,
+        0x71A9, 0x4699, 0x1FC9, 0x28F9, 0xAD69, 0x9A59, 0xC309, 0xF439,
+        0x3B5A, 0x0C6A, 0x553A, 0x620A, 0xE79A, 0xD0AA, 0x89FA, 0xBECA,
+        0x92FB, 0xA5CB, 0xFC9B, 0xCBAB, 0x4E3B, 0x790B, 0x205B, 0x176B,
+        0x7839, 0x4F09, 0x1659, 0x2169, 0xA4F9, 0x93C9, 0xCA99, 0xFDA9,
+        0xD198, 0xE6A8, 0xBFF8, 0x88C8, 0x0D58, 0x3A68, 0x6338, 0x5408,
+        0xBD9C, 0x8AAC, 0xD3FC, 0xE4CC, 0x615C, 0x566C, 0x0F3C, 0x380C,
+        0x143D, 0x230D, 0x7A5D, 0x4D6D, 0xC8FD, 0xFFCD, 0xA69D, 0x91AD,
+        0xFEFF, 0xC9CF, 0x909F, 0xA7AF, 0x223F, 0x150F, 0x4C5F, 0x7B6F,
+        0x575E, 0x606E, 0x393E, 0x0E0E, 0x8B9E, 0xBCAE, 0xE5FE, 0xD2CE,
+        0x26F7, 0x11C7, 0x4897, 0x7FA7, 0xFA37, 0xCD07, 0x9457, 0xA367,
+        0x8F56, 0xB866, 0xE136, 0xD606, 0x5396, 0x64A6, 0x3DF6, 0x0AC6,
+        0x6594, 0x52A4, 0x0BF4, 0x3CC4, 0xB954, 0x8E64, 0xD734, 0xE004,
+        0xCC35, 0xFB05, 0xA255, 0x9565, 0x10F5, 0x27C5, 0x7E95, 0x49A5,
+        0xA031, 0x9701, 0xCE51, 0xF961, 0x7CF1, 0x4BC1, 0x1291, 0x25A1,
+        0x0990, 0x3EA0, 0x67F0, 0x50C0, 0xD550, 0xE260, 0xBB30, 0x8C00,
+        0xE352, 0xD462, 0x8D32, 0xBA02, 0x3F92, 0x08A2, 0x51F2, 0x66C2,
+        0x4AF3, 0x7DC3, 0x2493, 0x13A3, 0x9633, 0xA103, 0xF853, 0xCF63,
+    },
+    {
+        0x0000, 0x76B4, 0xED68, 0x9BDC, 0xCAF1, 0xBC45, 0x2799, 0x512D,
+        0x85C3, 0xF377, 0x68AB, 0x1E1F, 0x4F32, 0x3986, 0xA25A, 0xD4EE,
+        0x1BA7, 0x6D13, 0xF6CF, 0x807B, 0xD156, 0xA7E2, 0x3C3E, 0x4A8A,
+        0x9E64, 0xE8D0, 0x730C, 0x05B8, 0x5495, 0x2221, 0xB9FD, 0xCF49,
+        0x374E, 0x41FA, 0xDA26, 0xAC92, 0xFDBF, 0x8B0B, 0x10D7, 0x6663,
+        0xB28D, 0xC439, 0x5FE5, 0x2951, 0x787C, 0x0EC8, 0x9514, 0xE3A0,
+        0x2CE9, 0x5A5D, 0xC181, 0xB735, 0xE618, 0x90AC, 0x0B70, 0x7DC4,
+        0xA92A, 0xDF9E, 0x4442, 0x32F6, 0x63DB, 0x156F, 0x8EB3, 0xF807,
+        0x6E9C, 0x1828, 0x83F4, 0xF540, 0xA46D, 0xD2D9, 0x4905, 0x3FB1,
+        0xEB5F, 0x9DEB, 0x0637, 0x7083, 0x21AE, 0x571A, 0xCCC6, 0xBA72,
+        0x753B, 0x038F, 0x9853, 0xEEE7, 0xBFCA, 0xC97E, 0x52A2, 0x2416,
+        0xF0F8, 0x864C, 0x1D90, 0x6B24, 0x3A09, 0x4CBD, 0xD761, 0xA1D5,
+        0x59D2, 0x2F66, 0xB4BA, 0xC20E, 0x9323, 0xE597, 0x7E4B, 0x08FF,
+        0xDC11, 0xAAA5, 0x3179, 0x47CD, 0x16E0, 0x6054, 0xFB88, 0x8D3C,
+        0x4275, 0x34C1, 0xAF1D, 0xD9A9, 0x8884, 0xFE30, 0x65EC, 0x1358,
+        0xC7B6, 0xB102, 0x2ADE, 0x5C6A, 0x0D47, 0x7BF3, 0xE02F, 0x969B,
+        0xDD38, 0xAB8C, 0x3050, 0x46E4, 0x17C9, 0x617D, 0xFAA1, 0x8C15,
+        0x58FB, 0x2E4F, 0xB593, 0xC327, 0x920A, 0xE4BE, 0x7F62, 0x09D6,
+        0xC69F, 0xB02B, 0x2BF7, 0x5D43, 0x0C6E, 0x7ADA, 0xE106, 0x97B2,
+        0x435C, 0x35E8, 0xAE34, 0xD880, 0x89AD, 0xFF19, 0x64C5, 0x1271,
+        0xEA76, 0x9CC2, 0x071E, 0x71AA, 0x2087, 0x5633, 0xCDEF, 0xBB5B,
+        0x6FB5, 0x1901, 0x82DD, 0xF469, 0xA544, 0xD3F0, 0x482C, 0x3E98,
+        0xF1D1, 0x8765, 0x1CB9, 0x6A0D, 0x3B20, 0x4D94, 0xD648, 0xA0FC,
+        0x7412, 0x02A6, 0x997A, 0xEFCE, 0xBEE3, 0xC857, 0x538B, 0x253F,
+        0xB3A4, 0xC510, 0x5ECC, 0x2878, 0x7955, 0x0FE1, 0x943D, 0xE289,
+        0x3667, 0x40D3, 0xDB0F, 0xADBB, 0xFC96, 0x8A22, 0x11FE, 0x674A,
+        0xA803, 0xDEB7, 0x456B, 0x33DF, 0x62F2, 0x1446, 0x8F9A, 0xF92E,
+        0x2DC0, 0x5B74, 0xC0A8, 0xB61C, 0xE731, 0x9185, 0x0A59, 0x7CED,
+        0x84EA, 0xF25E, 0x6982, 0x1F36, 0x4E1B, 0x38AF, 0xA373, 0xD5C7,
+        0x0129, 0x779D, 0xEC41, 0x9AF5, 0xCBD8, 0xBD6C, 0x26B0, 0x5004,
+        0x9F4D, 0xE9F9, 0x7225, 0x0491, 0x55BC, 0x2308, 0xB8D4, 0xCE60,
+        0x1A8E, 0x6C3A, 0xF7E6, 0x8152, 0xD07F, 0xA6CB, 0x3D17, 0x4BA3,
+    },
+#endif
+#if CFF_CRC_TABLE_SLICES >= 8
+    {
+        0x0000, 0xAA51, 0x4483, 0xEED2, 0x8906, 0x2357, 0xCD85, 0x67D4,
+        0x022D, 0xA87C, 0x46AE, 0xECFF, 0x8B2B, 0x217A, 0xCFA8, 0x65F9,
+        0x045A, 0xAE0B, 0x40D9, 0xEA88, 0x8D5C, 0x270D, 0xC9DF, 0x638E,
+        0x0677, 0xAC26, 0x42F4, 0xE8A5, 0x8F71, 0x2520, 0xCBF2, 0x61A3,
+        0x08B4, 0xA2E5, 0x4C37, 0xE666, 0x81B2, 0x2BE3, 0xC531, 0x6F60,
+        0x0A99, 0xA0C8, 0x4E1A, 0xE44B, 0x839F, 0x29CE, 0xC71C, 0x6D4D,
+        0x0CEE, 0xA6BF, 0x486D, 0xE23C, 0x85E8, 0x2FB9, 0xC16B, 0x6B3A,
+        0x0EC3, 0xA492, 0x4A40, 0xE011, 0x87C5, 0x2D94, 0xC346, 0x6917,
+        0x1168, 0xBB39, 0x55EB, 0xFFBA, 0x986E, 0x323F, 0xDCED, 0x76BC,
+        0x1345, 0xB914, 0x57C6, 0xFD97, 0x9A43, 0x3012, 0xDEC0, 0x7491,
+        0x1532, 0xBF63, 0x51B1, 0xFBE0, 0x9C34, 0x3665, 0xD8B7, 0x72E6,
+        0x171F, 0xBD4E, 0x539C, 0xF9CD, 0x9E19, 0x3448, 0xDA9A, 0x70CB,
+        0x19DC, 0xB38D, 0x5D5F, 0xF70E, 0x90DA, 0x3A8B, 0xD459, 0x7E08,
+        0x1BF1, 0xB1A0, 0x5F72, 0xF523, 0x92F7, 0x38A6, 0xD674, 0x7C25,
+        0x1D86, 0xB7D7, 0x5905, 0xF354, 0x9480, 0x3ED1, 0xD003, 0x7A52,
+        0x1FAB, 0xB5FA, 0x5B28, 0xF179, 0x96AD, 0x3CFC, 0xD22E, 0x787F,
+        0x22D0, 0x8881, 0x6653, 0xCC02, 0xABD6, 0x0187, 0xEF55, 0x4504,
+        0x20FD, 0x8AAC, 0x647E, 0xCE2F, 0xA9FB, 0x03AA, 0xED78, 0x4729,
+        0x268A, 0x8CDB, 0x6209, 0xC858, 0xAF8C, 0x05DD, 0xEB0F, 0x415E,
+        0x24A7, 0x8EF6, 0x6024, 0xCA75, 0xADA1, 0x07F0, 0xE922, 0x4373,
+        0x2A64, 0x8035, 0x6EE7, 0xC4B6, 0xA362, 0x0933, 0xE7E1, 0x4DB0,
+        0x2849, 0x8218, 0x6CCA, 0xC69B, 0xA14F, 0x0B1E, 0xE5CC, 0x4F9D,
+        0x2E3E, 0x846F, 0x6ABD, 0xC0EC, 0xA738, 0x0D69, 0xE3BB, 0x49EA,
+        0x2C13, 0x8642, 0x6890, 0xC2C1, 0xA515, 0x0F44, 0xE196, 0x4BC7,
+        0x33B8, 0x99E9, 0x773B, 0xDD6A, 0xBABE, 0x10EF, 0xFE3D, 0x546C,
+        0x3195, 0x9BC4, 0x7516, 0xDF47, 0xB893, 0x12C2, 0xFC10, 0x5641,
+        0x37E2, 0x9DB3, 0x7361, 0xD930, 0xBEE4, 0x14B5, 0xFA67, 0x5036,
+        0x35CF, 0x9F9E, 0x714C, 0xDB1D, 0xBCC9, 0x1698, 0xF84A, 0x521B,
+        0x3B0C, 0x915D, 0x7F8F, 0xD5DE, 0xB20A, 0x185B, 0xF689, 0x5CD8,
+        0x3921, 0x9370, 0x7DA2, 0xD7F3, 0xB027, 0x1A76, 0xF4A4, 0x5EF5,
+        0x3F56, 0x9507, 0x7BD5, 0xD184, 0xB650, 0x1C01, 0xF2D3, 0x5882,
+        0x3D7B, 0x972A, 0x79F8, 0xD3A9, 0xB47D, 0x1E2C, 0xF0FE, 0x5AAF,
+    },
+    {
+        0x0000, 0x45A0, 0x8B40, 0xCEE0, 0x06A1, 0x4301, 0x8DE1, 0xC841,
+        0x0D42, 0x48E2, 0x8602, 0xC3A2, 0x0BE3, 0x4E43, 0x80A3, 0xC503,
+        0x1A84, 0x5F24, 0x91C4, 0xD464, 0x1C25, 0x5985, 0x9765, 0xD2C5,
+        0x17C6, 0x5266, 0x9C86, 0xD926, 0x1167, 0x54C7, 0x9A27, 0xDF87,
+        0x3508, 0x70A8, 0xBE48, 0xFBE8, 0x33A9, 0x7609, 0xB8E9, 0xFD49,
+        0x384A, 0x7DEA, 0xB30A, 0xF6AA, 0x3EEB, 0x7B4B, 0xB5AB, 0xF00B,
+        0x2F8C, 0x6A2C, 0xA4CC, 0xE16C, 0x292D, 0x6C8D, 0xA26D, 0xE7CD,
+        0x22CE, 0x676E, 0xA98E, 0xEC2E, 0x246F, 0x61CF, 0xAF2F, 0xEA8F,
+        0x6A10, 0x2FB0, 0xE150, 0xA4F0, 0x6CB1, 0x2911, 0xE7F1, 0xA251,
+        0x6752, 0x22F2, 0xEC12, 0xA9B2, 0x61F3, 0x2453, 0xEAB3, 0xAF13,
+        0x7094, 0x3534, 0xFBD4, 0xBE74, 0x7635, 0x3395, 0xFD75, 0xB8D5,
+        0x7DD6, 0x3876, 0xF696, 0xB336, 0x7B77, 0x3ED7, 0xF037, 0xB597,
+        0x5F18, 0x1AB8, 0xD458, 0x91F8, 0x59B9, 0x1C19, 0xD2F9, 0x9759,
+        0x525A, 0x17FA, 0xD91A, 0x9CBA, 0x54FB, 0x115B, 0xDFBB, 0x9A1B,
+        0x459C, 0x003C, 0xCEDC, 0x8B7C, 0x433D, 0x069D, 0xC87D, 0x8DDD,
+        0x48DE, 0x0D7E, 0xC39E, 0x863E, 0x4E7F, 0x0BDF, 0xC53F, 0x809F,
+        0xD420, 0x9180, 0x5F60, 0x1AC0, 0xD281, 0x9721, 0x59C1, 0x1C61,
+        0xD962, 0x9CC2, 0x5222, 0x1782, 0xDFC3, 0x9A63, 0x5483, 0x1123,
+        0xCEA4, 0x8B04, 0x45E4, 0x0044, 0xC805, 0x8DA5, 0x4345, 0x06E5,
+        0xC3E6, 0x8646, 0x48A6, 0x0D06, 0xC547, 0x80E7, 0x4E07, 0x0BA7,
+        0xE128, 0xA488, 0x6A68, 0x2FC8, 0xE789, 0xA229, 0x6CC9, 0x2969,
+        0xEC6A, 0xA9CA, 0x672A, 0x228A, 0xEACB, 0xAF6B, 0x618B, 0x242B,
+        0xFBAC, 0xBE0C, 0x70EC, 0x354C, 0xFD0D, 0xB8AD, 0x764D, 0x33ED,
+        0xF6EE, 0xB34E, 0x7DAE, 0x380E, 0xF04F, 0xB5EF, 0x7B0F, 0x3EAF,
+        0xBE30, 0xFB90, 0x3570, 0x70D0, 0xB891, 0xFD31, 0x33D1, 0x7671,
+        0xB372, 0xF6D2, 0x3832, 0x7D92, 0xB5D3, 0xF073, 0x3E93, 0x7B33,
+        0xA4B4, 0xE114, 0x2FF4, 0x6A54, 0xA215, 0xE7B5, 0x2955, 0x6CF5,
+        0xA9F6, 0xEC56, 0x22B6, 0x6716, 0xAF57, 0xEAF7, 0x2417, 0x61B7,
+        0x8B38, 0xCE98, 0x0078, 0x45D8, 0x8D99, 0xC839, 0x06D9, 0x4379,
+        0x867A, 0xC3DA, 0x0D3A, 0x489A, 0x80DB, 0xC57B, 0x0B9B, 0x4E3B,
+        0x91BC, 0xD41C, 0x1AFC, 0x5F5C, 0x971D, 0xD2BD, 0x1C5D, 0x59FD,
+        0x9CFE, 0xD95E, 0x17BE, 0x521E, 0x9A5F, 0xDFFF, 0x111F, 0x54BF,
+    },
+    {
+        0x0000, 0xB861, 0x60E3, 0xD882, 0xC1C6, 0x79A7, 0xA125, 0x1944,
+        0x93AD, 0x2BCC, 0xF34E, 0x4B2F, 0x526B, 0xEA0A, 0x3288, 0x8AE9,
+        0x377B, 0x8F1A, 0x5798, 0xEFF9, 0xF6BD, 0x4EDC, 0x965E, 0x2E3F,
+        0xA4D6, 0x1CB7, 0xC435, 0x7C54, 0x6510, 0xDD71, 0x05F3, 0xBD92,
+        0x6EF6, 0xD697, 0x0E15, 0xB674, 0xAF30, 0x1751, 0xCFD3, 0x77B2,
+        0xFD5B, 0x453A, 0x9DB8, 0x25D9, 0x3C9D, 0x84FC, 0x5C7E, 0xE41F,
+        0x598D, 0xE1EC, 0x396E, 0x810F, 0x984B, 0x202A, 0xF8A8, 0x40C9,
+        0xCA20, 0x7241, 0xAAC3, 0x12A2, 0x0BE6, 0xB387, 0x6B05, 0xD364,
+        0xDDEC, 0x658D, 0xBD0F, 0x056E, 0x1C2A, 0xA44B, 0x7CC9, 0xC4A8,
+        0x4E41, 0xF620, 0x2EA2, 0x96C3, 0x8F87, 0x37E6, 0xEF64, 0x5705,
+        0xEA97, 0x52F6, 0x8A74, 0x3215, 0x2B51, 0x9330, 0x4BB2, 0xF3D3,
+        0x793A, 0xC15B, 0x19D9, 0xA1B8, 0xB8FC, 0x009D, 0xD81F, 0x607E,
+        0xB31A, 0x0B7B, 0xD3F9, 0x6B98, 0x72DC, 0xCABD, 0x123F, 0xAA5E,
+        0x20B7, 0x98D6, 0x4054, 0xF835, 0xE171, 0x5910, 0x8192, 0x39F3,
+        0x8461, 0x3C00, 0xE482, 0x5CE3, 0x45A7, 0xFDC6, 0x2544, 0x9D25,
+        0x17CC, 0xAFAD, 0x772F, 0xCF4E, 0xD60A, 0x6E6B, 0xB6E9, 0x0E88,
+        0xABF9, 0x1398, 0xCB1A, 0x737B, 0x6A3F, 0xD25E, 0x0ADC, 0xB2BD,
+        0x3854, 0x8035, 0x58B7, 0xE0D6, 0xF992, 0x41F3, 0x9971, 0x2110,
+        0x9C82, 0x24E3, 0xFC61, 0x4400, 0x5D44, 0xE525, 0x3DA7, 0x85C6,
+        0x0F2F, 0xB74E, 0x6FCC, 0xD7AD, 0xCEE9, 0x7688, 0xAE0A, 0x166B,
+        0xC50F, 0x7D6E, 0xA5EC, 0x1D8D, 0x04C9, 0xBCA8, 0x642A, 0xDC4B,
+        0x56A2, 0xEEC3, 0x3641, 0x8E20, 0x9764, 0x2F05, 0xF787, 0x4FE6,
+        0xF274, 0x4A15, 0x9297, 0x2AF6, 0x33B2, 0x8BD3, 0x5351, 0xEB30,
+        0x61D9, 0xD9B8, 0x013A, 0xB95B, 0xA01F, 0x187E, 0xC0FC, 0x789D,
+        0x7615, 0xCE74, 0x16F6, 0xAE97, 0xB7D3, 0x0FB2, 0xD730, 0x6F51,
+        0xE5B8, 0x5DD9, 0x855B, 0x3D3A, 0x247E, 0x9C1F, 0x449D, 0xFCFC,
+        0x416E, 0xF90F, 0x218D, 0x99EC, 0x80A8, 0x38C9, 0xE04B, 0x582A,
+        0xD2C3, 0x6AA2, 0xB220, 0x0A41, 0x1305, 0xAB64, 0x73E6, 0xCB87,
+        0x18E3, 0xA082, 0x7800, 0xC061, 0xD925, 0x6144, 0xB9C6, 0x01A7,
+        0x8B4E, 0x332F, 0xEBAD, 0x53CC, 0x4A88, 0xF2E9, 0x2A6B, 0x920A,
+        0x2F98, 0x97F9, 0x4F7B, 0xF71A, 0xEE5E, 0x563F, 0x8EBD, 0x36DC,
+        0xBC35, 0x0454, 0xDCD6, 0x64B7, 0x7DF3, 0xC592, 0x1D10, 0xA571,
+    },
+    {
+        0x0000, 0x47D3, 0x8FA6, 0xC875, 0x0F6D, 0x48BE, 0x80CB, 0xC718,
+        0x1EDA, 0x5909, 0x917C, 0xD6AF, 0x11B7, 0x5664, 0x9E11, 0xD9C2,
+        0x3DB4, 0x7A67, 0xB212, 0xF5C1, 0x32D9, 0x750A, 0xBD7F, 0xFAAC,
+        0x236E, 0x64BD, 0xACC8, 0xEB1B, 0x2C03, 0x6BD0, 0xA3A5, 0xE476,
+        0x7B68, 0x3CBB, 0xF4CE, 0xB31D, 0x7405, 0x33D6, 0xFBA3, 0xBC70,
+        0x65B2, 0x2261, 0xEA14, 0xADC7, 0x6ADF, 0x2D0C, 0xE579, 0xA2AA,
+        0x46DC, 0x010F, 0xC97A, 0x8EA9, 0x49B1, 0x0E62, 0xC617, 0x81C4,
+        0x5806, 0x1FD5, 0xD7A0, 0x9073, 0x576B, 0x10B8, 0xD8CD, 0x9F1E,
+        0xF6D0, 0xB103, 0x7976, 0x3EA5, 0xF9BD, 0xBE6E, 0x761B, 0x31C8,
+        0xE80A, 0xAFD9, 0x67AC, 0x207F, 0xE767, 0xA0B4, 0x68C1, 0x2F12,
+        0xCB64, 0x8CB7, 0x44C2, 0x0311, 0xC409, 0x83DA, 0x4BAF, 0x0C7C,
+        0xD5BE, 0x926D, 0x5A18, 0x1DCB, 0xDAD3, 0x9D00, 0x5575, 0x12A6,
+        0x8DB8, 0xCA6B, 0x021E, 0x45CD, 0x82D5, 0xC506, 0x0D73, 0x4AA0,
+        0x9362, 0xD4B1, 0x1CC4, 0x5B17, 0x9C0F, 0xDBDC, 0x13A9, 0x547A,
+        0xB00C, 0xF7DF, 0x3FAA, 0x7879, 0xBF61, 0xF8B2, 0x30C7, 0x7714,
+        0xAED6, 0xE905, 0x2170, 0x66A3, 0xA1BB, 0xE668, 0x2E1D, 0x69CE,
+        0xFD81, 0xBA52, 0x7227, 0x35F4, 0xF2EC, 0xB53F, 0x7D4A, 0x3A99,
+        0xE35B, 0xA488, 0x6CFD, 0x2B2E, 0xEC36, 0xABE5, 0x6390, 0x2443,
+        0xC035, 0x87E6, 0x4F93, 0x0840, 0xCF58, 0x888B, 0x40FE, 0x072D,
+        0xDEEF, 0x993C, 0x5149, 0x169A, 0xD182, 0x9651, 0x5E24, 0x19F7,
+        0x86E9, 0xC13A, 0x094F, 0x4E9C, 0x8984, 0xCE57, 0x0622, 0x41F1,
+        0x9833, 0xDFE0, 0x1795, 0x5046, 0x975E, 0xD08D, 0x18F8, 0x5F2B,
+        0xBB5D, 0xFC8E, 0x34FB, 0x7328, 0xB430, 0xF3E3, 0x3B96, 0x7C45,
+        0xA587, 0xE254, 0x2A21, 0x6DF2, 0xAAEA, 0xED39, 0x254C, 0x629F,
+        0x0B51, 0x4C82, 0x84F7, 0xC324, 0x043C, 0x43EF, 0x8B9A, 0xCC49,
+        0x158B, 0x5258, 0x9A2D, 0xDDFE, 0x1AE6, 0x5D35, 0x9540, 0xD293,
+        0x36E5, 0x7136, 0xB943, 0xFE90, 0x3988, 0x7E5B, 0xB62E, 0xF1FD,
+        0x283F, 0x6FEC, 0xA799, 0xE04A, 0x2752, 0x6081, 0xA8F4, 0xEF27,
+        0x7039, 0x37EA, 0xFF9F, 0xB84C, 0x7F54, 0x3887, 0xF0F2, 0xB721,
+        0x6EE3, 0x2930, 0xE145, 0xA696, 0x618E, 0x265D, 0xEE28, 0xA9FB,
+        0x4D8D, 0x0A5E, 0xC22B, 0x85F8, 0x42E0, 0x0533, 0xCD46, 0x8A95,
+        0x5357, 0x1484, 0xDCF1, 0x9B22, 0x5C3A, 0x1BE9, 0xD39C, 0x944F,
+    },
+#endif
+};
+
+// Reference implementation, one table lookup per byte. Every other backend must produce identical results.
+static uint16_t cff_crc16_update_bytewise(uint16_t crc, const uint8_t *data, size_t data_size_bytes)
+{
+    for (size_t i = 0; i < data_size_bytes; i++) {
+        uint8_t tbl_idx = (uint8_t) ((crc >> 8) ^ data[i]);
+        crc = (uint16_t) ((crc << 8) ^ cff_crc_table[0][tbl_idx]);
+    }
+    return crc;
+}
 
-static void cff_init_crc_table(void)
+#if CFF_CRC_TABLE_SLICES >= 4
+static uint16_t cff_crc16_update_slicing_by_4(uint16_t crc, const uint8_t *data, size_t data_size_bytes)
 {
-    if (cff_crc_table_initialized) {
-        return;
+    while (data_size_bytes >= 4) {
+        crc ^= (uint16_t) ((data[0] << 8) | data[1]);
+        crc = cff_crc_table[3][crc >> 8] ^ cff_crc_table[2][crc & 0xFF] ^ cff_crc_table[1][data[2]] ^
+              cff_crc_table[0][data[3]];
+        data += 4;
+        data_size_bytes -= 4;
     }
+    return cff_crc16_update_bytewise(crc, data, data_size_bytes);
+}
+#endif
 
-    for (int i = 0; i < 256; i++) {
-        uint16_t crc = (uint16_t) (i << 8);
-        for (int j = 0; j < 8; j++) {
-            if (crc & 0x8000) {
-                crc = (crc << 1) ^ CFF_CRC_POLYNOMIAL;
-            }
-            else {
-                crc = crc << 1;
-            }
+#if CFF_CRC_TABLE_SLICES >= 8
+static uint16_t cff_crc16_update_slicing_by_8(uint16_t crc, const uint8_t *data, size_t data_size_bytes)
+{
+    while (data_size_bytes >= 8) {
+        crc ^= (uint16_t) ((data[0] << 8) | data[1]);
+        crc = cff_crc_table[7][crc >> 8] ^ cff_crc_table[6][crc & 0xFF] ^ cff_crc_table[5][data[2]] ^
+              cff_crc_table[4][data[3]] ^ cff_crc_table[3][data[4]] ^ cff_crc_table[2][data[5]] ^
+              cff_crc_table[1][data[6]] ^ cff_crc_table[0][data[7]];
+        data += 8;
+        data_size_bytes -= 8;
+    }
+    return cff_crc16_update_bytewise(crc, data, data_size_bytes);
+}
+#endif
+
+#if defined(CFF_CRC_CLMUL_X86) || defined(CFF_CRC_CLMUL_ARM)
+
+// Carry-less multiplication folding. Because the CRC is not reflected, a 16-byte block read most-significant byte first
+// is a 128-bit polynomial X = Xh * x^64 + Xl. Shifting it forward by n bits modulo the CRC polynomial P is
+// Xh * (x^(n+64) mod P) + Xl * (x^n mod P), which fits back into 128 bits and can be XORed into the block n bits later.
+// Once everything has been folded into a single block, the table finishes the job: that block followed by the unfolded
+// tail is congruent to the original message modulo P, so it has the same CRC. The running CRC is absorbed up front by
+// XORing it into the first two message bytes.
+#define CFF_CRC_CLMUL_MIN_SIZE_BYTES 64
+
+#define CFF_CRC_X128 0xAEFC // x^128 mod P
+#define CFF_CRC_X192 0x650B // x^192 mod P
+#define CFF_CRC_X256 0x8E29 // x^256 mod P
+#define CFF_CRC_X320 0x26AA // x^320 mod P
+#define CFF_CRC_X384 0xCDE2 // x^384 mod P
+#define CFF_CRC_X448 0x2535 // x^448 mod P
+#define CFF_CRC_X512 0x13FC // x^512 mod P
+#define CFF_CRC_X576 0x8832 // x^576 mod P
+
+static uint16_t cff_crc16_finish_folded(const uint8_t block[16], const uint8_t *tail, size_t tail_size_bytes)
+{
+    uint16_t crc = cff_crc16_update_bytewise(0, block, 16);
+    return cff_crc16_update_bytewise(crc, tail, tail_size_bytes);
+}
+
+#endif
+
+#if defined(CFF_CRC_CLMUL_X86)
+
+__attribute__((target("pclmul,ssse3"))) static __m128i cff_crc16_clmul_load(const uint8_t *data)
+{
+    const __m128i byte_reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) data), byte_reverse);
+}
+
+__attribute__((target("pclmul,ssse3"))) static __m128i cff_crc16_clmul_fold(__m128i block, __m128i constants)
+{
+    return _mm_xor_si128(_mm_clmulepi64_si128(block, constants, 0x11), _mm_clmulepi64_si128(block, constants, 0x00));
+}
+
+__attribute__((target("pclmul,ssse3"))) static uint16_t cff_crc16_update_clmul(uint16_t crc, const uint8_t *data,
+                                                                                size_t data_size_bytes)
+{
+    const __m128i k128 = _mm_set_epi64x(CFF_CRC_X192, CFF_CRC_X128);
+    const __m128i k256 = _mm_set_epi64x(CFF_CRC_X320, CFF_CRC_X256);
+    const __m128i k384 = _mm_set_epi64x(CFF_CRC_X448, CFF_CRC_X384);
+    const __m128i k512 = _mm_set_epi64x(CFF_CRC_X576, CFF_CRC_X512);
+
+    __m128i x0 = _mm_xor_si128(cff_crc16_clmul_load(data), _mm_set_epi64x((long long) ((uint64_t) crc << 48), 0));
+    __m128i x1 = cff_crc16_clmul_load(data + 16);
+    __m128i x2 = cff_crc16_clmul_load(data + 32);
+    __m128i x3 = cff_crc16_clmul_load(data + 48);
+    data += 64;
+    data_size_bytes -= 64;
+
+    while (data_size_bytes >= 64) {
+        x0 = _mm_xor_si128(cff_crc16_clmul_fold(x0, k512), cff_crc16_clmul_load(data));
+        x1 = _mm_xor_si128(cff_crc16_clmul_fold(x1, k512), cff_crc16_clmul_load(data + 16));
+        x2 = _mm_xor_si128(cff_crc16_clmul_fold(x2, k512), cff_crc16_clmul_load(data + 32));
+        x3 = _mm_xor_si128(cff_crc16_clmul_fold(x3, k512), cff_crc16_clmul_load(data + 48));
+        data += 64;
+        data_size_bytes -= 64;
+    }
+
+    x0 = _mm_xor_si128(_mm_xor_si128(cff_crc16_clmul_fold(x0, k384), cff_crc16_clmul_fold(x1, k256)),
+                       _mm_xor_si128(cff_crc16_clmul_fold(x2, k128), x3));
+
+    while (data_size_bytes >= 16) {
+        x0 = _mm_xor_si128(cff_crc16_clmul_fold(x0, k128), cff_crc16_clmul_load(data));
+        data += 16;
+        data_size_bytes -= 16;
+    }
+
+    const __m128i byte_reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    uint8_t block[16];
+    _mm_storeu_si128((__m128i *) block, _mm_shuffle_epi8(x0, byte_reverse));
+    return cff_crc16_finish_folded(block, data, data_size_bytes);
+}
+
+static bool cff_crc16_clmul_available(void)
+{
+    return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3");
+}
+
+#elif defined(CFF_CRC_CLMUL_ARM)
+
+static uint8x16_t cff_crc16_clmul_load(const uint8_t *data)
+{
+    // Reverse all 16 bytes so that lane 1 holds the most significant 64 bits of the block
+    uint8x16_t block = vrev64q_u8(vld1q_u8(data));
+    return vextq_u8(block, block, 8);
+}
+
+static uint8x16_t cff_crc16_clmul_fold(uint8x16_t block, poly64_t k_high, poly64_t k_low)
+{
+    uint64x2_t lanes = vreinterpretq_u64_u8(block);
+    poly128_t high = vmull_p64((poly64_t) vgetq_lane_u64(lanes, 1), k_high);
+    poly128_t low = vmull_p64((poly64_t) vgetq_lane_u64(lanes, 0), k_low);
+    return veorq_u8(vreinterpretq_u8_p128(high), vreinterpretq_u8_p128(low));
+}
+
+static uint16_t cff_crc16_update_clmul(uint16_t crc, const uint8_t *data, size_t data_size_bytes)
+{
+    uint64x2_t seed = vcombine_u64(vcreate_u64(0), vcreate_u64((uint64_t) crc << 48));
+    uint8x16_t x0 = veorq_u8(cff_crc16_clmul_load(data), vreinterpretq_u8_u64(seed));
+    uint8x16_t x1 = cff_crc16_clmul_load(data + 16);
+    uint8x16_t x2 = cff_crc16_clmul_load(data + 32);
+    uint8x16_t x3 = cff_crc16_clmul_load(data + 48);
+    data += 64;
+    data_size_bytes -= 64;
+
+    while (data_size_bytes >= 64) {
+        x0 = veorq_u8(cff_crc16_clmul_fold(x0, CFF_CRC_X576, CFF_CRC_X512), cff_crc16_clmul_load(data));
+        x1 = veorq_u8(cff_crc16_clmul_fold(x1, CFF_CRC_X576, CFF_CRC_X512), cff_crc16_clmul_load(data + 16));
+        x2 = veorq_u8(cff_crc16_clmul_fold(x2, CFF_CRC_X576, CFF_CRC_X512), cff_crc16_clmul_load(data + 32));
+        x3 = veorq_u8(cff_crc16_clmul_fold(x3, CFF_CRC_X576, CFF_CRC_X512), cff_crc16_clmul_load(data + 48));
+        data += 64;
+        data_size_bytes -= 64;
+    }
+
+    x0 = veorq_u8(veorq_u8(cff_crc16_clmul_fold(x0, CFF_CRC_X448, CFF_CRC_X384),
+                           cff_crc16_clmul_fold(x1, CFF_CRC_X320, CFF_CRC_X256)),
+                  veorq_u8(cff_crc16_clmul_fold(x2, CFF_CRC_X192, CFF_CRC_X128), x3));
+
+    while (data_size_bytes >= 16) {
+        x0 = veorq_u8(cff_crc16_clmul_fold(x0, CFF_CRC_X192, CFF_CRC_X128), cff_crc16_clmul_load(data));
+        data += 16;
+        data_size_bytes -= 16;
+    }
+
+    uint8_t block[16];
+    uint8x16_t reversed = vrev64q_u8(x0);
+    vst1q_u8(block, vextq_u8(reversed, reversed, 8));
+    return cff_crc16_finish_folded(block, data, data_size_bytes);
+}
+
+static bool cff_crc16_clmul_available(void)
+{
+    return 1;
+}
+
+#endif
+
+// Runs the backend selected by CFF_CRC_BACKEND, falling back to the best portable backend when the CPU lacks
+// carry-less multiply support.
+static uint16_t cff_crc16_update_software(uint16_t crc, const uint8_t *data, size_t data_size_bytes)
+{
+#if defined(CFF_CRC_CLMUL_X86) || defined(CFF_CRC_CLMUL_ARM)
+    if (data_size_bytes >= CFF_CRC_CLMUL_MIN_SIZE_BYTES && cff_crc16_clmul_available()) {
+        return cff_crc16_update_clmul(crc, data, data_size_bytes);
+    }
+#endif
+#if CFF_CRC_TABLE_SLICES >= 8
+    return cff_crc16_update_slicing_by_8(crc, data, data_size_bytes);
+#elif CFF_CRC_TABLE_SLICES >= 4
+    return cff_crc16_update_slicing_by_4(crc, data, data_size_bytes);
+#else
+    return cff_crc16_update_bytewise(crc, data, data_size_bytes);
+#endif
+}
+
+// CRC Provider --------------------------------------------------------------------------------------------------------
+
+static uint16_t cff_crc_software_begin(void *context)
+{
+    (void) context;
+    return CFF_CRC_INIT;
+}
+
+static uint16_t cff_crc_software_update(void *context, uint16_t crc, const uint8_t *data, size_t data_size_bytes)
+{
+    (void) context;
+    return cff_crc16_update_software(crc, data, data_size_bytes);
+}
+
+static uint16_t cff_crc_software_finish(void *context, uint16_t crc)
+{
+    (void) context;
+    return crc; // CRC-16/CCITT-FALSE has no final XOR
+}
+
+static const cff_crc_provider_t cff_crc_software_provider = {
+    cff_crc_software_begin,
+    cff_crc_software_update,
+    cff_crc_software_finish,
+    NULL,
+};
+
+static const cff_crc_provider_t *cff_crc_provider = &cff_crc_software_provider;
+
+cff_error_en_t cff_crc_set_provider(const cff_crc_provider_t *provider)
+{
+    if (provider == NULL) {
+        cff_crc_provider = &cff_crc_software_provider;
+        return cff_error_none;
+    }
+
+    if (provider->begin == NULL || provider->update == NULL || provider->finish == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    cff_crc_provider = provider;
+    return cff_error_none;
+}
+
+uint16_t cff_crc16_begin(void)
+{
+    return cff_crc_provider->begin(cff_crc_provider->context);
+}
+
+uint16_t cff_crc16_update(uint16_t crc, const uint8_t *data, size_t data_size_bytes)
+{
+    if (data_size_bytes == 0) {
+        return crc;
+    }
+    return cff_crc_provider->update(cff_crc_provider->context, crc, data, data_size_bytes);
+}
+
+uint16_t cff_crc16_finish(uint16_t crc)
+{
+    return cff_crc_provider->finish(cff_crc_provider->context, crc);
+}
+
+// CRC API -------------------------------------------------------------------------------------------------------------
+
+bool cff_crc16_backend_available(cff_crc_backend_en_t backend)
+{
+    switch (backend) {
+    case cff_crc_backend_bytewise:
+        return 1;
+    case cff_crc_backend_slicing_by_4:
+        return CFF_CRC_TABLE_SLICES >= 4;
+    case cff_crc_backend_slicing_by_8:
+        return CFF_CRC_TABLE_SLICES >= 8;
+    case cff_crc_backend_clmul:
+#if defined(CFF_CRC_CLMUL_X86) || defined(CFF_CRC_CLMUL_ARM)
+        return cff_crc16_clmul_available();
+#else
+        return 0;
+#endif
+    default:
+        return 0;
+    }
+}
+
+cff_error_en_t cff_crc16_with_backend(cff_crc_backend_en_t backend, const uint8_t *data, size_t data_size_bytes,
+                                      uint16_t *crc)
+{
+    if (data == NULL || crc == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (!cff_crc16_backend_available(backend)) {
+        return cff_error_not_supported;
+    }
+
+    switch (backend) {
+#if CFF_CRC_TABLE_SLICES >= 4
+    case cff_crc_backend_slicing_by_4:
+        *crc = cff_crc16_update_slicing_by_4(CFF_CRC_INIT, data, data_size_bytes);
+        break;
+#endif
+#if CFF_CRC_TABLE_SLICES >= 8
+    case cff_crc_backend_slicing_by_8:
+        *crc = cff_crc16_update_slicing_by_8(CFF_CRC_INIT, data, data_size_bytes);
+        break;
+#endif
+#if defined(CFF_CRC_CLMUL_X86) || defined(CFF_CRC_CLMUL_ARM)
+    case cff_crc_backend_clmul:
+        // The folding kernel needs at least one 64-byte stride, shorter inputs go through the table
+        if (data_size_bytes >= CFF_CRC_CLMUL_MIN_SIZE_BYTES) {
+            *crc = cff_crc16_update_clmul(CFF_CRC_INIT, data, data_size_bytes);
         }
-        cff_crc_table[i] = crc;
+        else {
+            *crc = cff_crc16_update_bytewise(CFF_CRC_INIT, data, data_size_bytes);
+        }
+        break;
+#endif
+    default:
+        *crc = cff_crc16_update_bytewise(CFF_CRC_INIT, data, data_size_bytes);
+        break;
     }
-    cff_crc_table_initialized = 1;
+    return cff_error_none;
 }
 
 cff_error_en_t cff_crc16(const uint8_t *data, size_t data_size_bytes, uint16_t *crc)
@@ -218,14 +1112,23 @@ cff_error_en_t cff_crc16(const uint8_t *data, size_t data_size_bytes, uint16_t *
         return cff_error_null_pointer;
     }
 
-    cff_init_crc_table();
+    *crc = cff_crc16_finish(cff_crc16_update(cff_crc16_begin(), data, data_size_bytes));
+    return cff_error_none;
+}
 
-    *crc = CFF_CRC_INIT;
-    for (size_t i = 0; i < data_size_bytes; i++) {
-        uint8_t tbl_idx = (uint8_t) ((*crc >> 8) ^ data[i]);
-        *crc = (*crc << 8) ^ cff_crc_table[tbl_idx];
+//! Feed a region of a ring buffer's data into a running CRC. The region must lie within the available data.
+static uint16_t cff_crc16_update_ring_buffer(const cff_ring_buffer_t *ring_buffer, uint16_t crc, uint32_t offset,
+                                             size_t data_size_bytes)
+{
+    // The region is at most two contiguous segments: up to the end of the storage, then from its start
+    uint32_t start = cff_ring_buffer_offset_position(ring_buffer, offset);
+    if (cff_ring_buffer_is_mirrored(ring_buffer)) {
+        return cff_crc16_update(crc, ring_buffer->buffer + start, data_size_bytes);
     }
-    return cff_error_none;
+    size_t first_segment_size = CFF_MIN(data_size_bytes, (size_t) (ring_buffer->buffer_size - start));
+
+    crc = cff_crc16_update(crc, ring_buffer->buffer + start, first_segment_size);
+    return cff_crc16_update(crc, ring_buffer->buffer, data_size_bytes - first_segment_size);
 }
 
 cff_error_en_t cff_crc16_ring_buffer(const cff_ring_buffer_t *ring_buffer, uint32_t offset, size_t data_size_bytes,
@@ -240,17 +1143,8 @@ cff_error_en_t cff_crc16_ring_buffer(const cff_ring_buffer_t *ring_buffer, uint3
         return cff_error_insufficient_space;
     }
 
-    cff_init_crc_table();
-
-    *crc = CFF_CRC_INIT;
-    uint32_t current_offset = (ring_buffer->consume_index + offset) % ring_buffer->buffer_size;
-
-    for (size_t i = 0; i < data_size_bytes; i++) {
-        uint8_t byte_value = ring_buffer->buffer[current_offset];
-        uint8_t tbl_idx = (uint8_t) ((*crc >> 8) ^ byte_value);
-        *crc = (*crc << 8) ^ cff_crc_table[tbl_idx];
-        current_offset = (current_offset + 1) % ring_buffer->buffer_size;
-    }
+    uint16_t running_crc = cff_crc16_update_ring_buffer(ring_buffer, cff_crc16_begin(), offset, data_size_bytes);
+    *crc = cff_crc16_finish(running_crc);
 
     return cff_error_none;
 }
@@ -270,37 +1164,47 @@ cff_error_en_t cff_frame_builder_init(cff_frame_builder_t *builder, uint8_t *buf
     builder->buffer = buffer;
     builder->buffer_size_bytes = buffer_size_bytes;
     builder->frame_counter = 0;
+    builder->frame_in_progress = false;
+    builder->payload_crc = 0;
+    builder->payload_size_bytes = 0;
+    builder->payload_bytes_written = 0;
+    builder->batch_size_bytes = 0;
+#ifdef CFF_ENABLE_STATS
+    builder->stats = NULL;
+#endif
 
     return cff_error_none;
 }
 
-cff_error_en_t cff_build_frame(cff_frame_builder_t *builder, const uint8_t *payload, size_t payload_size_bytes)
+cff_error_en_t cff_frame_builder_set_stats(cff_frame_builder_t *builder, cff_stats_t *stats)
 {
-    if (builder == NULL || builder->buffer == NULL) {
-        return cff_error_null_pointer;
-    }
-
-    if (payload_size_bytes > CFF_MAX_PAYLOAD_SIZE_BYTES) {
-        return cff_error_payload_too_large;
-    }
-
-    if (payload == NULL) {
+    if (builder == NULL) {
         return cff_error_null_pointer;
     }
 
-    size_t required_size_bytes = cff_calculate_frame_size_bytes(payload_size_bytes);
-    if (required_size_bytes > builder->buffer_size_bytes) {
-        return cff_error_buffer_too_small;
-    }
+#ifdef CFF_ENABLE_STATS
+    builder->stats = stats;
+    return cff_error_none;
+#else
+    (void) stats;
+    return cff_error_not_supported;
+#endif
+}
 
-    uint8_t *ptr = builder->buffer;
+//! Write a complete frame header, including its CRC, for the builder's next frame
+static cff_error_en_t cff_write_header(cff_frame_builder_t *builder, uint8_t *ptr, size_t payload_size_bytes)
+{
+    // Single frames are built at the start of the buffer, so starting one abandons a frame begun with
+    // cff_frame_builder_begin() and any batched frames
+    builder->frame_in_progress = false;
+    builder->batch_size_bytes = 0;
 
     // Write preamble
     ptr[0] = CFF_PREAMBLE_BYTE_0;
     ptr[1] = CFF_PREAMBLE_BYTE_1;
 
-    // Write frame counter and payload size, then increment the frame counter
-    cff_set_uint16_le(&ptr[2], builder->frame_counter++);
+    // Write frame counter and payload size
+    cff_set_uint16_le(&ptr[2], builder->frame_counter);
     cff_set_uint16_le(&ptr[4], (uint16_t) payload_size_bytes);
 
     // Calculate and write header CRC
@@ -311,89 +1215,363 @@ cff_error_en_t cff_build_frame(cff_frame_builder_t *builder, const uint8_t *payl
     }
     cff_set_uint16_le(&ptr[6], header_crc);
 
-    // Write payload
-    memcpy(&ptr[CFF_HEADER_SIZE_BYTES], payload, payload_size_bytes);
-
-    // Calculate and write payload CRC
-    uint16_t payload_crc;
-    error = cff_crc16(&ptr[CFF_HEADER_SIZE_BYTES], payload_size_bytes, &payload_crc);
-    if (error != cff_error_none) {
-        return error;
-    }
-    cff_set_uint16_le(&ptr[CFF_HEADER_SIZE_BYTES + payload_size_bytes], payload_crc);
-
     return cff_error_none;
 }
 
-cff_error_en_t cff_parse_frame(cff_ring_buffer_t *ring_buffer, cff_frame_t *frame)
+cff_error_en_t cff_build_frame(cff_frame_builder_t *builder, const uint8_t *payload, size_t payload_size_bytes)
 {
-    if (ring_buffer == NULL || frame == NULL) {
+    if (builder == NULL || builder->buffer == NULL) {
         return cff_error_null_pointer;
     }
 
-    uint32_t available = cff_ring_buffer_available_data(ring_buffer);
-    if (available < CFF_MIN_FRAME_SIZE_BYTES) {
+    if (payload_size_bytes > CFF_MAX_PAYLOAD_SIZE_BYTES) {
+        return cff_error_payload_too_large;
+    }
+
+    if (payload == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    size_t required_size_bytes = cff_calculate_frame_size_bytes(payload_size_bytes);
+    if (required_size_bytes > builder->buffer_size_bytes) {
+        return cff_error_buffer_too_small;
+    }
+
+    // Write payload, then everything around it
+    memcpy(&builder->buffer[CFF_HEADER_SIZE_BYTES], payload, payload_size_bytes);
+
+    return cff_finalize_frame(builder, payload_size_bytes);
+}
+
+cff_error_en_t cff_frame_builder_payload(cff_frame_builder_t *builder, uint8_t **payload, size_t *capacity_bytes)
+{
+    if (builder == NULL || builder->buffer == NULL || payload == NULL || capacity_bytes == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    *payload = &builder->buffer[CFF_HEADER_SIZE_BYTES];
+    size_t capacity = builder->buffer_size_bytes - CFF_MIN_FRAME_SIZE_BYTES;
+    *capacity_bytes = CFF_MIN(capacity, (size_t) CFF_MAX_PAYLOAD_SIZE_BYTES);
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_finalize_frame(cff_frame_builder_t *builder, size_t payload_size_bytes)
+{
+    if (builder == NULL || builder->buffer == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (payload_size_bytes > CFF_MAX_PAYLOAD_SIZE_BYTES) {
+        return cff_error_payload_too_large;
+    }
+
+    if (cff_calculate_frame_size_bytes(payload_size_bytes) > builder->buffer_size_bytes) {
+        return cff_error_buffer_too_small;
+    }
+
+    uint8_t *ptr = builder->buffer;
+
+    // Write header
+    cff_error_en_t error = cff_write_header(builder, ptr, payload_size_bytes);
+    if (error != cff_error_none) {
+        return error;
+    }
+
+    // Calculate and write payload CRC
+    uint16_t payload_crc = cff_crc16_finish(
+        cff_crc16_update(cff_crc16_begin(), &ptr[CFF_HEADER_SIZE_BYTES], payload_size_bytes));
+    cff_set_uint16_le(&ptr[CFF_HEADER_SIZE_BYTES + payload_size_bytes], payload_crc);
+
+    // Increment the frame counter
+    builder->frame_counter++;
+    CFF_STATS_ADD(builder, frames_built, 1);
+    CFF_STATS_ADD(builder, bytes_built, (uint32_t) cff_calculate_frame_size_bytes(payload_size_bytes));
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_batch_build_frame(cff_frame_builder_t *builder, const uint8_t *payload, size_t payload_size_bytes)
+{
+    if (builder == NULL || builder->buffer == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    size_t frame_size_bytes = cff_calculate_frame_size_bytes(payload_size_bytes);
+    if (payload_size_bytes <= CFF_MAX_PAYLOAD_SIZE_BYTES && frame_size_bytes <= builder->buffer_size_bytes &&
+        frame_size_bytes > builder->buffer_size_bytes - builder->batch_size_bytes) {
+        return cff_error_buffer_full;
+    }
+
+    // Build the frame with a builder covering the unused end of the buffer
+    cff_frame_builder_t remainder = *builder;
+    remainder.buffer += builder->batch_size_bytes;
+    remainder.buffer_size_bytes -= builder->batch_size_bytes;
+
+    cff_error_en_t error = cff_build_frame(&remainder, payload, payload_size_bytes);
+    if (error != cff_error_none) {
+        return error;
+    }
+
+    builder->frame_in_progress = false;
+    builder->frame_counter = remainder.frame_counter;
+    builder->batch_size_bytes += frame_size_bytes;
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_frame_builder_batch(const cff_frame_builder_t *builder, cff_span_t *batch)
+{
+    if (builder == NULL || batch == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    batch->data = builder->buffer;
+    batch->size_bytes = builder->batch_size_bytes;
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_frame_builder_reset_batch(cff_frame_builder_t *builder)
+{
+    if (builder == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    builder->batch_size_bytes = 0;
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_frame_builder_begin(cff_frame_builder_t *builder, size_t payload_size_bytes)
+{
+    if (builder == NULL || builder->buffer == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (payload_size_bytes > CFF_MAX_PAYLOAD_SIZE_BYTES) {
+        return cff_error_payload_too_large;
+    }
+
+    if (cff_calculate_frame_size_bytes(payload_size_bytes) > builder->buffer_size_bytes) {
+        return cff_error_buffer_too_small;
+    }
+
+    // The payload size is known up front, so the header can be written straight away
+    cff_error_en_t error = cff_write_header(builder, builder->buffer, payload_size_bytes);
+    if (error != cff_error_none) {
+        return error;
+    }
+
+    builder->frame_in_progress = true;
+    builder->payload_crc = cff_crc16_begin();
+    builder->payload_size_bytes = payload_size_bytes;
+    builder->payload_bytes_written = 0;
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_frame_builder_append(cff_frame_builder_t *builder, const uint8_t *data, size_t data_size_bytes)
+{
+    if (builder == NULL || builder->buffer == NULL || (data == NULL && data_size_bytes > 0)) {
+        return cff_error_null_pointer;
+    }
+
+    if (!builder->frame_in_progress) {
+        return cff_error_invalid_state;
+    }
+
+    if (data_size_bytes > builder->payload_size_bytes - builder->payload_bytes_written) {
+        return cff_error_payload_too_large;
+    }
+
+    if (data_size_bytes == 0) {
+        return cff_error_none;
+    }
+
+    // Hash the source rather than the copy, it was just produced and is still in cache
+    memcpy(&builder->buffer[CFF_HEADER_SIZE_BYTES + builder->payload_bytes_written], data, data_size_bytes);
+    builder->payload_crc = cff_crc16_update(builder->payload_crc, data, data_size_bytes);
+    builder->payload_bytes_written += data_size_bytes;
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_frame_builder_end(cff_frame_builder_t *builder)
+{
+    if (builder == NULL || builder->buffer == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (!builder->frame_in_progress) {
+        return cff_error_invalid_state;
+    }
+
+    if (builder->payload_bytes_written != builder->payload_size_bytes) {
+        return cff_error_incomplete_frame;
+    }
+
+    uint16_t payload_crc = cff_crc16_finish(builder->payload_crc);
+    cff_set_uint16_le(&builder->buffer[CFF_HEADER_SIZE_BYTES + builder->payload_size_bytes], payload_crc);
+
+    builder->frame_in_progress = false;
+    builder->frame_counter++;
+    CFF_STATS_ADD(builder, frames_built, 1);
+    CFF_STATS_ADD(builder, bytes_built, (uint32_t) cff_calculate_frame_size_bytes(builder->payload_size_bytes));
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_build_frame_segments(cff_frame_builder_t *builder, const uint8_t *payload, size_t payload_size_bytes,
+                                        cff_span_t segments[CFF_FRAME_SEGMENT_COUNT])
+{
+    if (builder == NULL || builder->buffer == NULL || segments == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (payload_size_bytes > CFF_MAX_PAYLOAD_SIZE_BYTES) {
+        return cff_error_payload_too_large;
+    }
+
+    if (payload == NULL && payload_size_bytes > 0) {
+        return cff_error_null_pointer;
+    }
+
+    // The header and payload CRC are stored back to back at the start of the buffer, the payload stays where it is
+    uint8_t *header = builder->buffer;
+    uint8_t *trailer = builder->buffer + CFF_HEADER_SIZE_BYTES;
+
+    cff_error_en_t error = cff_write_header(builder, header, payload_size_bytes);
+    if (error != cff_error_none) {
+        return error;
+    }
+
+    // cff_crc16() rejects a NULL pointer even for an empty payload, so use the incremental API
+    uint16_t payload_crc = cff_crc16_finish(cff_crc16_update(cff_crc16_begin(), payload, payload_size_bytes));
+    cff_set_uint16_le(trailer, payload_crc);
+
+    segments[0].data = header;
+    segments[0].size_bytes = CFF_HEADER_SIZE_BYTES;
+    segments[1].data = payload;
+    segments[1].size_bytes = payload_size_bytes;
+    segments[2].data = trailer;
+    segments[2].size_bytes = CFF_PAYLOAD_CRC_SIZE_BYTES;
+
+    builder->frame_counter++;
+    CFF_STATS_ADD(builder, frames_built, 1);
+    CFF_STATS_ADD(builder, bytes_built, (uint32_t) cff_calculate_frame_size_bytes(payload_size_bytes));
+
+    return cff_error_none;
+}
+
+//! Read and validate the header offset bytes into a ring buffer's data
+static cff_error_en_t cff_ring_buffer_read_header(const cff_ring_buffer_t *ring_buffer, uint32_t offset,
+                                                  cff_header_t *header)
+{
+    if (cff_ring_buffer_available_data(ring_buffer) - offset < CFF_HEADER_SIZE_BYTES) {
         return cff_error_incomplete_frame;
     }
 
     // Peek at header data
     uint8_t header_data[CFF_HEADER_SIZE_BYTES];
-    cff_error_en_t error = cff_ring_buffer_peek(ring_buffer, header_data, 0, CFF_HEADER_SIZE_BYTES);
+    cff_error_en_t error = cff_ring_buffer_peek(ring_buffer, header_data, offset, CFF_HEADER_SIZE_BYTES);
     if (error != cff_error_none) {
         return error;
     }
 
     // Parse header
-    frame->header.preamble[0] = header_data[0];
-    frame->header.preamble[1] = header_data[1];
+    header->preamble[0] = header_data[0];
+    header->preamble[1] = header_data[1];
 
-    if (frame->header.preamble[0] != CFF_PREAMBLE_BYTE_0 || frame->header.preamble[1] != CFF_PREAMBLE_BYTE_1) {
+    if (header->preamble[0] != CFF_PREAMBLE_BYTE_0 || header->preamble[1] != CFF_PREAMBLE_BYTE_1) {
         return cff_error_invalid_preamble;
     }
 
-    frame->header.frame_counter = cff_get_uint16_le(&header_data[2]);
-    frame->header.payload_size_bytes = cff_get_uint16_le(&header_data[4]);
-    frame->header.header_crc = cff_get_uint16_le(&header_data[6]);
+    header->frame_counter = cff_get_uint16_le(&header_data[2]);
+    header->payload_size_bytes = cff_get_uint16_le(&header_data[4]);
+    header->header_crc = cff_get_uint16_le(&header_data[6]);
 
     // Validate header CRC
     uint8_t header_crc_data[6];
-    header_crc_data[0] = frame->header.preamble[0];
-    header_crc_data[1] = frame->header.preamble[1];
-    cff_set_uint16_le(&header_crc_data[2], frame->header.frame_counter);
-    cff_set_uint16_le(&header_crc_data[4], frame->header.payload_size_bytes);
+    header_crc_data[0] = header->preamble[0];
+    header_crc_data[1] = header->preamble[1];
+    cff_set_uint16_le(&header_crc_data[2], header->frame_counter);
+    cff_set_uint16_le(&header_crc_data[4], header->payload_size_bytes);
 
     uint16_t expected_crc;
     error = cff_crc16(header_crc_data, 6, &expected_crc);
     if (error != cff_error_none) {
         return error;
     }
-    if (expected_crc != frame->header.header_crc) {
+    if (expected_crc != header->header_crc) {
         return cff_error_invalid_header_crc;
     }
 
-    // Check if we have enough data for the complete frame
-    size_t expected_frame_size_bytes = cff_calculate_frame_size_bytes(frame->header.payload_size_bytes);
-    if (available < expected_frame_size_bytes) {
-        return cff_error_incomplete_frame;
+    // A frame that can never fit in the ring buffer would stall parsing forever
+    if (cff_calculate_frame_size_bytes(header->payload_size_bytes) > ring_buffer->buffer_size) {
+        return cff_error_payload_too_large;
     }
 
-    // Set up frame payload information
+    return cff_error_none;
+}
+
+//! Read the payload CRC of a complete frame offset bytes into a ring buffer's data
+static uint16_t cff_ring_buffer_read_payload_crc(const cff_ring_buffer_t *ring_buffer, uint32_t offset,
+                                                 const cff_header_t *header)
+{
+    uint8_t payload_crc_data[CFF_PAYLOAD_CRC_SIZE_BYTES];
+    cff_ring_buffer_peek(ring_buffer, payload_crc_data, offset + CFF_HEADER_SIZE_BYTES + header->payload_size_bytes,
+                         CFF_PAYLOAD_CRC_SIZE_BYTES);
+    return cff_get_uint16_le(payload_crc_data);
+}
+
+//! Fill in a frame located offset bytes into a ring buffer's data
+static void cff_frame_init(cff_frame_t *frame, const cff_ring_buffer_t *ring_buffer, uint32_t offset,
+                           const cff_header_t *header, uint16_t payload_crc)
+{
+    frame->header = *header;
+    frame->offset_bytes = offset;
     frame->ring_buffer = ring_buffer;
-    frame->payload_size_bytes = frame->header.payload_size_bytes;
+    frame->payload_size_bytes = header->payload_size_bytes;
+    frame->payload_crc = payload_crc;
 
     // Set payload_ptr to point into ring buffer
-    uint32_t payload_start = (ring_buffer->consume_index + CFF_HEADER_SIZE_BYTES) % ring_buffer->buffer_size;
+    uint32_t payload_start = cff_ring_buffer_offset_position(ring_buffer, offset + CFF_HEADER_SIZE_BYTES);
     frame->payload = &ring_buffer->buffer[payload_start];
+    frame->flags = 0;
+    if (cff_ring_buffer_is_mirrored(ring_buffer) ||
+        header->payload_size_bytes <= ring_buffer->buffer_size - payload_start) {
+        frame->flags |= CFF_FRAME_FLAG_PAYLOAD_CONTIGUOUS;
+    }
+}
 
-    // Peek at payload CRC
-    uint8_t payload_crc_data[CFF_PAYLOAD_CRC_SIZE_BYTES];
-    error = cff_ring_buffer_peek(ring_buffer, payload_crc_data, CFF_HEADER_SIZE_BYTES + frame->payload_size_bytes,
-                                 CFF_PAYLOAD_CRC_SIZE_BYTES);
+cff_error_en_t cff_parse_frame(cff_ring_buffer_t *ring_buffer, cff_frame_t *frame)
+{
+    if (ring_buffer == NULL || frame == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    // Only the header is needed to reject a bad frame, so validate it before waiting for the rest
+    cff_header_t header;
+    cff_error_en_t error = cff_ring_buffer_read_header(ring_buffer, 0, &header);
+    if (error == cff_error_incomplete_frame && cff_ring_buffer_available_data(ring_buffer) > 0) {
+        CFF_STATS_ADD(ring_buffer, incomplete_frame_stalls, 1);
+    }
+    else if (error == cff_error_invalid_header_crc || error == cff_error_payload_too_large) {
+        CFF_STATS_ADD(ring_buffer, header_crc_errors, 1);
+    }
     if (error != cff_error_none) {
         return error;
     }
 
-    frame->payload_crc = cff_get_uint16_le(payload_crc_data);
+    // Check if we have enough data for the complete frame
+    size_t expected_frame_size_bytes = cff_calculate_frame_size_bytes(header.payload_size_bytes);
+    if (cff_ring_buffer_available_data(ring_buffer) < expected_frame_size_bytes) {
+        CFF_STATS_ADD(ring_buffer, incomplete_frame_stalls, 1);
+        return cff_error_incomplete_frame;
+    }
+
+    cff_frame_init(frame, ring_buffer, 0, &header, cff_ring_buffer_read_payload_crc(ring_buffer, 0, &header));
 
     // Validate payload CRC using ring buffer CRC function
     uint16_t expected_payload_crc;
@@ -402,6 +1580,7 @@ cff_error_en_t cff_parse_frame(cff_ring_buffer_t *ring_buffer, cff_frame_t *fram
         return error;
     }
     if (expected_payload_crc != frame->payload_crc) {
+        CFF_STATS_ADD(ring_buffer, payload_crc_errors, 1);
         return cff_error_invalid_payload_crc;
     }
 
@@ -410,62 +1589,400 @@ cff_error_en_t cff_parse_frame(cff_ring_buffer_t *ring_buffer, cff_frame_t *fram
     if (error != cff_error_none) {
         return error;
     }
+    CFF_STATS_ADD(ring_buffer, frames_parsed, 1);
+
+    return cff_error_none;
+}
+
+//! Wrap data that is already in memory in a full ring buffer, so the ring buffer based validation runs over it in
+//! place. The view is only read from. It is marked mirrored because nothing in it wraps.
+static void cff_ring_buffer_init_view(cff_ring_buffer_t *ring_buffer, const uint8_t *data, uint32_t data_size_bytes)
+{
+    ring_buffer->buffer = (CFF_RB_T *) data;
+    ring_buffer->buffer_size = data_size_bytes;
+    ring_buffer->append_index = data_size_bytes;
+    ring_buffer->consume_index = 0;
+    ring_buffer->index_mask = (data_size_bytes & (data_size_bytes - 1)) == 0 ? 2 * data_size_bytes - 1 : 0;
+    ring_buffer->flags = CFF_RING_BUFFER_FLAG_MIRRORED;
+#ifdef CFF_ENABLE_STATS
+    ring_buffer->stats = NULL;
+#endif
+}
+
+cff_error_en_t cff_validate_frame(const uint8_t *data, size_t data_size_bytes, cff_frame_t *frame)
+{
+    if (data == NULL || frame == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (data_size_bytes == 0) {
+        return cff_error_incomplete_frame;
+    }
+
+    // Bytes past the largest possible frame can't be part of this one
+    cff_ring_buffer_t view;
+    uint32_t view_size_bytes =
+        (uint32_t) CFF_MIN(data_size_bytes, cff_calculate_frame_size_bytes(CFF_MAX_PAYLOAD_SIZE_BYTES));
+    cff_ring_buffer_init_view(&view, data, view_size_bytes);
+
+    cff_header_t header;
+    cff_error_en_t error = cff_ring_buffer_read_header(&view, 0, &header);
+    if (error == cff_error_payload_too_large) {
+        error = cff_error_incomplete_frame; // The view is exactly the data, so the frame runs past its end
+    }
+    if (error != cff_error_none) {
+        return error;
+    }
+
+    cff_frame_init(frame, &view, 0, &header, cff_ring_buffer_read_payload_crc(&view, 0, &header));
+    frame->ring_buffer = NULL; // The view doesn't outlive this call, and the payload never wraps
+
+    uint16_t expected_payload_crc = cff_crc16_begin();
+    if (frame->payload_size_bytes > 0) {
+        expected_payload_crc = cff_crc16_update(expected_payload_crc, frame->payload, frame->payload_size_bytes);
+    }
+    if (cff_crc16_finish(expected_payload_crc) != frame->payload_crc) {
+        return cff_error_invalid_payload_crc;
+    }
 
     return cff_error_none;
 }
 
+//! Find the first preamble in a linear buffer of any size, or return size if there is none
+static size_t cff_find_preamble_buffer(const uint8_t *data, size_t size)
+{
+    size_t start = 0;
+    for (;;) {
+        uint32_t window = (uint32_t) CFF_MIN(size - start, (size_t) CFF_RING_BUFFER_MAX_SIZE);
+        uint32_t found = cff_find_preamble_linear(&data[start], window);
+        if (found < window || start + window == size) {
+            return found < window ? start + found : size;
+        }
+        start += window - 1; // Overlap by a byte so a preamble straddling the windows is found
+    }
+}
+
+size_t cff_parse_buffer(const uint8_t *data, size_t data_size_bytes, cff_callback_ex_t callback, void *user,
+                        size_t *frames_parsed)
+{
+    size_t parsed = 0;
+    size_t position = 0;
+    size_t consumed = 0;
+
+    if (data != NULL && callback != NULL) {
+        for (;;) {
+            size_t candidate = position + cff_find_preamble_buffer(&data[position], data_size_bytes - position);
+            if (candidate >= data_size_bytes) {
+                // Like the ring buffer parser, keep a trailing first preamble byte whose partner hasn't arrived yet
+                bool keep_last = data_size_bytes > position && data[data_size_bytes - 1] == CFF_PREAMBLE_BYTE_0;
+                consumed = keep_last ? data_size_bytes - 1 : data_size_bytes;
+                break;
+            }
+
+            cff_frame_t frame;
+            cff_error_en_t error = cff_validate_frame(&data[candidate], data_size_bytes - candidate, &frame);
+            if (error == cff_error_incomplete_frame) {
+                consumed = candidate; // The rest of this frame may still arrive
+                break;
+            }
+            if (error != cff_error_none) {
+                position = candidate + CFF_PREAMBLE_SIZE_BYTES;
+                continue;
+            }
+
+            frame.offset_bytes = (uint32_t) candidate;
+            parsed++;
+            position = candidate + cff_calculate_frame_size_bytes(frame.payload_size_bytes);
+            if (callback(&frame, user) == cff_callback_stop) {
+                consumed = position;
+                break;
+            }
+        }
+    }
+
+    if (frames_parsed != NULL) {
+        *frames_parsed = parsed;
+    }
+    return consumed;
+}
+
 size_t cff_parse_frames(cff_ring_buffer_t *ring_buffer, cff_callback_t callback)
 {
-    if (ring_buffer == NULL || callback == NULL) {
+    // A frame left incomplete is validated again from scratch on the next call, use a cff_parser_t to avoid that
+    cff_parser_t parser;
+    if (cff_parser_init(&parser, ring_buffer) != cff_error_none) {
         return 0;
     }
 
-    size_t frames_parsed = 0;
-    uint32_t search_offset = 0;
+    return cff_parser_parse_frames(&parser, callback);
+}
 
-    while (cff_ring_buffer_available_data(ring_buffer) > 0) {
-        // Find the next preamble starting from current search offset
-        size_t preamble_offset = cff_ring_buffer_find_preamble(ring_buffer, search_offset);
-        uint32_t available = cff_ring_buffer_available_data(ring_buffer);
+size_t cff_parse_frames_ex(cff_ring_buffer_t *ring_buffer, cff_callback_ex_t callback, void *user)
+{
+    cff_parser_t parser;
+    if (cff_parser_init(&parser, ring_buffer) != cff_error_none) {
+        return 0;
+    }
 
-        if (preamble_offset >= available) {
-            // No more preambles found
-            break;
+    return cff_parser_parse_frames_ex(&parser, callback, user);
+}
+
+cff_error_en_t cff_parser_init(cff_parser_t *parser, cff_ring_buffer_t *ring_buffer)
+{
+    if (parser == NULL || ring_buffer == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    parser->ring_buffer = ring_buffer;
+    parser->options = 0;
+    parser->frame_counter_valid = false;
+    parser->last_frame_counter = 0;
+    parser->frames_lost = 0;
+    parser->frames_duplicated = 0;
+    parser->frames_reordered = 0;
+    return cff_parser_reset(parser);
+}
+
+cff_error_en_t cff_parser_reset(cff_parser_t *parser)
+{
+    if (parser == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    parser->state = cff_parser_state_searching;
+    parser->payload_crc = 0;
+    parser->payload_bytes_hashed = 0;
+    parser->offset = 0;
+
+    return cff_error_none;
+}
+
+//! Compare a frame's counter with the last one seen and flag it as a gap, duplicate or late frame. The counter wraps
+//! at 16 bits, so a frame up to half the counter range ahead counts as newer and anything else as older.
+static void cff_parser_track_frame_counter(cff_parser_t *parser, cff_frame_t *frame)
+{
+    uint16_t counter = frame->header.frame_counter;
+
+    if (!parser->frame_counter_valid) {
+        parser->frame_counter_valid = true;
+        parser->last_frame_counter = counter;
+        return;
+    }
+
+    uint16_t delta = (uint16_t) (counter - parser->last_frame_counter);
+    if (delta == 0) {
+        frame->flags |= CFF_FRAME_FLAG_COUNTER_DUPLICATE;
+        parser->frames_duplicated++;
+    }
+    else if (delta < 0x8000u) {
+        if (delta > 1) {
+            frame->flags |= CFF_FRAME_FLAG_COUNTER_GAP;
+            parser->frames_lost += delta - 1u;
+        }
+        parser->last_frame_counter = counter;
+    }
+    else {
+        // An older frame arriving late was counted as lost when its successor arrived
+        frame->flags |= CFF_FRAME_FLAG_COUNTER_REORDERED;
+        parser->frames_reordered++;
+        if (parser->frames_lost > 0) {
+            parser->frames_lost--;
         }
+    }
+}
+
+//! Skip bytes at the parser's offset that can't be part of a frame. Directly at the consume index they are discarded
+//! from the ring buffer, behind frames that haven't been released yet the offset moves past them instead.
+static void cff_parser_skip(cff_parser_t *parser, uint32_t number_of_items)
+{
+    CFF_STATS_ADD(parser->ring_buffer, bytes_skipped, number_of_items);
+
+    if (parser->offset == 0) {
+        cff_ring_buffer_advance(parser->ring_buffer, number_of_items);
+    }
+    else {
+        parser->offset += number_of_items;
+    }
+}
+
+//! Find the next valid frame at the parser's offset into its ring buffer. Bytes that can't be part of a frame are
+//! skipped, the frame itself is left in the ring buffer.
+static cff_error_en_t cff_parser_next_frame(cff_parser_t *parser, cff_frame_t *frame)
+{
+    cff_ring_buffer_t *ring_buffer = parser->ring_buffer;
+
+    for (;;) {
+        if (parser->state == cff_parser_state_searching) {
+            uint32_t available = cff_ring_buffer_available_data(ring_buffer) - parser->offset;
+            if (available == 0) {
+                return cff_error_incomplete_frame;
+            }
 
-        // If preamble is not at the beginning, remove bytes before it
-        if (preamble_offset > 0) {
-            cff_ring_buffer_advance(ring_buffer, (uint32_t) preamble_offset);
-            search_offset = 0; // Reset search offset since we consumed bytes
+            size_t preamble_offset = cff_ring_buffer_find_preamble(ring_buffer, parser->offset) - parser->offset;
+            if (preamble_offset >= available) {
+                // None of the scanned bytes can start a frame, so drop them instead of scanning them again on the
+                // next call. The exception is a trailing first preamble byte, whose partner may not have arrived yet.
+                uint32_t last_index = cff_ring_buffer_offset_position(ring_buffer, parser->offset + available - 1);
+                bool keep_last = ring_buffer->buffer[last_index] == CFF_PREAMBLE_BYTE_0;
+                cff_parser_skip(parser, keep_last ? available - 1 : available);
+                return cff_error_incomplete_frame;
+            }
+
+            // Bytes before the preamble can't be part of a frame
+            if (preamble_offset > 0) {
+                cff_parser_skip(parser, (uint32_t) preamble_offset);
+            }
+
+            cff_error_en_t error = cff_ring_buffer_read_header(ring_buffer, parser->offset, &parser->header);
+            if (error == cff_error_incomplete_frame) {
+                CFF_STATS_ADD(ring_buffer, incomplete_frame_stalls, 1);
+                return error;
+            }
+            if (error != cff_error_none) {
+                // False preamble or corrupted header. A preamble right where the previous frame ended was expected to
+                // start a frame, one found after skipping bytes was most likely payload or noise.
+                if (preamble_offset > 0) {
+                    CFF_STATS_ADD(ring_buffer, preamble_false_positives, 1);
+                }
+                else {
+                    CFF_STATS_ADD(ring_buffer, header_crc_errors, 1);
+                }
+
+                // Skip the preamble: its second byte can't start another preamble, so the next candidate is at least
+                // two bytes further on.
+                cff_parser_skip(parser, CFF_PREAMBLE_SIZE_BYTES);
+                continue;
+            }
+
+            parser->state = cff_parser_state_payload;
+            parser->payload_crc = cff_crc16_begin();
+            parser->payload_bytes_hashed = 0;
         }
 
-        // Check if we have enough bytes for a minimum frame
-        if (cff_ring_buffer_available_data(ring_buffer) < CFF_MIN_FRAME_SIZE_BYTES) {
-            break;
+        // Hash only the payload bytes that arrived since the last call
+        bool verify_payload = (parser->options & CFF_PARSER_OPTION_SKIP_PAYLOAD_CRC) == 0;
+        uint32_t available = cff_ring_buffer_available_data(ring_buffer) - parser->offset;
+        uint32_t payload_bytes_received =
+            CFF_MIN(available - CFF_HEADER_SIZE_BYTES, (uint32_t) parser->header.payload_size_bytes);
+        if (verify_payload && payload_bytes_received > parser->payload_bytes_hashed) {
+            parser->payload_crc =
+                cff_crc16_update_ring_buffer(ring_buffer, parser->payload_crc,
+                                             parser->offset + CFF_HEADER_SIZE_BYTES + parser->payload_bytes_hashed,
+                                             payload_bytes_received - parser->payload_bytes_hashed);
+            parser->payload_bytes_hashed = payload_bytes_received;
         }
 
-        cff_frame_t frame;
-        cff_error_en_t error = cff_parse_frame(ring_buffer, &frame);
+        if (available < cff_calculate_frame_size_bytes(parser->header.payload_size_bytes)) {
+            CFF_STATS_ADD(ring_buffer, incomplete_frame_stalls, 1);
+            return cff_error_incomplete_frame;
+        }
 
-        if (error == cff_error_none) {
-            // Successfully parsed a frame, call the callback
-            callback(&frame);
-            frames_parsed++;
-            search_offset = 0; // Reset search offset since we consumed the frame
+        uint16_t payload_crc = cff_ring_buffer_read_payload_crc(ring_buffer, parser->offset, &parser->header);
+        if (verify_payload && cff_crc16_finish(parser->payload_crc) != payload_crc) {
+            CFF_STATS_ADD(ring_buffer, payload_crc_errors, 1);
+            // Corrupted payload, resume the search just past this frame's preamble
+            parser->state = cff_parser_state_searching;
+            cff_parser_skip(parser, CFF_PREAMBLE_SIZE_BYTES);
+            continue;
         }
-        else if (error == cff_error_incomplete_frame) {
-            // Not enough data for a complete frame, stop parsing
-            break;
+
+        cff_frame_init(frame, ring_buffer, parser->offset, &parser->header, payload_crc);
+        if (!verify_payload) {
+            frame->flags |= CFF_FRAME_FLAG_PAYLOAD_UNVERIFIED;
         }
-        else {
-            // Invalid frame found, remove 1 byte and continue searching
-            cff_ring_buffer_advance(ring_buffer, 1);
-            search_offset = 0; // Reset search offset since we consumed a byte
+        cff_parser_track_frame_counter(parser, frame);
+        CFF_STATS_ADD(ring_buffer, frames_parsed, 1);
+        return cff_error_none;
+    }
+}
+
+//! A function pointer can't be passed through a void pointer portably, so plain callbacks are wrapped in a struct
+typedef struct cff_callback_adapter_t {
+    cff_callback_t callback;
+} cff_callback_adapter_t;
+
+static cff_callback_result_en_t cff_callback_adapter(const cff_frame_t *frame, void *user)
+{
+    ((const cff_callback_adapter_t *) user)->callback(frame);
+    return cff_callback_continue;
+}
+
+size_t cff_parser_parse_frames(cff_parser_t *parser, cff_callback_t callback)
+{
+    if (callback == NULL) {
+        return 0;
+    }
+
+    cff_callback_adapter_t adapter = {callback};
+    return cff_parser_parse_frames_ex(parser, cff_callback_adapter, &adapter);
+}
+
+size_t cff_parser_parse_frames_ex(cff_parser_t *parser, cff_callback_ex_t callback, void *user)
+{
+    if (parser == NULL || parser->ring_buffer == NULL || callback == NULL) {
+        return 0;
+    }
+
+    size_t frames_parsed = 0;
+    cff_frame_t frame;
+
+    while (cff_parser_next_frame(parser, &frame) == cff_error_none) {
+        // The frame is consumed only after the callback, so its payload can't be overwritten while it is in use
+        cff_callback_result_en_t result = callback(&frame, user);
+        frames_parsed++;
+
+        size_t frame_size_bytes = cff_calculate_frame_size_bytes(frame.payload_size_bytes);
+        cff_ring_buffer_advance(parser->ring_buffer, (uint32_t) frame_size_bytes);
+        parser->state = cff_parser_state_searching;
+
+        if (result == cff_callback_stop) {
+            break;
         }
     }
+
+    return frames_parsed;
+}
+
+size_t cff_parse_frames_batch(cff_ring_buffer_t *ring_buffer, cff_frame_t *frames, size_t max_frames)
+{
+    cff_parser_t parser;
+    if (frames == NULL || cff_parser_init(&parser, ring_buffer) != cff_error_none) {
+        return 0;
+    }
+
+    size_t frames_parsed = 0;
+
+    // Frames stay in the ring buffer, the parser steps over them and continues searching behind them
+    while (frames_parsed < max_frames && cff_parser_next_frame(&parser, &frames[frames_parsed]) == cff_error_none) {
+        parser.offset += (uint32_t) cff_calculate_frame_size_bytes(frames[frames_parsed].payload_size_bytes);
+        parser.state = cff_parser_state_searching;
+        frames_parsed++;
+    }
+
     return frames_parsed;
 }
 
+cff_error_en_t cff_commit_frames(cff_ring_buffer_t *ring_buffer, const cff_frame_t *frames, size_t frame_count)
+{
+    if (ring_buffer == NULL || frames == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (frame_count == 0) {
+        return cff_error_none; // Nothing to release
+    }
+
+    // Frames are returned in stream order, so releasing up to the end of the last one releases all of them
+    const cff_frame_t *last = &frames[frame_count - 1];
+    size_t end_offset = last->offset_bytes + cff_calculate_frame_size_bytes(last->payload_size_bytes);
+    if (last->ring_buffer != ring_buffer || end_offset > cff_ring_buffer_available_data(ring_buffer)) {
+        return cff_error_invalid_state;
+    }
+
+    cff_ring_buffer_advance(ring_buffer, (uint32_t) end_offset);
+    return cff_error_none;
+}
+
 cff_error_en_t cff_copy_frame_payload(const cff_frame_t *frame, uint8_t *buffer, size_t buffer_size)
 {
     if (frame == NULL || buffer == NULL) {
@@ -481,12 +1998,346 @@ cff_error_en_t cff_copy_frame_payload(const cff_frame_t *frame, uint8_t *buffer,
     }
 
     // Copy payload data from the ring buffer, handling wrap-around
-    uint32_t payload_start = (uint32_t) (frame->payload - frame->ring_buffer->buffer);
+    cff_span_t spans[CFF_PAYLOAD_SPAN_COUNT];
+    cff_error_en_t error = cff_frame_payload_spans(frame, spans);
+    if (error != cff_error_none) {
+        return error;
+    }
+
+    memcpy(buffer, spans[0].data, spans[0].size_bytes);
+    if (spans[1].size_bytes > 0) {
+        memcpy(buffer + spans[0].size_bytes, spans[1].data, spans[1].size_bytes);
+    }
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_verify_frame_payload(cff_frame_t *frame)
+{
+    cff_span_t spans[CFF_PAYLOAD_SPAN_COUNT];
+    cff_error_en_t error = cff_frame_payload_spans(frame, spans);
+    if (error != cff_error_none) {
+        return error;
+    }
+
+    uint16_t crc = cff_crc16_begin();
+    for (size_t i = 0; i < CFF_PAYLOAD_SPAN_COUNT; i++) {
+        if (spans[i].size_bytes > 0) {
+            crc = cff_crc16_update(crc, spans[i].data, spans[i].size_bytes);
+        }
+    }
+
+    if (cff_crc16_finish(crc) != frame->payload_crc) {
+        return cff_error_invalid_payload_crc;
+    }
+
+    frame->flags &= (uint8_t) ~CFF_FRAME_FLAG_PAYLOAD_UNVERIFIED;
+    return cff_error_none;
+}
 
-    for (uint32_t i = 0; i < frame->payload_size_bytes; i++) {
-        uint32_t ring_index = (payload_start + i) % frame->ring_buffer->buffer_size;
-        buffer[i] = frame->ring_buffer->buffer[ring_index];
+cff_error_en_t cff_frame_payload_spans(const cff_frame_t *frame, cff_span_t spans[CFF_PAYLOAD_SPAN_COUNT])
+{
+    if (frame == NULL || spans == NULL) {
+        return cff_error_null_pointer;
     }
 
+    spans[0].data = frame->payload;
+    spans[0].size_bytes = frame->payload_size_bytes;
+    spans[1].data = NULL;
+    spans[1].size_bytes = 0;
+
+    if (frame->flags & CFF_FRAME_FLAG_PAYLOAD_CONTIGUOUS) {
+        return cff_error_none;
+    }
+
+    if (frame->ring_buffer == NULL || frame->payload == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    // The payload runs to the end of the storage and continues from its start
+    const cff_ring_buffer_t *ring_buffer = frame->ring_buffer;
+    size_t payload_start = (size_t) (frame->payload - ring_buffer->buffer);
+    spans[0].size_bytes = ring_buffer->buffer_size - payload_start;
+    spans[1].data = ring_buffer->buffer;
+    spans[1].size_bytes = frame->payload_size_bytes - spans[0].size_bytes;
+
     return cff_error_none;
 }
+
+// Frame Pool ----------------------------------------------------------------------------------------------------------
+
+cff_error_en_t cff_frame_pool_init(cff_frame_pool_t *pool)
+{
+    if (pool == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    memset(pool, 0, sizeof(*pool));
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_frame_pool_add_class(cff_frame_pool_t *pool, cff_pooled_frame_t *slots, uint8_t *storage,
+                                        size_t slot_count, size_t payload_capacity_bytes)
+{
+    if (pool == NULL || slots == NULL || storage == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (payload_capacity_bytes > CFF_MAX_PAYLOAD_SIZE_BYTES) {
+        return cff_error_payload_too_large;
+    }
+
+    // Classes are searched in order, so the first one that fits is the smallest
+    if (pool->class_count == CFF_FRAME_POOL_MAX_CLASSES ||
+        (pool->class_count > 0 &&
+         pool->classes[pool->class_count - 1].payload_capacity_bytes >= payload_capacity_bytes)) {
+        return cff_error_invalid_state;
+    }
+
+    cff_frame_pool_class_t *size_class = &pool->classes[pool->class_count];
+    size_class->payload_capacity_bytes = payload_capacity_bytes;
+    size_class->slot_count = slot_count;
+    size_class->free_count = slot_count;
+    size_class->free_list = NULL;
+
+    // Link the slots back to front so they are handed out in array order
+    for (size_t i = slot_count; i > 0; i--) {
+        cff_pooled_frame_t *slot = &slots[i - 1];
+        memset(&slot->frame, 0, sizeof(slot->frame));
+        slot->reference_count = 0;
+        slot->class_index = (uint8_t) pool->class_count;
+        slot->pool = pool;
+        slot->storage = &storage[(i - 1) * payload_capacity_bytes];
+        slot->next_free = size_class->free_list;
+        size_class->free_list = slot;
+    }
+
+    pool->class_count++;
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_frame_pool_store(cff_frame_pool_t *pool, const cff_frame_t *frame, cff_pooled_frame_t **handle)
+{
+    if (pool == NULL || frame == NULL || handle == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    cff_span_t spans[CFF_PAYLOAD_SPAN_COUNT];
+    cff_error_en_t error = cff_frame_payload_spans(frame, spans);
+    if (error != cff_error_none) {
+        return error;
+    }
+
+    cff_pooled_frame_t *slot = NULL;
+    bool fits = false;
+
+    CFF_FRAME_POOL_LOCK(pool);
+    for (size_t i = 0; i < pool->class_count && slot == NULL; i++) {
+        cff_frame_pool_class_t *size_class = &pool->classes[i];
+        if (size_class->payload_capacity_bytes < frame->payload_size_bytes) {
+            continue;
+        }
+        fits = true;
+        if (size_class->free_list != NULL) {
+            slot = size_class->free_list;
+            size_class->free_list = slot->next_free;
+            size_class->free_count--;
+            slot->next_free = NULL;
+            slot->reference_count = 1;
+        }
+    }
+    CFF_FRAME_POOL_UNLOCK(pool);
+
+    if (slot == NULL) {
+        return fits ? cff_error_buffer_full : cff_error_payload_too_large;
+    }
+
+    // The slot belongs to the caller now, so the copy needs no lock
+    size_t offset = 0;
+    for (size_t i = 0; i < CFF_PAYLOAD_SPAN_COUNT; i++) {
+        if (spans[i].size_bytes > 0) {
+            memcpy(&slot->storage[offset], spans[i].data, spans[i].size_bytes);
+            offset += spans[i].size_bytes;
+        }
+    }
+
+    slot->frame = *frame;
+    slot->frame.payload = slot->storage;
+    slot->frame.ring_buffer = NULL;
+    slot->frame.flags |= CFF_FRAME_FLAG_PAYLOAD_CONTIGUOUS;
+    *handle = slot;
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_pooled_frame_retain(cff_pooled_frame_t *handle)
+{
+    if (handle == NULL || handle->pool == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    cff_error_en_t error = cff_error_none;
+
+    CFF_FRAME_POOL_LOCK(handle->pool);
+    if (handle->reference_count == 0) {
+        error = cff_error_invalid_state;
+    }
+    else {
+        handle->reference_count++;
+    }
+    CFF_FRAME_POOL_UNLOCK(handle->pool);
+
+    return error;
+}
+
+cff_error_en_t cff_pooled_frame_release(cff_pooled_frame_t *handle)
+{
+    if (handle == NULL || handle->pool == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    cff_frame_pool_t *pool = handle->pool;
+    cff_error_en_t error = cff_error_none;
+
+    CFF_FRAME_POOL_LOCK(pool);
+    if (handle->reference_count == 0) {
+        error = cff_error_invalid_state;
+    }
+    else if (--handle->reference_count == 0) {
+        cff_frame_pool_class_t *size_class = &pool->classes[handle->class_index];
+        handle->next_free = size_class->free_list;
+        size_class->free_list = handle;
+        size_class->free_count++;
+    }
+    CFF_FRAME_POOL_UNLOCK(pool);
+
+    return error;
+}
+
+// Transmit Queue ------------------------------------------------------------------------------------------------------
+
+cff_error_en_t cff_tx_queue_init(cff_tx_queue_t *queue, uint8_t *buffer, size_t buffer_size_bytes,
+                                 cff_tx_start_transfer_t start_transfer, void *user)
+{
+    if (queue == NULL || buffer == NULL || start_transfer == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    size_t half_size_bytes = buffer_size_bytes / 2;
+    cff_error_en_t error = cff_frame_builder_init(&queue->builder, buffer, half_size_bytes);
+    if (error != cff_error_none) {
+        return error;
+    }
+
+    queue->halves[0] = buffer;
+    queue->halves[1] = buffer + half_size_bytes;
+    queue->fill_index = 0;
+    queue->enqueue_in_progress = false;
+    queue->transfer_in_progress = false;
+    queue->start_transfer = start_transfer;
+    queue->user = user;
+    queue->frames_enqueued = 0;
+    queue->transfers_started = 0;
+
+    return cff_error_none;
+}
+
+// Hand the frames in the fill half to the DMA and carry on filling the other half. Called with the lock held, the
+// transfer is started by the caller once the lock is released.
+static bool cff_tx_queue_begin_transfer(cff_tx_queue_t *queue, cff_span_t *transfer)
+{
+    if (queue->transfer_in_progress || queue->builder.batch_size_bytes == 0) {
+        return false;
+    }
+
+    transfer->data = queue->builder.buffer;
+    transfer->size_bytes = queue->builder.batch_size_bytes;
+
+    queue->fill_index ^= 1;
+    queue->builder.buffer = queue->halves[queue->fill_index];
+    queue->builder.batch_size_bytes = 0;
+    queue->transfer_in_progress = true;
+    queue->transfers_started++;
+
+    return true;
+}
+
+cff_error_en_t cff_tx_queue_enqueue(cff_tx_queue_t *queue, const uint8_t *payload, size_t payload_size_bytes)
+{
+    if (queue == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    CFF_TX_QUEUE_LOCK(queue);
+    bool busy = queue->enqueue_in_progress;
+    queue->enqueue_in_progress = true;
+    CFF_TX_QUEUE_UNLOCK(queue);
+
+    if (busy) {
+        return cff_error_invalid_state;
+    }
+
+    // The completion interrupt leaves the fill half alone while enqueue_in_progress is set, so the frame is built
+    // without holding the lock
+    for (int attempt = 0;; attempt++) {
+        cff_error_en_t error = cff_batch_build_frame(&queue->builder, payload, payload_size_bytes);
+        cff_span_t transfer;
+
+        CFF_TX_QUEUE_LOCK(queue);
+        bool started = cff_tx_queue_begin_transfer(queue, &transfer);
+        // A full half is only left unsent by a completion that came in while building. Starting it emptied the
+        // fill half, so the frame fits now.
+        bool retry = error == cff_error_buffer_full && started && attempt == 0;
+        if (!retry) {
+            queue->enqueue_in_progress = false;
+        }
+        if (error == cff_error_none) {
+            queue->frames_enqueued++;
+        }
+        CFF_TX_QUEUE_UNLOCK(queue);
+
+        if (started) {
+            queue->start_transfer(transfer.data, transfer.size_bytes, queue->user);
+        }
+        if (!retry) {
+            return error;
+        }
+    }
+}
+
+cff_error_en_t cff_tx_queue_transfer_complete(cff_tx_queue_t *queue)
+{
+    if (queue == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    cff_error_en_t error = cff_error_none;
+    cff_span_t transfer;
+    bool started = false;
+
+    CFF_TX_QUEUE_LOCK(queue);
+    if (!queue->transfer_in_progress) {
+        error = cff_error_invalid_state;
+    }
+    else {
+        queue->transfer_in_progress = false;
+        // An enqueue in progress is still writing to the fill half and starts the transfer itself when done
+        if (!queue->enqueue_in_progress) {
+            started = cff_tx_queue_begin_transfer(queue, &transfer);
+        }
+    }
+    CFF_TX_QUEUE_UNLOCK(queue);
+
+    if (started) {
+        queue->start_transfer(transfer.data, transfer.size_bytes, queue->user);
+    }
+
+    return error;
+}
+
+bool cff_tx_queue_idle(const cff_tx_queue_t *queue)
+{
+    return queue != NULL && !queue->transfer_in_progress && queue->builder.batch_size_bytes == 0;
+}
@@ -36,6 +36,7 @@
 extern "C" {
 #endif
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -74,6 +75,39 @@ extern "C" {
 //! @brief Maximum allowed payload size in bytes
 #define CFF_MAX_PAYLOAD_SIZE_BYTES 65535
 
+//! @brief Maximum number of contiguous segments a payload in a ring buffer is split into, see cff_frame_payload_spans()
+#define CFF_PAYLOAD_SPAN_COUNT 2
+
+//! @brief Number of segments a frame is split into by cff_build_frame_segments(): header, payload, payload CRC
+#define CFF_FRAME_SEGMENT_COUNT 3
+
+//! @brief Frame flag set when the payload is stored contiguously, so payload points to all payload_size_bytes bytes
+#define CFF_FRAME_FLAG_PAYLOAD_CONTIGUOUS 0x01
+
+//! @brief Frame flag set when the payload CRC has not been checked yet, see CFF_PARSER_OPTION_SKIP_PAYLOAD_CRC and
+//! cff_verify_frame_payload()
+#define CFF_FRAME_FLAG_PAYLOAD_UNVERIFIED 0x02
+
+//! @brief Frame flag set when frames were lost between the previous frame and this one, see cff_parser_t.frames_lost
+#define CFF_FRAME_FLAG_COUNTER_GAP 0x04
+
+//! @brief Frame flag set when the frame repeats the counter of the previous frame
+#define CFF_FRAME_FLAG_COUNTER_DUPLICATE 0x08
+
+//! @brief Frame flag set when the frame's counter is older than the previous frame's, i.e. it arrived out of order
+#define CFF_FRAME_FLAG_COUNTER_REORDERED 0x10
+
+//! @brief Parser option to validate only the preamble and header CRC. The header CRC already covers the payload size,
+//! so frame boundaries stay reliable, but the payload is not hashed and frames carry CFF_FRAME_FLAG_PAYLOAD_UNVERIFIED.
+#define CFF_PARSER_OPTION_SKIP_PAYLOAD_CRC 0x01
+
+//! @brief Ring buffer flag set when the storage is mapped twice back to back, so buffer[i + buffer_size] aliases
+//! buffer[i] and any region of up to buffer_size elements is contiguous. See cff_mirror.h.
+#define CFF_RING_BUFFER_FLAG_MIRRORED 0x01
+
+//! @brief Maximum ring buffer size in elements, so that the indices can count to twice the size
+#define CFF_RING_BUFFER_MAX_SIZE 0x80000000u
+
 //! @brief Ring buffer element type (can be overridden by defining CFF_RB_T before including this header)
 #ifndef CFF_RB_T
 #define CFF_RB_T uint8_t
@@ -85,6 +119,29 @@ extern "C" {
 //! @brief Initial value for CRC16 calculation
 #define CFF_CRC_INIT 0xFFFF
 
+//! @brief Reference CRC backend, one table lookup per byte (smallest footprint, suits MCUs)
+#define CFF_CRC_BACKEND_BYTEWISE 0
+
+//! @brief Slicing-by-4 CRC backend, four table lookups per four bytes (2 KiB of tables)
+#define CFF_CRC_BACKEND_SLICING_BY_4 1
+
+//! @brief Slicing-by-8 CRC backend, eight table lookups per eight bytes (4 KiB of tables)
+#define CFF_CRC_BACKEND_SLICING_BY_8 2
+
+//! @brief Carry-less multiply folding backend (PCLMULQDQ on x86-64, PMULL on AArch64) with runtime CPU detection,
+//! falling back to slicing-by-8 when the instructions are unavailable
+#define CFF_CRC_BACKEND_CLMUL 3
+
+//! @brief CRC backend used by cff_crc16() and cff_crc16_ring_buffer() (can be overridden by defining CFF_CRC_BACKEND
+//! before including this header). Every backend up to and including the selected one is compiled in.
+#ifndef CFF_CRC_BACKEND
+#if defined(__x86_64__) || defined(_M_X64) || defined(__aarch64__)
+#define CFF_CRC_BACKEND CFF_CRC_BACKEND_CLMUL
+#else
+#define CFF_CRC_BACKEND CFF_CRC_BACKEND_BYTEWISE
+#endif
+#endif
+
 //! @brief Macro to find the minimum of two values
 #define CFF_MIN(a, b) ((a) < (b) ? (a) : (b))
 
@@ -105,8 +162,82 @@ typedef enum cff_error_en_t {
     cff_error_payload_too_large,   //!< Payload exceeds maximum allowed size
     cff_error_incomplete_frame,    //!< Frame data is incomplete
     cff_error_insufficient_space,  //!< Insufficient space for ring buffer operation
+    cff_error_not_supported,       //!< Feature is not available in this build or on this CPU
+    cff_error_out_of_memory,       //!< The operating system could not provide the requested memory
+    cff_error_invalid_state,       //!< Function called out of sequence, e.g. appending to a frame that wasn't begun
+    cff_error_buffer_full,         //!< No room left in a partly filled buffer, flush it and try again
+    cff_error_io,                  //!< The operating system could not open, read or write a file
 } cff_error_en_t;
 
+//! @brief CRC16 calculation backends
+//!
+//! All backends produce identical results. They differ only in speed and in the size of their lookup tables.
+typedef enum cff_crc_backend_en_t {
+    cff_crc_backend_bytewise = CFF_CRC_BACKEND_BYTEWISE,         //!< Byte-wise table lookup (reference)
+    cff_crc_backend_slicing_by_4 = CFF_CRC_BACKEND_SLICING_BY_4, //!< Slicing-by-4 table lookup
+    cff_crc_backend_slicing_by_8 = CFF_CRC_BACKEND_SLICING_BY_8, //!< Slicing-by-8 table lookup
+    cff_crc_backend_clmul = CFF_CRC_BACKEND_CLMUL,               //!< Carry-less multiply folding
+} cff_crc_backend_en_t;
+
+//! @brief States of a resumable parser
+typedef enum cff_parser_state_en_t {
+    cff_parser_state_searching = 0, //!< Looking for a preamble followed by a valid header
+    cff_parser_state_payload,       //!< Header validated, waiting for the rest of the payload
+} cff_parser_state_en_t;
+
+//! @brief Values returned by a cff_callback_ex_t to control parsing
+typedef enum cff_callback_result_en_t {
+    cff_callback_continue = 0, //!< Keep parsing frames
+    cff_callback_stop,         //!< Stop after this frame, leaving the remaining data in the ring buffer
+} cff_callback_result_en_t;
+
+//! @}
+
+//! @defgroup cff_stats CFF Statistics
+//! @brief Optional counters describing what the parser and builder are doing
+//! @{
+
+//! @brief Parser, ring buffer and builder counters
+//!
+//! Collected only when cff.c and all code including cff.h are built with CFF_ENABLE_STATS defined, otherwise every
+//! update compiles to nothing and the ring buffer and builder structures carry no stats pointer. Attach the same
+//! structure to a ring buffer and its builder, or one per link, with cff_ring_buffer_set_stats() and
+//! cff_frame_builder_set_stats().
+//!
+//! Counters are updated with plain increments and wrap at 32 bits, so compare snapshots by subtracting them. They
+//! aren't atomic: the fields written by a ring buffer's producer (bytes_appended, append_overflows and
+//! ring_high_water_mark) may be read mid-update by a snapshot taken on the consumer side.
+//!
+//! A noisy or failing link shows up as skipped bytes, false preambles and CRC errors, a consumer that can't keep up as
+//! append overflows and a high-water mark near the ring buffer size.
+typedef struct cff_stats_t {
+    uint32_t bytes_appended;           //!< Elements appended or committed to the ring buffer
+    uint32_t append_overflows;         //!< Appends or commits rejected because the ring buffer was too full
+    uint32_t ring_high_water_mark;     //!< Most elements stored in the ring buffer at once
+    uint32_t frames_parsed;            //!< Valid frames found by the parser
+    uint32_t bytes_skipped;            //!< Bytes discarded while searching for the next frame
+    uint32_t preamble_false_positives; //!< Preambles found after skipped bytes whose header was rejected
+    uint32_t header_crc_errors;        //!< Headers rejected where a frame was expected, for a bad CRC or a frame
+                                       //!< too large for the ring buffer
+    uint32_t payload_crc_errors;       //!< Frames with a valid header whose payload CRC didn't match
+    uint32_t incomplete_frame_stalls;  //!< Times parsing stopped to wait for the rest of a started frame
+    uint32_t frames_built;             //!< Frames completed by the builder
+    uint32_t bytes_built;              //!< Total size of the frames completed by the builder
+} cff_stats_t;
+
+//! @brief Copy a set of counters
+//!
+//! @param stats Pointer to the counters to read
+//! @param snapshot Pointer to store a copy of the counters
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_stats_snapshot(const cff_stats_t *stats, cff_stats_t *snapshot);
+
+//! @brief Set all counters to zero
+//!
+//! @param stats Pointer to the counters to clear
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_stats_reset(cff_stats_t *stats);
+
 //! @}
 
 //! @defgroup cff_ring_buffer CFF Ring Buffer
@@ -116,12 +247,27 @@ typedef enum cff_error_en_t {
 //! @brief Ring buffer structure for circular buffer operations
 //!
 //! Used to manage a circular buffer with external storage. The buffer and size are provided during initialization.
+//! The indices count from 0 to 2 * buffer_size - 1 before wrapping, so the element an index refers to is at
+//! index % buffer_size. This distinguishes a full buffer from an empty one without a separate fill level. Sizes that
+//! are a power of two wrap with a mask, other sizes with a comparison, so no index operation needs a division.
+//!
+//! A ring buffer can be shared without locks between one producer, which only calls cff_ring_buffer_append(), and one
+//! consumer, which calls everything else (consume, advance, the CRC and parsing functions), for example a UART
+//! interrupt and the main loop. Each side writes only its own index. Indices are published with release semantics and
+//! read with acquire semantics using the GCC/Clang __atomic builtins, C11 fences, or plain volatile accesses (enough on
+//! single core MCUs), in that order of preference. To use other barriers, e.g. __DMB() on a Cortex-M compiler without
+//! either, define CFF_RING_BUFFER_LOAD_ACQUIRE(index) and CFF_RING_BUFFER_STORE_RELEASE(index, value) when building
+//! cff.c. Initialization must complete before either side starts.
 typedef struct cff_ring_buffer_t {
     CFF_RB_T *buffer;       //!< Pointer to external buffer storage
     uint32_t buffer_size;   //!< Size of the buffer in elements
     uint32_t append_index;  //!< Index where next element will be appended
     uint32_t consume_index; //!< Index where next element will be consumed
-    uint32_t free_space;    //!< Number of free elements in the buffer
+    uint32_t index_mask;    //!< 2 * buffer_size - 1 if buffer_size is a power of two, otherwise 0
+    uint8_t flags;          //!< Combination of CFF_RING_BUFFER_FLAG_* values
+#ifdef CFF_ENABLE_STATS
+    cff_stats_t *stats; //!< Counters updated by the ring buffer and parser functions, or NULL
+#endif
 } cff_ring_buffer_t;
 
 //! @brief Initialize a ring buffer with external storage
@@ -131,10 +277,32 @@ typedef struct cff_ring_buffer_t {
 //!
 //! @param ring_buffer Pointer to ring buffer structure to initialize
 //! @param buffer Pointer to external buffer storage
-//! @param buffer_size Size of the buffer in elements
-//! @return cff_error_none on success, error code on failure
+//! @param buffer_size Size of the buffer in elements, at most CFF_RING_BUFFER_MAX_SIZE. Powers of two are fastest.
+//! @return cff_error_none on success, cff_error_not_supported if buffer_size is too large, error code on failure
 cff_error_en_t cff_ring_buffer_init(cff_ring_buffer_t *ring_buffer, CFF_RB_T *buffer, uint32_t buffer_size);
 
+//! @brief Attach counters to a ring buffer
+//!
+//! cff_ring_buffer_append(), cff_ring_buffer_commit() and every parser working on the ring buffer update the counters
+//! from then on. cff_ring_buffer_init() detaches them.
+//!
+//! @param ring_buffer Pointer to initialized ring buffer
+//! @param stats Pointer to the counters to update, or NULL to stop counting
+//! @return cff_error_none on success, cff_error_not_supported if built without CFF_ENABLE_STATS, error code on failure
+cff_error_en_t cff_ring_buffer_set_stats(cff_ring_buffer_t *ring_buffer, cff_stats_t *stats);
+
+//! @brief Get the number of elements stored in a ring buffer
+//!
+//! @param ring_buffer Pointer to ring buffer
+//! @return Number of elements that can be consumed, 0 if ring_buffer is NULL
+uint32_t cff_ring_buffer_available_data(const cff_ring_buffer_t *ring_buffer);
+
+//! @brief Get the number of elements that can be appended to a ring buffer
+//!
+//! @param ring_buffer Pointer to ring buffer
+//! @return Number of free elements, 0 if ring_buffer is NULL
+uint32_t cff_ring_buffer_free_space(const cff_ring_buffer_t *ring_buffer);
+
 //! @brief Append elements to the ring buffer
 //!
 //! Appends the specified number of elements to the ring buffer.
@@ -145,6 +313,30 @@ cff_error_en_t cff_ring_buffer_init(cff_ring_buffer_t *ring_buffer, CFF_RB_T *bu
 //! @return cff_error_none on success, error code on failure
 cff_error_en_t cff_ring_buffer_append(cff_ring_buffer_t *ring_buffer, const CFF_RB_T *items, uint32_t number_of_items);
 
+//! @brief Reserve the largest contiguous writable region of the ring buffer
+//!
+//! Lets a DMA controller or a read()/recv() call write directly into the ring buffer storage instead of into a staging
+//! buffer that is then appended. The region starts at the append index and ends at the consume index or the end of
+//! the storage, whichever comes first, so once it is filled and committed another reservation may return the rest of
+//! the free space from the start of the storage. Reserving doesn't change the ring buffer, and is a producer
+//! operation like cff_ring_buffer_append().
+//!
+//! @param ring_buffer Pointer to initialized ring buffer
+//! @param region Pointer to store the start of the writable region
+//! @param region_size Pointer to store the number of elements that can be written to the region
+//! @return cff_error_none on success, cff_error_insufficient_space if the ring buffer is full, error code on failure
+cff_error_en_t cff_ring_buffer_reserve(cff_ring_buffer_t *ring_buffer, CFF_RB_T **region, uint32_t *region_size);
+
+//! @brief Commit elements written into a region returned by cff_ring_buffer_reserve()
+//!
+//! Makes the first number_of_items elements of the reserved region available to the consumer.
+//!
+//! @param ring_buffer Pointer to initialized ring buffer
+//! @param number_of_items Number of elements written, at most the reserved region size
+//! @return cff_error_none on success, cff_error_insufficient_space if there isn't that much free space, error code on
+//! failure
+cff_error_en_t cff_ring_buffer_commit(cff_ring_buffer_t *ring_buffer, uint32_t number_of_items);
+
 //! @brief Consume elements from the ring buffer
 //!
 //! Consumes the specified number of elements from the ring buffer.
@@ -186,30 +378,100 @@ typedef struct cff_header_t {
 //! @brief Complete frame structure
 //!
 //! Represents a complete frame with header, payload, and payload CRC.
-//! The payload field points to the payload data in the ring buffer.
-//! Use cff_copy_frame_payload() to copy payload data to a linear buffer.
+//! The payload field points to the payload data in the ring buffer. Unless CFF_FRAME_FLAG_PAYLOAD_CONTIGUOUS is set,
+//! the payload wraps around the end of the ring buffer storage. Use cff_frame_payload_spans() to access it in place or
+//! cff_copy_frame_payload() to copy it to a linear buffer.
 typedef struct cff_frame_t {
     cff_header_t header;                  //!< Frame header
     const uint8_t *payload;               //!< Pointer to payload data
     uint16_t payload_crc;                 //!< CRC16 checksum of payload
     size_t payload_size_bytes;            //!< Size of payload in bytes
     const cff_ring_buffer_t *ring_buffer; //!< Pointer to the ring buffer
+    uint8_t flags;                        //!< Combination of CFF_FRAME_FLAG_* values
+    uint32_t offset_bytes;                //!< Offset of the frame from the ring buffer's consume index when parsed
 } cff_frame_t;
 
+//! @brief Contiguous region of memory
+typedef struct cff_span_t {
+    const uint8_t *data; //!< Pointer to the first byte
+    size_t size_bytes;   //!< Number of bytes
+} cff_span_t;
+
 //! @brief Frame builder structure for constructing frames
 //!
-//! Used to build frames into a provided buffer. Maintains state in the form of the current frame counter.
+//! Used to build frames into a provided buffer. Maintains state in the form of the current frame counter, and for
+//! frames built with cff_frame_builder_begin(), the progress of the frame under construction.
 typedef struct cff_frame_builder_t {
-    uint8_t *buffer;          //!< Buffer for frame construction
-    size_t buffer_size_bytes; //!< Size of the buffer in bytes
-    uint16_t frame_counter;   //!< Current frame counter value
+    uint8_t *buffer;              //!< Buffer for frame construction
+    size_t buffer_size_bytes;     //!< Size of the buffer in bytes
+    uint16_t frame_counter;       //!< Current frame counter value
+    bool frame_in_progress;       //!< True between cff_frame_builder_begin() and cff_frame_builder_end()
+    uint16_t payload_crc;         //!< Running CRC over the payload bytes appended so far
+    size_t payload_size_bytes;    //!< Payload size declared by cff_frame_builder_begin()
+    size_t payload_bytes_written; //!< Payload bytes appended so far
+    size_t batch_size_bytes;      //!< Bytes of buffer filled by cff_batch_build_frame()
+#ifdef CFF_ENABLE_STATS
+    cff_stats_t *stats; //!< Counters updated as frames are completed, or NULL
+#endif
 } cff_frame_builder_t;
 
+//! @brief Resumable frame parser
+//!
+//! Keeps the validated header and the running payload CRC of a partially received frame between calls to
+//! cff_parser_parse_frames(), so every received byte is hashed exactly once however the stream is chunked. Use one
+//! parser per ring buffer and don't consume from the ring buffer by other means while a frame is in progress.
+//!
+//! The parser also follows the frame counters of the link. Frames are flagged with CFF_FRAME_FLAG_COUNTER_* and the
+//! totals below give a link quality metric. A counter up to 32767 ahead of the last one counts as a gap, anything
+//! behind it as a late frame, so a late frame reduces frames_lost again. The totals are kept by cff_parser_reset()
+//! and cleared by cff_parser_init().
+typedef struct cff_parser_t {
+    cff_ring_buffer_t *ring_buffer; //!< Ring buffer frames are parsed from
+    cff_parser_state_en_t state;    //!< Current parser state
+    cff_header_t header;            //!< Header of the frame in progress, valid in cff_parser_state_payload
+    uint16_t payload_crc;           //!< Running CRC over the first payload_bytes_hashed payload bytes
+    uint32_t payload_bytes_hashed;  //!< Number of payload bytes already fed into payload_crc
+    uint32_t offset;                //!< Offset of the next candidate frame from the consume index
+    uint8_t options;                //!< Combination of CFF_PARSER_OPTION_* values, may be set after cff_parser_init()
+    bool frame_counter_valid;       //!< Whether last_frame_counter holds the counter of a received frame
+    uint16_t last_frame_counter;    //!< Newest frame counter received so far
+    uint32_t frames_lost;           //!< Number of frames missing from the counter sequence
+    uint32_t frames_duplicated;     //!< Number of frames that repeated the previous counter
+    uint32_t frames_reordered;      //!< Number of frames received after a newer one
+} cff_parser_t;
+
+//! @brief CRC provider interface
+//!
+//! Every CRC calculated by the library (cff_crc16(), cff_crc16_ring_buffer(), and therefore cff_build_frame() and
+//! cff_parse_frame()) is routed through the active provider. By default this is the software implementation selected
+//! by CFF_CRC_BACKEND, but it can be replaced with one that drives a CRC peripheral, see cff_crc_set_provider().
+//!
+//! A CRC is calculated as begin(), any number of update() calls, then finish(). The running CRC is passed in and out of
+//! each call rather than kept in the provider, so independent calculations can be interleaved. A peripheral supports
+//! this by loading the running CRC into its initial value register before each update(). The provider must implement
+//! CRC-16/CCITT-FALSE, see CFF_CRC_POLYNOMIAL and CFF_CRC_INIT.
+typedef struct cff_crc_provider_t {
+    //! @brief Return the initial running CRC
+    uint16_t (*begin)(void *context);
+    //! @brief Feed data into the running CRC and return the updated running CRC
+    uint16_t (*update)(void *context, uint16_t crc, const uint8_t *data, size_t data_size_bytes);
+    //! @brief Return the final CRC given the running CRC
+    uint16_t (*finish)(void *context, uint16_t crc);
+    void *context; //!< Passed unchanged to every call, e.g. a pointer to the peripheral's registers
+} cff_crc_provider_t;
+
 //! @brief Callback function type for frame processing
 //!
 //! @param frame Pointer to the parsed frame structure
 typedef void (*cff_callback_t)(const cff_frame_t *frame);
 
+//! @brief Callback function type for frame processing with user context
+//!
+//! @param frame Pointer to the parsed frame structure
+//! @param user User pointer passed unchanged from cff_parse_frames_ex() or cff_parser_parse_frames_ex()
+//! @return cff_callback_continue to keep parsing, cff_callback_stop to return after this frame
+typedef cff_callback_result_en_t (*cff_callback_ex_t)(const cff_frame_t *frame, void *user);
+
 //! @}
 
 //! @defgroup cff_api CFF API Functions
@@ -239,6 +501,59 @@ cff_error_en_t cff_crc16(const uint8_t *data, size_t data_size_bytes, uint16_t *
 cff_error_en_t cff_crc16_ring_buffer(const cff_ring_buffer_t *ring_buffer, uint32_t offset, size_t data_size_bytes,
                                      uint16_t *crc);
 
+//! @brief Check whether a CRC backend can be used
+//!
+//! A backend is available if it was compiled in (see CFF_CRC_BACKEND) and, for cff_crc_backend_clmul, if the CPU
+//! supports carry-less multiplication.
+//!
+//! @param backend Backend to check
+//! @return true if cff_crc16_with_backend() can use the backend
+bool cff_crc16_backend_available(cff_crc_backend_en_t backend);
+
+//! @brief Calculate CRC16 checksum for given data with a specific backend
+//!
+//! Same as cff_crc16(), but bypasses the default backend selection. Mainly useful for testing and benchmarking the
+//! backends against each other.
+//!
+//! @param backend Backend to use
+//! @param data Pointer to data buffer
+//! @param data_size_bytes Length of data in bytes
+//! @param crc Pointer to store calculated CRC value
+//! @return cff_error_none on success, cff_error_not_supported if the backend is unavailable, error code on failure
+cff_error_en_t cff_crc16_with_backend(cff_crc_backend_en_t backend, const uint8_t *data, size_t data_size_bytes,
+                                      uint16_t *crc);
+
+//! @brief Set the CRC provider used for all CRC calculations
+//!
+//! The provider is referenced, not copied, so it must remain valid until it is replaced. The provider is global, so set
+//! it once during initialization, before any thread or interrupt starts building or parsing frames.
+//!
+//! @param provider Pointer to the provider to use, or NULL to restore the built-in software implementation
+//! @return cff_error_none on success, cff_error_null_pointer if any of the provider's functions are missing
+cff_error_en_t cff_crc_set_provider(const cff_crc_provider_t *provider);
+
+//! @brief Start an incremental CRC16 calculation
+//!
+//! @return Initial running CRC, to be passed to cff_crc16_update()
+uint16_t cff_crc16_begin(void);
+
+//! @brief Feed data into an incremental CRC16 calculation
+//!
+//! Feeding a buffer in several pieces gives the same result as feeding it in one call, so discontiguous regions (such
+//! as both halves of a wrapped ring buffer) can be hashed without copying them together first.
+//!
+//! @param crc Running CRC returned by cff_crc16_begin() or a previous cff_crc16_update()
+//! @param data Pointer to data buffer
+//! @param data_size_bytes Length of data in bytes
+//! @return Updated running CRC
+uint16_t cff_crc16_update(uint16_t crc, const uint8_t *data, size_t data_size_bytes);
+
+//! @brief Finish an incremental CRC16 calculation
+//!
+//! @param crc Running CRC returned by the last cff_crc16_update()
+//! @return Final CRC value
+uint16_t cff_crc16_finish(uint16_t crc);
+
 //! @brief Initialize a frame builder
 //!
 //! Initializes a frame builder with the provided buffer and sets the frame counter to zero.
@@ -249,6 +564,15 @@ cff_error_en_t cff_crc16_ring_buffer(const cff_ring_buffer_t *ring_buffer, uint3
 //! @return cff_error_none on success, error code on failure
 cff_error_en_t cff_frame_builder_init(cff_frame_builder_t *builder, uint8_t *buffer, size_t buffer_size_bytes);
 
+//! @brief Attach counters to a frame builder
+//!
+//! Every function that completes a frame counts it from then on. cff_frame_builder_init() detaches them.
+//!
+//! @param builder Pointer to initialized frame builder
+//! @param stats Pointer to the counters to update, or NULL to stop counting
+//! @return cff_error_none on success, cff_error_not_supported if built without CFF_ENABLE_STATS, error code on failure
+cff_error_en_t cff_frame_builder_set_stats(cff_frame_builder_t *builder, cff_stats_t *stats);
+
 //! @brief Build a frame with the given payload
 //!
 //! Constructs a complete frame in the builder's buffer, including header, payload, and all required CRC checksums.
@@ -260,6 +584,99 @@ cff_error_en_t cff_frame_builder_init(cff_frame_builder_t *builder, uint8_t *buf
 //! @return cff_error_none on success, error code on failure
 cff_error_en_t cff_build_frame(cff_frame_builder_t *builder, const uint8_t *payload, size_t payload_size_bytes);
 
+//! @brief Get the payload slot of the builder's buffer for building a frame in place
+//!
+//! Returns a pointer to where the payload goes in the builder's buffer, so an encoder can serialize straight into the
+//! frame instead of into a separate buffer that cff_build_frame() then copies. Call cff_finalize_frame() with the
+//! number of bytes written to complete the frame.
+//!
+//! @param builder Pointer to initialized frame builder
+//! @param payload Pointer to store the address of the payload slot
+//! @param capacity_bytes Pointer to store the largest payload that fits in the builder's buffer
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_frame_builder_payload(cff_frame_builder_t *builder, uint8_t **payload, size_t *capacity_bytes);
+
+//! @brief Complete a frame whose payload was written in place
+//!
+//! Writes the header and payload CRC around the payload already in the slot returned by cff_frame_builder_payload().
+//! Automatically increments the frame counter.
+//!
+//! @param builder Pointer to initialized frame builder
+//! @param payload_size_bytes Number of payload bytes written to the payload slot
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_finalize_frame(cff_frame_builder_t *builder, size_t payload_size_bytes);
+
+//! @brief Append a frame to the builder's batch
+//!
+//! Builds the frame directly after the frames already in the batch, so many small frames can be sent with a single
+//! write() or DMA transfer of the region returned by cff_frame_builder_batch(). Automatically increments the frame
+//! counter. Building a frame with any of the single-frame functions discards the batch.
+//!
+//! @param builder Pointer to initialized frame builder
+//! @param payload Pointer to payload data
+//! @param payload_size_bytes Size of the payload in bytes
+//! @return cff_error_none on success, cff_error_buffer_full if the frame doesn't fit in the space left (send the batch,
+//! reset it and try again), cff_error_buffer_too_small if it wouldn't fit even in an empty buffer, error code on
+//! failure
+cff_error_en_t cff_batch_build_frame(cff_frame_builder_t *builder, const uint8_t *payload, size_t payload_size_bytes);
+
+//! @brief Get the frames batched so far
+//!
+//! @param builder Pointer to initialized frame builder
+//! @param batch Pointer to span to fill with the filled region at the start of the builder's buffer
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_frame_builder_batch(const cff_frame_builder_t *builder, cff_span_t *batch);
+
+//! @brief Empty the builder's batch, typically after it has been sent
+//!
+//! @param builder Pointer to initialized frame builder
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_frame_builder_reset_batch(cff_frame_builder_t *builder);
+
+//! @brief Begin building a frame whose payload is appended in pieces
+//!
+//! Writes the header for a payload of the given size. The payload is then added with any number of
+//! cff_frame_builder_append() calls and the frame completed with cff_frame_builder_end(). Each piece is hashed as it
+//! is appended, while it is still in cache, so the payload is never read a second time.
+//!
+//! @param builder Pointer to initialized frame builder
+//! @param payload_size_bytes Total size of the payload that will be appended
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_frame_builder_begin(cff_frame_builder_t *builder, size_t payload_size_bytes);
+
+//! @brief Append a piece of payload to the frame begun with cff_frame_builder_begin()
+//!
+//! @param builder Pointer to frame builder with a frame in progress
+//! @param data Pointer to payload data, may be NULL if data_size_bytes is 0
+//! @param data_size_bytes Size of the piece in bytes
+//! @return cff_error_none on success, cff_error_payload_too_large if the declared payload size would be exceeded,
+//! cff_error_invalid_state if no frame is in progress, error code on failure
+cff_error_en_t cff_frame_builder_append(cff_frame_builder_t *builder, const uint8_t *data, size_t data_size_bytes);
+
+//! @brief Complete the frame begun with cff_frame_builder_begin()
+//!
+//! Writes the payload CRC. Automatically increments the frame counter.
+//!
+//! @param builder Pointer to frame builder with a frame in progress
+//! @return cff_error_none on success, cff_error_incomplete_frame if less payload than declared has been appended,
+//! cff_error_invalid_state if no frame is in progress, error code on failure
+cff_error_en_t cff_frame_builder_end(cff_frame_builder_t *builder);
+
+//! @brief Build the header and payload CRC of a frame whose payload stays in place
+//!
+//! Writes only the header and payload CRC into the builder's buffer, so the payload is neither copied nor has to fit
+//! in the buffer. The frame is returned as header, payload and payload CRC segments, ready for writev(), chained DMA
+//! descriptors or any other scatter-gather transfer. The header and payload CRC segments point into the builder's
+//! buffer and are valid until the next frame is built. Automatically increments the frame counter.
+//!
+//! @param builder Pointer to initialized frame builder
+//! @param payload Pointer to payload data, may be NULL if payload_size_bytes is 0
+//! @param payload_size_bytes Size of the payload in bytes
+//! @param segments Array of CFF_FRAME_SEGMENT_COUNT spans to fill, to be transmitted in order
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_build_frame_segments(cff_frame_builder_t *builder, const uint8_t *payload, size_t payload_size_bytes,
+                                        cff_span_t segments[CFF_FRAME_SEGMENT_COUNT]);
+
 //! @brief Parse a single frame from ring buffer
 //!
 //! Attempts to parse a complete frame from the provided ring buffer.
@@ -271,6 +688,35 @@ cff_error_en_t cff_build_frame(cff_frame_builder_t *builder, const uint8_t *payl
 //! @return cff_error_none on success, error code on failure
 cff_error_en_t cff_parse_frame(cff_ring_buffer_t *ring_buffer, cff_frame_t *frame);
 
+//! @brief Validate a frame at the start of a linear buffer
+//!
+//! Performs the same checks as cff_parse_frame() on data that is already contiguous in memory, without copying it
+//! into a ring buffer. The frame's payload points into data and is always contiguous. Its ring_buffer is NULL.
+//!
+//! @param data Start of the frame
+//! @param data_size_bytes Number of bytes available from data onwards
+//! @param frame Pointer to frame structure to fill
+//! @return cff_error_none on success, cff_error_incomplete_frame if the header is valid but the frame runs past the
+//!         end of data, error code on failure
+cff_error_en_t cff_validate_frame(const uint8_t *data, size_t data_size_bytes, cff_frame_t *frame);
+
+//! @brief Parse all frames in a linear buffer in place
+//!
+//! For input that is already contiguous in memory, such as a datagram, a USB transfer or a mapped file. Frames are
+//! validated with cff_validate_frame() and delivered without copying the data into a ring buffer. Garbage and
+//! corrupted frames are skipped exactly as cff_parse_frames() would. Parsing stops at a frame that runs past the end
+//! of data or when the callback returns cff_callback_stop. The frames' offset_bytes is their offset from data.
+//!
+//! @param data Input data
+//! @param data_size_bytes Number of bytes in data
+//! @param callback Callback function to call for each parsed frame
+//! @param user User pointer passed unchanged to the callback
+//! @param frames_parsed Receives the number of frames parsed, may be NULL
+//! @return Number of bytes consumed. Bytes after that, an incomplete frame or a trailing first preamble byte, should
+//!         be kept and parsed again together with the data that follows them.
+size_t cff_parse_buffer(const uint8_t *data, size_t data_size_bytes, cff_callback_ex_t callback, void *user,
+                        size_t *frames_parsed);
+
 //! @brief Parse multiple frames from ring buffer
 //!
 //! Continuously parses frames from the ring buffer, calling the provided callback function for each successfully
@@ -281,6 +727,81 @@ cff_error_en_t cff_parse_frame(cff_ring_buffer_t *ring_buffer, cff_frame_t *fram
 //! @return Number of frames successfully parsed
 size_t cff_parse_frames(cff_ring_buffer_t *ring_buffer, cff_callback_t callback);
 
+//! @brief Parse multiple frames from ring buffer with a user context
+//!
+//! Same as cff_parse_frames(), but passes a user pointer to the callback and lets the callback stop parsing early,
+//! e.g. when the consumer's queue is full. The frame for which the callback returned cff_callback_stop is consumed,
+//! any following data is left in the ring buffer for the next call.
+//!
+//! @param ring_buffer Pointer to ring buffer containing frame data
+//! @param callback Callback function to call for each parsed frame
+//! @param user User pointer passed unchanged to the callback
+//! @return Number of frames successfully parsed
+size_t cff_parse_frames_ex(cff_ring_buffer_t *ring_buffer, cff_callback_ex_t callback, void *user);
+
+//! @brief Initialize a resumable parser
+//!
+//! @param parser Pointer to parser structure
+//! @param ring_buffer Pointer to ring buffer frames will be parsed from
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_parser_init(cff_parser_t *parser, cff_ring_buffer_t *ring_buffer);
+
+//! @brief Discard the frame in progress
+//!
+//! Must be called if the ring buffer is flushed or consumed by other means while the parser has a frame in progress.
+//!
+//! @param parser Pointer to initialized parser
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_parser_reset(cff_parser_t *parser);
+
+//! @brief Parse multiple frames from the parser's ring buffer
+//!
+//! Same as cff_parse_frames(), but a frame that is still incomplete when the call returns is resumed on the next
+//! call instead of being validated again from its first byte. The cost of a call is therefore proportional to the
+//! number of bytes received since the previous call rather than to the size of the frame in progress. Each frame is
+//! consumed from the ring buffer after the callback returns.
+//!
+//! @param parser Pointer to initialized parser
+//! @param callback Callback function to call for each parsed frame
+//! @return Number of frames successfully parsed
+size_t cff_parser_parse_frames(cff_parser_t *parser, cff_callback_t callback);
+
+//! @brief Parse multiple frames from the parser's ring buffer with a user context
+//!
+//! Combines cff_parser_parse_frames() and cff_parse_frames_ex().
+//!
+//! @param parser Pointer to initialized parser
+//! @param callback Callback function to call for each parsed frame
+//! @param user User pointer passed unchanged to the callback
+//! @return Number of frames successfully parsed
+size_t cff_parser_parse_frames_ex(cff_parser_t *parser, cff_callback_ex_t callback, void *user);
+
+//! @brief Parse a batch of frames without consuming them
+//!
+//! Validates up to max_frames frames and fills in a descriptor for each, in stream order. Bytes in front of the
+//! first frame that can't be part of a frame are discarded, but the frames themselves and everything between them
+//! stay in the ring buffer, so the payloads remain valid until the frames are released with cff_commit_frames().
+//! Calling this again before committing returns the same frames. Each frame's offset_bytes is its position
+//! relative to the consume index.
+//!
+//! @param ring_buffer Pointer to ring buffer containing frame data
+//! @param frames Array receiving the frame descriptors
+//! @param max_frames Capacity of frames
+//! @return Number of frames written to frames
+size_t cff_parse_frames_batch(cff_ring_buffer_t *ring_buffer, cff_frame_t *frames, size_t max_frames);
+
+//! @brief Release frames returned by cff_parse_frames_batch()
+//!
+//! Consumes everything up to the end of the last frame in one step. The ring buffer must not have been consumed
+//! by other means since the batch was parsed. Releasing only a prefix of a batch is allowed.
+//!
+//! @param ring_buffer Pointer to ring buffer the frames were parsed from
+//! @param frames Frames returned by cff_parse_frames_batch()
+//! @param frame_count Number of frames to release, counted from the start of the batch
+//! @return cff_error_none on success, cff_error_invalid_state if the frames are no longer in the ring buffer, error
+//!         code on failure
+cff_error_en_t cff_commit_frames(cff_ring_buffer_t *ring_buffer, const cff_frame_t *frames, size_t frame_count);
+
 //! @brief Copy frame payload data to a linear buffer
 //!
 //! Copies the payload data from a parsed frame (which may span ring buffer boundaries)
@@ -292,6 +813,201 @@ size_t cff_parse_frames(cff_ring_buffer_t *ring_buffer, cff_callback_t callback)
 //! @return cff_error_none on success, error code on failure
 cff_error_en_t cff_copy_frame_payload(const cff_frame_t *frame, uint8_t *buffer, size_t buffer_size);
 
+//! @brief Check the payload CRC of a parsed frame
+//!
+//! Completes the validation of a frame parsed with CFF_PARSER_OPTION_SKIP_PAYLOAD_CRC. The payload must still be in
+//! the ring buffer. On success CFF_FRAME_FLAG_PAYLOAD_UNVERIFIED is cleared.
+//!
+//! @param frame Pointer to parsed frame structure
+//! @return cff_error_none if the payload matches its CRC, cff_error_invalid_payload_crc if not, error code on failure
+cff_error_en_t cff_verify_frame_payload(cff_frame_t *frame);
+
+//! @brief Get the payload of a parsed frame as contiguous segments
+//!
+//! Gives in-place access to a payload that may wrap around the end of the ring buffer storage, without copying it.
+//! The first span starts at frame->payload. The second span continues from the start of the storage and is empty
+//! (size_bytes 0) when CFF_FRAME_FLAG_PAYLOAD_CONTIGUOUS is set. The spans are valid until the frame's data is
+//! overwritten in the ring buffer.
+//!
+//! @param frame Pointer to parsed frame structure
+//! @param spans Array of CFF_PAYLOAD_SPAN_COUNT spans to fill
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_frame_payload_spans(const cff_frame_t *frame, cff_span_t spans[CFF_PAYLOAD_SPAN_COUNT]);
+
+//! @}
+
+//! @defgroup cff_frame_pool CFF Frame Pool
+//! @brief Fixed-size slots for keeping frames after the ring buffer has moved on
+//! @{
+
+//! @brief Maximum number of size classes in a frame pool (can be overridden by defining it before including this
+//! header)
+#ifndef CFF_FRAME_POOL_MAX_CLASSES
+#define CFF_FRAME_POOL_MAX_CLASSES 2
+#endif
+
+//! @brief Bytes of payload storage needed by a size class of slot_count slots of payload_capacity_bytes each
+#define CFF_FRAME_POOL_STORAGE_SIZE_BYTES(slot_count, payload_capacity_bytes) ((slot_count) * (payload_capacity_bytes))
+
+struct cff_frame_pool_t;
+
+//! @brief Pool slot holding a copy of a frame, handed out as a reference-counted handle
+typedef struct cff_pooled_frame_t {
+    cff_frame_t frame;                    //!< The stored frame, its payload contiguous in the slot's storage
+    uint32_t reference_count;             //!< Number of holders, the slot is free at 0
+    uint8_t class_index;                  //!< Size class the slot belongs to
+    struct cff_frame_pool_t *pool;        //!< Pool the slot belongs to
+    struct cff_pooled_frame_t *next_free; //!< Next free slot of the same class, while free
+    uint8_t *storage;                     //!< Payload storage of the slot
+} cff_pooled_frame_t;
+
+//! @brief Slots of one payload capacity
+typedef struct cff_frame_pool_class_t {
+    size_t payload_capacity_bytes; //!< Largest payload a slot of this class holds
+    size_t slot_count;             //!< Number of slots
+    size_t free_count;             //!< Number of slots currently free
+    cff_pooled_frame_t *free_list; //!< First free slot
+} cff_frame_pool_class_t;
+
+//! @brief Pool of frame slots in caller-provided storage
+//!
+//! Keeps validated frames for later processing without malloc. A frame is copied once, from the callback, into the
+//! smallest slot that fits it, or into a larger one when those are all in use. Storing and releasing take constant
+//! time (one step per size class), and a pool can't fragment since slots are fixed-size.
+//!
+//! A pool is not thread safe by itself. To release handles from another thread or an interrupt than the one storing
+//! frames, define CFF_FRAME_POOL_LOCK(pool) and CFF_FRAME_POOL_UNLOCK(pool) when building cff.c, e.g. to take a mutex
+//! or disable interrupts; every change to the pool happens between them.
+typedef struct cff_frame_pool_t {
+    cff_frame_pool_class_t classes[CFF_FRAME_POOL_MAX_CLASSES]; //!< Size classes, smallest capacity first
+    size_t class_count;                                         //!< Number of size classes added
+} cff_frame_pool_t;
+
+//! @brief Initialize an empty frame pool
+//!
+//! @param pool Pointer to pool structure
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_frame_pool_init(cff_frame_pool_t *pool);
+
+//! @brief Add a size class of slots to a pool
+//!
+//! Classes must be added in order of increasing capacity, e.g. many small slots for telemetry and a few for the
+//! largest frames the link carries.
+//!
+//! @param pool Pointer to initialized pool
+//! @param slots Array of slot_count slot structures
+//! @param storage Payload storage of CFF_FRAME_POOL_STORAGE_SIZE_BYTES(slot_count, payload_capacity_bytes) bytes
+//! @param slot_count Number of slots in the class
+//! @param payload_capacity_bytes Largest payload a slot holds, at most CFF_MAX_PAYLOAD_SIZE_BYTES
+//! @return cff_error_none on success, cff_error_invalid_state if the pool already has CFF_FRAME_POOL_MAX_CLASSES
+//!         classes or one at least as large, cff_error_payload_too_large if payload_capacity_bytes exceeds
+//!         CFF_MAX_PAYLOAD_SIZE_BYTES, error code on failure
+cff_error_en_t cff_frame_pool_add_class(cff_frame_pool_t *pool, cff_pooled_frame_t *slots, uint8_t *storage,
+                                        size_t slot_count, size_t payload_capacity_bytes);
+
+//! @brief Copy a parsed frame into a pool slot
+//!
+//! Copies the header fields and the payload, which may wrap in the ring buffer, so the frame stays valid after the
+//! callback returns. The copy's payload is contiguous (CFF_FRAME_FLAG_PAYLOAD_CONTIGUOUS) and its ring_buffer is
+//! NULL, so cff_frame_payload_spans(), cff_copy_frame_payload() and cff_verify_frame_payload() work on it as usual.
+//!
+//! @param pool Pointer to pool
+//! @param frame Frame to copy, e.g. the one passed to a parse callback
+//! @param handle Receives the slot, with a reference count of 1
+//! @return cff_error_none on success, cff_error_payload_too_large if no class can hold the payload,
+//!         cff_error_buffer_full if every slot that could is in use, error code on failure
+cff_error_en_t cff_frame_pool_store(cff_frame_pool_t *pool, const cff_frame_t *frame, cff_pooled_frame_t **handle);
+
+//! @brief Add a holder to a pooled frame, e.g. before queueing it to a second consumer
+//!
+//! @param handle Slot returned by cff_frame_pool_store()
+//! @return cff_error_none on success, cff_error_invalid_state if the slot is free, error code on failure
+cff_error_en_t cff_pooled_frame_retain(cff_pooled_frame_t *handle);
+
+//! @brief Drop a holder of a pooled frame, returning the slot to its class when it was the last
+//!
+//! @param handle Slot returned by cff_frame_pool_store()
+//! @return cff_error_none on success, cff_error_invalid_state if the slot is already free, error code on failure
+cff_error_en_t cff_pooled_frame_release(cff_pooled_frame_t *handle);
+
+//! @}
+
+//! @defgroup cff_tx_queue CFF Transmit Queue
+//! @brief Double-buffered frame transmission driven by DMA completion
+//! @{
+
+//! @brief Start sending a region, e.g. by programming a DMA channel
+//!
+//! Called with no lock held, from cff_tx_queue_enqueue() when the link is idle or from
+//! cff_tx_queue_transfer_complete() when more frames are waiting. The region stays untouched until the transfer is
+//! reported complete.
+//!
+//! @param data First byte to send
+//! @param data_size_bytes Number of bytes to send, one or more whole frames
+//! @param user User pointer passed unchanged from cff_tx_queue_init()
+typedef void (*cff_tx_start_transfer_t)(const uint8_t *data, size_t data_size_bytes, void *user);
+
+//! @brief Transmit queue over two halves of a caller-provided buffer
+//!
+//! Frames are built into one half, with frame counters assigned in the order they are enqueued, while the other half
+//! is being sent. An idle link starts sending a frame at once; frames enqueued while a transfer is in flight are
+//! packed back to back (see cff_batch_build_frame()) and go out together as the next transfer, as soon as the DMA-done
+//! interrupt calls cff_tx_queue_transfer_complete(). A busy link therefore sends in transfers of up to half the
+//! buffer without gaps between frames, and the producer never waits for the DMA unless both halves are full.
+//!
+//! Enqueueing must happen from one context at a time. cff_tx_queue_transfer_complete() may interrupt it: the state
+//! both share is only changed between CFF_TX_QUEUE_LOCK(queue) and CFF_TX_QUEUE_UNLOCK(queue), which are empty unless
+//! defined when building cff.c, e.g. to disable the DMA interrupt, and frames are built outside them.
+typedef struct cff_tx_queue_t {
+    cff_frame_builder_t builder;            //!< Builds into the half being filled, holds the next frame counter
+    uint8_t *halves[2];                     //!< The two halves of the buffer
+    uint8_t fill_index;                     //!< Half frames are being added to
+    bool enqueue_in_progress;               //!< Set while a frame is being built into the fill half
+    bool transfer_in_progress;              //!< Set between starting a transfer and its completion
+    cff_tx_start_transfer_t start_transfer; //!< Starts sending a region
+    void *user;                             //!< User pointer passed to start_transfer
+    uint32_t frames_enqueued;               //!< Number of frames accepted
+    uint32_t transfers_started;             //!< Number of transfers started, fewer than frames when coalescing
+} cff_tx_queue_t;
+
+//! @brief Initialize a transmit queue
+//!
+//! @param queue Pointer to queue structure
+//! @param buffer Buffer split into two halves, each the largest transfer and the largest frame that can be enqueued
+//! @param buffer_size_bytes Size of buffer, at least 2 * CFF_MIN_FRAME_SIZE_BYTES
+//! @param start_transfer Function starting a transfer
+//! @param user User pointer passed unchanged to start_transfer
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_tx_queue_init(cff_tx_queue_t *queue, uint8_t *buffer, size_t buffer_size_bytes,
+                                 cff_tx_start_transfer_t start_transfer, void *user);
+
+//! @brief Build a frame around a copy of payload and queue it for sending
+//!
+//! Starts a transfer if the link is idle, otherwise the frame goes out with the next one.
+//!
+//! @param queue Pointer to initialized queue
+//! @param payload Pointer to payload data
+//! @param payload_size_bytes Size of the payload in bytes
+//! @return cff_error_none on success, cff_error_buffer_full if the fill half has no room left while the other is
+//!         being sent (try again after the next completion), cff_error_buffer_too_small if the frame is larger than a
+//!         half, cff_error_invalid_state if called while another enqueue is in progress, error code on failure
+cff_error_en_t cff_tx_queue_enqueue(cff_tx_queue_t *queue, const uint8_t *payload, size_t payload_size_bytes);
+
+//! @brief Report that the transfer in flight has finished, typically from the DMA-done interrupt
+//!
+//! Starts the next transfer with every frame queued since the last one, unless an enqueue is in progress, in which
+//! case that enqueue starts it.
+//!
+//! @param queue Pointer to initialized queue
+//! @return cff_error_none on success, cff_error_invalid_state if no transfer was in flight, error code on failure
+cff_error_en_t cff_tx_queue_transfer_complete(cff_tx_queue_t *queue);
+
+//! @brief Check whether every queued frame has been sent
+//!
+//! @param queue Pointer to initialized queue
+//! @return True if no transfer is in flight and no frames are waiting
+bool cff_tx_queue_idle(const cff_tx_queue_t *queue);
+
 //! @}
 
 //! @defgroup cff_inline CFF Inline Functions
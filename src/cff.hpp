@@ -0,0 +1,583 @@
+// MIT License
+
+// Copyright (c) 2025 Richard Keelan
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _CFF_HPP_
+#define _CFF_HPP_
+
+//! @file cff.hpp
+//! @brief Header-only C++20 wrapper around the Compact Frame Format C API
+//!
+//! Thin, allocation-free and exception-free types over cff.h, so it suits the same targets. Errors are reported as
+//! cff_error_en_t values, exactly as by the C functions underneath. cff.c must still be compiled and linked.
+
+#if __cplusplus < 202002L && (!defined(_MSVC_LANG) || _MSVC_LANG < 202002L)
+#error "cff.hpp requires C++20"
+#endif
+
+#include "cff.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace cff {
+
+//! @defgroup cff_cpp CFF C++ Wrapper
+//! @brief Header-only C++ types over the C API
+//! @{
+
+//! @brief Error codes, the same values the C API returns
+using Error = cff_error_en_t;
+
+//! @brief Ring buffer element type, CFF_RB_T
+using Element = CFF_RB_T;
+
+//! @brief Payload of a parsed frame, as up to two contiguous spans
+//!
+//! A payload that wraps around the end of the ring buffer storage is split in two, see cff_frame_payload_spans(). The
+//! view refers to the ring buffer's storage, so it is valid only as long as the frame is.
+class PayloadView {
+  public:
+    PayloadView() = default;
+
+    PayloadView(std::span<const std::uint8_t> first, std::span<const std::uint8_t> second) noexcept
+        : first_(first), second_(second)
+    {
+    }
+
+    //! @brief Part of the payload up to the end of the ring buffer storage, or all of it
+    std::span<const std::uint8_t> first() const noexcept
+    {
+        return first_;
+    }
+
+    //! @brief Part of the payload from the start of the storage, empty unless the payload wraps
+    std::span<const std::uint8_t> second() const noexcept
+    {
+        return second_;
+    }
+
+    //! @brief Whether the whole payload is in first()
+    bool contiguous() const noexcept
+    {
+        return second_.empty();
+    }
+
+    std::size_t size() const noexcept
+    {
+        return first_.size() + second_.size();
+    }
+
+    bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    std::uint8_t operator[](std::size_t index) const noexcept
+    {
+        return index < first_.size() ? first_[index] : second_[index - first_.size()];
+    }
+
+    //! @brief Copy the payload to a linear buffer
+    //!
+    //! @param buffer Destination, at least size() bytes
+    //! @return cff_error_none on success, cff_error_buffer_too_small if buffer is too small
+    Error copy_to(std::span<std::uint8_t> buffer) const noexcept
+    {
+        if (buffer.size() < size()) {
+            return cff_error_buffer_too_small;
+        }
+        if (!first_.empty()) {
+            std::memcpy(buffer.data(), first_.data(), first_.size());
+        }
+        if (!second_.empty()) {
+            std::memcpy(buffer.data() + first_.size(), second_.data(), second_.size());
+        }
+        return cff_error_none;
+    }
+
+  private:
+    std::span<const std::uint8_t> first_;
+    std::span<const std::uint8_t> second_;
+};
+
+//! @brief Parsed frame, a view of a cff_frame_t
+//!
+//! Valid until the frame's data is consumed from the ring buffer, which for frames handed to a parse handler is when
+//! the handler returns.
+class Frame {
+  public:
+    explicit Frame(const cff_frame_t &frame) noexcept : frame_(&frame)
+    {
+    }
+
+    std::uint16_t frame_counter() const noexcept
+    {
+        return frame_->header.frame_counter;
+    }
+
+    //! @brief Combination of CFF_FRAME_FLAG_* values
+    std::uint8_t flags() const noexcept
+    {
+        return frame_->flags;
+    }
+
+    //! @brief Offset of the frame from the ring buffer's consume index, or from the start of a parsed buffer
+    std::uint32_t offset_bytes() const noexcept
+    {
+        return frame_->offset_bytes;
+    }
+
+    PayloadView payload() const noexcept
+    {
+        cff_span_t spans[CFF_PAYLOAD_SPAN_COUNT];
+        if (cff_frame_payload_spans(frame_, spans) != cff_error_none) {
+            return {};
+        }
+        return {{spans[0].data, spans[0].size_bytes}, {spans[1].data, spans[1].size_bytes}};
+    }
+
+    //! @brief Underlying C frame, for the C API
+    const cff_frame_t &get() const noexcept
+    {
+        return *frame_;
+    }
+
+  private:
+    const cff_frame_t *frame_;
+};
+
+//! @brief Ring buffer with N elements of storage inside the object
+//!
+//! The capacity is a compile-time constant, so it is checked against the C API's limits when the type is instantiated
+//! and the storage needs no separate allocation. available(), free_space(), reserve(), commit() and advance() are
+//! inline and wrap indices with a constant mask, or a compare against a constant for other sizes, instead of reading
+//! the ring buffer's size at run time. The rest, and the parsers, go through the C API. The object refers to its own
+//! storage, so it can't be copied or moved. The same single producer, single consumer rules as for cff_ring_buffer_t
+//! apply.
+//!
+//! @tparam N Capacity in elements. Powers of two are fastest, see cff_ring_buffer_init().
+template <std::size_t N>
+class RingBuffer {
+    static_assert(N >= CFF_MIN_FRAME_SIZE_BYTES, "a ring buffer must be able to hold the smallest frame");
+    static_assert(N <= CFF_RING_BUFFER_MAX_SIZE, "ring buffer capacity exceeds CFF_RING_BUFFER_MAX_SIZE");
+
+  public:
+    //! @brief Capacity in elements
+    static constexpr std::size_t capacity = N;
+
+    //! @brief Whether index arithmetic uses a mask rather than a comparison
+    static constexpr bool power_of_two = (N & (N - 1)) == 0;
+
+    //! @brief Whether the largest possible frame fits, so that no valid frame is rejected as too large
+    static constexpr bool holds_any_frame = N >= CFF_MAX_PAYLOAD_SIZE_BYTES + CFF_MIN_FRAME_SIZE_BYTES;
+
+    RingBuffer() noexcept
+    {
+        cff_ring_buffer_init(&ring_buffer_, storage_.data(), static_cast<std::uint32_t>(N));
+    }
+
+    RingBuffer(const RingBuffer &) = delete;
+    RingBuffer &operator=(const RingBuffer &) = delete;
+
+    //! @brief Append all of items, see cff_ring_buffer_append()
+    Error append(std::span<const Element> items) noexcept
+    {
+        if (items.size() > N) {
+            return cff_error_insufficient_space;
+        }
+        return cff_ring_buffer_append(&ring_buffer_, items.data(), static_cast<std::uint32_t>(items.size()));
+    }
+
+    //! @brief Largest contiguous writable region, empty if the ring buffer is full, see cff_ring_buffer_reserve()
+    std::span<Element> reserve() noexcept
+    {
+        std::size_t position = index_position(ring_buffer_.append_index);
+        return {storage_.data() + position, std::min(free_space(), N - position)};
+    }
+
+    //! @brief Publish elements written into the region returned by reserve(), see cff_ring_buffer_commit()
+    Error commit(std::size_t count) noexcept
+    {
+#ifdef CFF_ENABLE_STATS
+        // The C API keeps the counters
+        if (ring_buffer_.stats != nullptr) {
+            if (count > N) {
+                return cff_error_insufficient_space;
+            }
+            return cff_ring_buffer_commit(&ring_buffer_, static_cast<std::uint32_t>(count));
+        }
+#endif
+        if (count > free_space()) {
+            return cff_error_insufficient_space;
+        }
+        store_release(ring_buffer_.append_index, index_add(ring_buffer_.append_index, count));
+        return cff_error_none;
+    }
+
+    //! @brief Copy items.size() elements out and consume them, see cff_ring_buffer_consume()
+    Error consume(std::span<Element> items) noexcept
+    {
+        if (items.size() > N) {
+            return cff_error_insufficient_space;
+        }
+        return cff_ring_buffer_consume(&ring_buffer_, items.data(), static_cast<std::uint32_t>(items.size()));
+    }
+
+    //! @brief Discard count elements, see cff_ring_buffer_advance()
+    Error advance(std::size_t count) noexcept
+    {
+        if (count > available()) {
+            return cff_error_insufficient_space;
+        }
+        store_release(ring_buffer_.consume_index, index_add(ring_buffer_.consume_index, count));
+        return cff_error_none;
+    }
+
+    //! @brief Number of elements available, see cff_ring_buffer_available_data()
+    std::size_t available() const noexcept
+    {
+        // Either side may be asking, so both indices are read as the other side's
+        std::uint32_t append_index = load_acquire(ring_buffer_.append_index);
+        std::uint32_t consume_index = load_acquire(ring_buffer_.consume_index);
+        if constexpr (power_of_two) {
+            return (append_index - consume_index) & index_mask;
+        }
+        else {
+            return append_index >= consume_index ? append_index - consume_index
+                                                 : append_index + index_range - consume_index;
+        }
+    }
+
+    //! @brief Number of elements that can be appended, see cff_ring_buffer_free_space()
+    std::size_t free_space() const noexcept
+    {
+        return N - available();
+    }
+
+    //! @brief Underlying C ring buffer, for the C API
+    cff_ring_buffer_t *get() noexcept
+    {
+        return &ring_buffer_;
+    }
+
+    const cff_ring_buffer_t *get() const noexcept
+    {
+        return &ring_buffer_;
+    }
+
+  private:
+    // The indices run from 0 to 2 * N - 1, as in the C implementation, which this mirrors with N folded in. N is at
+    // most 2^31, and below that when it isn't a power of two, so the range and the mask fit in 32 bits.
+    static constexpr std::uint32_t index_range = static_cast<std::uint32_t>(2 * N);
+    static constexpr std::uint32_t index_mask = static_cast<std::uint32_t>(2 * N - 1);
+
+    // count is at most N, checked against the free space or available data by the caller
+    static std::uint32_t index_add(std::uint32_t index, std::size_t count) noexcept
+    {
+        auto items = static_cast<std::uint32_t>(count);
+        if constexpr (power_of_two) {
+            return (index + items) & index_mask;
+        }
+        else {
+            return index >= index_range - items ? index - (index_range - items) : index + items;
+        }
+    }
+
+    static std::size_t index_position(std::uint32_t index) noexcept
+    {
+        if constexpr (power_of_two) {
+            return index & (index_mask >> 1);
+        }
+        else {
+            return index >= N ? index - N : index;
+        }
+    }
+
+    // The same ordering as CFF_RING_BUFFER_LOAD_ACQUIRE() and CFF_RING_BUFFER_STORE_RELEASE() in cff.c, so the inline
+    // operations and the C API can be mixed on one ring buffer
+    static std::uint32_t load_acquire(const std::uint32_t &index) noexcept
+    {
+        return std::atomic_ref<std::uint32_t>(const_cast<std::uint32_t &>(index)).load(std::memory_order_acquire);
+    }
+
+    static void store_release(std::uint32_t &index, std::uint32_t value) noexcept
+    {
+        std::atomic_ref<std::uint32_t>(index).store(value, std::memory_order_release);
+    }
+
+    std::array<Element, N> storage_;
+    cff_ring_buffer_t ring_buffer_;
+};
+
+//! @brief Frame builder over a caller-provided buffer
+//!
+//! Each build writes a complete frame at the start of the buffer, which frame() returns until the next build.
+class FrameBuilder {
+  public:
+    //! @brief Wrap buffer, which must hold at least CFF_MIN_FRAME_SIZE_BYTES bytes, otherwise every build fails
+    explicit FrameBuilder(std::span<std::uint8_t> buffer) noexcept
+    {
+        cff_frame_builder_init(&builder_, buffer.data(), buffer.size());
+    }
+
+    FrameBuilder(const FrameBuilder &) = delete;
+    FrameBuilder &operator=(const FrameBuilder &) = delete;
+
+    //! @brief Build a frame around a copy of payload, see cff_build_frame()
+    Error build(std::span<const std::uint8_t> payload) noexcept
+    {
+        return completed(cff_build_frame(&builder_, payload.data(), payload.size()), payload.size());
+    }
+
+    //! @brief Space for a payload to be written in place and then completed with finalize()
+    std::span<std::uint8_t> payload_buffer() noexcept
+    {
+        std::uint8_t *payload = nullptr;
+        std::size_t capacity_bytes = 0;
+        if (cff_frame_builder_payload(&builder_, &payload, &capacity_bytes) != cff_error_none) {
+            return {};
+        }
+        return {payload, capacity_bytes};
+    }
+
+    //! @brief Complete a frame whose payload was written to payload_buffer(), see cff_finalize_frame()
+    Error finalize(std::size_t payload_size_bytes) noexcept
+    {
+        return completed(cff_finalize_frame(&builder_, payload_size_bytes), payload_size_bytes);
+    }
+
+    //! @brief Start a frame whose payload is appended in pieces, see cff_frame_builder_begin()
+    Error begin(std::size_t payload_size_bytes) noexcept
+    {
+        frame_size_bytes_ = 0;
+        return cff_frame_builder_begin(&builder_, payload_size_bytes);
+    }
+
+    //! @brief Append the next piece of the payload, see cff_frame_builder_append()
+    Error append(std::span<const std::uint8_t> data) noexcept
+    {
+        return cff_frame_builder_append(&builder_, data.data(), data.size());
+    }
+
+    //! @brief Complete the frame started with begin(), see cff_frame_builder_end()
+    Error end() noexcept
+    {
+        return completed(cff_frame_builder_end(&builder_), builder_.payload_size_bytes);
+    }
+
+    //! @brief The last frame built, empty if the last build failed
+    std::span<const std::uint8_t> frame() const noexcept
+    {
+        return {builder_.buffer, frame_size_bytes_};
+    }
+
+    //! @brief Counter the next frame will carry
+    std::uint16_t frame_counter() const noexcept
+    {
+        return builder_.frame_counter;
+    }
+
+    void set_frame_counter(std::uint16_t frame_counter) noexcept
+    {
+        builder_.frame_counter = frame_counter;
+    }
+
+    //! @brief Underlying C builder, for the C API
+    cff_frame_builder_t *get() noexcept
+    {
+        return &builder_;
+    }
+
+  private:
+    Error completed(Error error, std::size_t payload_size_bytes) noexcept
+    {
+        frame_size_bytes_ = error == cff_error_none ? cff_calculate_frame_size_bytes(payload_size_bytes) : 0;
+        return error;
+    }
+
+    cff_frame_builder_t builder_{};
+    std::size_t frame_size_bytes_ = 0;
+};
+
+//! @cond INTERNAL
+namespace detail {
+
+//! Call a handler with a frame and translate its result: void or true continue, false or cff_callback_stop stop
+template <typename Handler>
+bool invoke_handler(Handler &handler, const Frame &frame)
+{
+    using Result = std::invoke_result_t<Handler &, const Frame &>;
+    if constexpr (std::is_void_v<Result>) {
+        std::invoke(handler, frame);
+        return true;
+    }
+    else if constexpr (std::is_same_v<Result, cff_callback_result_en_t>) {
+        return std::invoke(handler, frame) == cff_callback_continue;
+    }
+    else {
+        static_assert(std::is_convertible_v<Result, bool>, "a handler returns void, bool or cff_callback_result_en_t");
+        return static_cast<bool>(std::invoke(handler, frame));
+    }
+}
+
+//! Passed as the C callback's user pointer, which can't point to a const object or a function
+template <typename Handler>
+struct HandlerHolder {
+    Handler &handler;
+};
+
+template <typename Handler>
+cff_callback_result_en_t trampoline(const cff_frame_t *frame, void *user)
+{
+    HandlerHolder<Handler> *holder = static_cast<HandlerHolder<Handler> *>(user);
+    return invoke_handler(holder->handler, Frame(*frame)) ? cff_callback_continue : cff_callback_stop;
+}
+
+} // namespace detail
+//! @endcond
+
+//! @brief Number of frames cff::parse() validates before handing them to the handler
+inline constexpr std::size_t parse_batch_size = 16;
+
+//! @brief Parse all complete frames in a ring buffer, calling handler for each
+//!
+//! Does what cff_parse_frames() does, but without a function pointer: frames are validated in batches with
+//! cff_parse_frames_batch(), handed to the handler in a loop the compiler can inline it into, then released together
+//! with cff_commit_frames(). Bytes after the last frame that can't start one are discarded on the next call. Like
+//! cff_parse_frames(), an incomplete frame is validated again from scratch on the next call, use cff::Parser to avoid
+//! that.
+//!
+//! @param ring_buffer C ring buffer to parse
+//! @param handler Callable taking a const cff::Frame &. Returning false or cff_callback_stop stops after that frame,
+//!        leaving the rest in the ring buffer.
+//! @return Number of frames handed to the handler
+template <typename Handler>
+std::size_t parse(cff_ring_buffer_t &ring_buffer, Handler &&handler)
+{
+    std::array<cff_frame_t, parse_batch_size> frames;
+    std::size_t frames_parsed = 0;
+
+    for (;;) {
+        std::size_t count = cff_parse_frames_batch(&ring_buffer, frames.data(), frames.size());
+        std::size_t handled = 0;
+        bool keep_going = true;
+        while (handled < count && keep_going) {
+            keep_going = detail::invoke_handler(handler, Frame(frames[handled]));
+            handled++;
+        }
+
+        if (handled > 0) {
+            cff_commit_frames(&ring_buffer, frames.data(), handled);
+        }
+        frames_parsed += handled;
+
+        if (!keep_going || count < frames.size()) {
+            return frames_parsed;
+        }
+    }
+}
+
+//! @copydoc parse(cff_ring_buffer_t &, Handler &&)
+template <std::size_t N, typename Handler>
+std::size_t parse(RingBuffer<N> &ring_buffer, Handler &&handler)
+{
+    return parse(*ring_buffer.get(), std::forward<Handler>(handler));
+}
+
+//! @brief Parse all complete frames in a linear buffer in place, see cff_parse_buffer()
+//!
+//! @param data Input data
+//! @param handler Callable taking a const cff::Frame &, as for cff::parse()
+//! @return Number of bytes consumed, the rest should be kept for the next call
+template <typename Handler>
+std::size_t parse(std::span<const std::uint8_t> data, Handler &&handler)
+{
+    using Stored = std::remove_reference_t<Handler>;
+    detail::HandlerHolder<Stored> holder{handler};
+    return cff_parse_buffer(data.data(), data.size(), detail::trampoline<Stored>, &holder, nullptr);
+}
+
+//! @brief Resumable parser over a ring buffer, see cff_parser_t
+//!
+//! Keeps the state of an incomplete frame between calls, so every byte is hashed once however the data is chunked.
+//! The C parser calls the handler through a function pointer, to a trampoline the handler is inlined into.
+class Parser {
+  public:
+    explicit Parser(cff_ring_buffer_t &ring_buffer) noexcept
+    {
+        cff_parser_init(&parser_, &ring_buffer);
+    }
+
+    template <std::size_t N>
+    explicit Parser(RingBuffer<N> &ring_buffer) noexcept : Parser(*ring_buffer.get())
+    {
+    }
+
+    Parser(const Parser &) = delete;
+    Parser &operator=(const Parser &) = delete;
+
+    //! @brief Parse all complete frames, see cff_parser_parse_frames_ex()
+    //!
+    //! @param handler Callable taking a const cff::Frame &, as for cff::parse()
+    //! @return Number of frames handed to the handler
+    template <typename Handler>
+    std::size_t parse(Handler &&handler)
+    {
+        using Stored = std::remove_reference_t<Handler>;
+        detail::HandlerHolder<Stored> holder{handler};
+        return cff_parser_parse_frames_ex(&parser_, detail::trampoline<Stored>, &holder);
+    }
+
+    //! @brief Forget an incomplete frame, see cff_parser_reset()
+    Error reset() noexcept
+    {
+        return cff_parser_reset(&parser_);
+    }
+
+    //! @brief Underlying C parser, for its options and counters
+    cff_parser_t *get() noexcept
+    {
+        return &parser_;
+    }
+
+    const cff_parser_t *get() const noexcept
+    {
+        return &parser_;
+    }
+
+  private:
+    cff_parser_t parser_;
+};
+
+//! @}
+
+} // namespace cff
+
+#endif // _CFF_HPP_
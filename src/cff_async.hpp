@@ -0,0 +1,234 @@
+// MIT License
+
+// Copyright (c) 2025 Richard Keelan
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _CFF_ASYNC_HPP_
+#define _CFF_ASYNC_HPP_
+
+//! @file cff_async.hpp
+//! @brief C++20 coroutine interface for receiving frames
+//!
+//! A coroutine co_awaits the next frame of a link instead of registering a callback. The I/O side writes received
+//! data with reserve() and commit(), from whatever event loop it runs (epoll, io_uring, asio): the awaitable needs no
+//! executor of its own.
+
+#include "cff.hpp"
+
+#include <coroutine>
+#include <optional>
+
+namespace cff {
+
+//! @addtogroup cff_cpp
+//! @{
+
+//! @brief Link whose frames are received by co_awaiting next_frame()
+//!
+//! Pairs a ring buffer with a cff::Parser. commit() runs the parser only if a coroutine is waiting, and resumes it
+//! only when a complete, validated frame is found, so partial data costs the hashing of the new bytes and no resume.
+//! The coroutine is resumed inline, on the thread calling commit(), from inside the parser callback: the frame stays
+//! in the ring buffer until the coroutine suspends again, and several frames received in one commit are handed over
+//! one after another without returning to the event loop. While no coroutine is waiting, data accumulates in the
+//! ring buffer and reserve() eventually returns an empty span, which is the backpressure to the I/O side.
+//!
+//! A stream is not thread safe. Commit to it and run its coroutine on one thread, or one strand, at a time; many
+//! streams can share a thread. Destroy the stream only when no coroutine is waiting on it.
+class FrameStream {
+  public:
+    //! @brief Awaitable returned by next_frame()
+    //!
+    //! co_await yields the next frame, or std::nullopt once the stream is closed and every complete frame has been
+    //! delivered. The frame is valid until the coroutine suspends again.
+    class Awaiter {
+      public:
+        explicit Awaiter(FrameStream &stream) noexcept : stream_(stream)
+        {
+        }
+
+        bool await_ready() const noexcept
+        {
+            return stream_.ended_;
+        }
+
+        void await_suspend(std::coroutine_handle<> waiter)
+        {
+            // The coroutine may be resumed, and this awaiter destroyed, before wait() returns
+            stream_.wait(waiter);
+        }
+
+        std::optional<Frame> await_resume() const noexcept
+        {
+            if (stream_.frame_ready_) {
+                return Frame(stream_.frame_);
+            }
+            return std::nullopt;
+        }
+
+      private:
+        FrameStream &stream_;
+    };
+
+    explicit FrameStream(cff_ring_buffer_t &ring_buffer) noexcept : ring_buffer_(ring_buffer), parser_(ring_buffer)
+    {
+    }
+
+    template <std::size_t N>
+    explicit FrameStream(RingBuffer<N> &ring_buffer) noexcept : FrameStream(*ring_buffer.get())
+    {
+    }
+
+    FrameStream(const FrameStream &) = delete;
+    FrameStream &operator=(const FrameStream &) = delete;
+
+    //! @brief Wait for the next complete frame
+    Awaiter next_frame() noexcept
+    {
+        return Awaiter(*this);
+    }
+
+    //! @brief Largest contiguous writable region for received data, see cff_ring_buffer_reserve()
+    std::span<Element> reserve() noexcept
+    {
+        Element *region = nullptr;
+        std::uint32_t region_size = 0;
+        if (cff_ring_buffer_reserve(&ring_buffer_, &region, &region_size) != cff_error_none) {
+            return {};
+        }
+        return {region, region_size};
+    }
+
+    //! @brief Publish count elements written to the region returned by reserve(), and hand complete frames to the
+    //!        waiting coroutine
+    Error commit(std::size_t count)
+    {
+        if (count > CFF_RING_BUFFER_MAX_SIZE) {
+            return cff_error_insufficient_space;
+        }
+        Error error = cff_ring_buffer_commit(&ring_buffer_, static_cast<std::uint32_t>(count));
+        if (error == cff_error_none) {
+            deliver();
+        }
+        return error;
+    }
+
+    //! @brief Copy received data in, for I/O that can't write to reserve() directly, then deliver as commit() does
+    Error append(std::span<const Element> items)
+    {
+        if (items.size() > CFF_RING_BUFFER_MAX_SIZE) {
+            return cff_error_insufficient_space;
+        }
+        Error error = cff_ring_buffer_append(&ring_buffer_, items.data(), static_cast<std::uint32_t>(items.size()));
+        if (error == cff_error_none) {
+            deliver();
+        }
+        return error;
+    }
+
+    //! @brief Mark the end of the input
+    //!
+    //! Frames already complete are still delivered, then the waiting coroutine and every later co_await get
+    //! std::nullopt. An incomplete frame at the end is dropped.
+    void close()
+    {
+        closed_ = true;
+        deliver();
+    }
+
+    bool closed() const noexcept
+    {
+        return closed_;
+    }
+
+    //! @brief Free space for received data, which grows again once the coroutine has taken more frames
+    std::size_t free_space() const noexcept
+    {
+        return cff_ring_buffer_free_space(&ring_buffer_);
+    }
+
+    //! @brief Whether a coroutine is suspended in next_frame()
+    bool waiting() const noexcept
+    {
+        return static_cast<bool>(waiter_);
+    }
+
+    //! @brief Number of times a waiting coroutine was resumed with a frame
+    std::size_t frames_delivered() const noexcept
+    {
+        return frames_delivered_;
+    }
+
+    //! @brief The parser, for its options and link quality counters
+    Parser &parser() noexcept
+    {
+        return parser_;
+    }
+
+  private:
+    void wait(std::coroutine_handle<> waiter)
+    {
+        waiter_ = waiter;
+        frame_ready_ = false;
+        // Called from inside deliver() when the coroutine it resumed waits again, which then carries on parsing
+        if (!delivering_) {
+            deliver();
+        }
+    }
+
+    void deliver()
+    {
+        if (!waiter_ || delivering_) {
+            return;
+        }
+
+        delivering_ = true;
+        parser_.parse([this](const Frame &frame) {
+            frame_ = frame.get();
+            frame_ready_ = true;
+            frames_delivered_++;
+            std::exchange(waiter_, nullptr).resume();
+            frame_ready_ = false;
+            // Leave the rest in the ring buffer unless the coroutine is waiting for another frame already
+            return waiter_ ? cff_callback_continue : cff_callback_stop;
+        });
+        delivering_ = false;
+
+        if (waiter_ && closed_) {
+            ended_ = true;
+            std::exchange(waiter_, nullptr).resume();
+        }
+    }
+
+    cff_ring_buffer_t &ring_buffer_;
+    Parser parser_;
+    std::coroutine_handle<> waiter_;
+    cff_frame_t frame_{};
+    std::size_t frames_delivered_ = 0;
+    bool frame_ready_ = false;
+    bool delivering_ = false;
+    bool closed_ = false;
+    bool ended_ = false;
+};
+
+//! @}
+
+} // namespace cff
+
+#endif // _CFF_ASYNC_HPP_
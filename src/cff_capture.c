@@ -0,0 +1,428 @@
+// MIT License
+
+// Copyright (c) 2025 Richard Keelan
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if defined(__linux__) || defined(__unix__)
+#define _POSIX_C_SOURCE 200809L // O_CLOEXEC, posix_madvise
+#endif
+
+#include "cff_capture.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__unix__)
+#define CFF_CAPTURE_POSIX 1
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//! Size of the chunks a capture is split into
+#define CFF_CAPTURE_CHUNK_SIZE_BYTES (1024u * 1024u)
+
+//! Number of chunks per thread validated before they are stitched, which bounds the memory used for a large capture
+#define CFF_CAPTURE_CHUNKS_PER_THREAD 4
+
+//! A frame validated by a thread, enough to hand it out later without validating it again
+typedef struct cff_capture_frame_t {
+    uint64_t offset_bytes;
+    cff_header_t header;
+    uint16_t payload_crc;
+} cff_capture_frame_t;
+
+//! Frames found by following the stream from the start of a chunk
+typedef struct cff_capture_chunk_t {
+    uint64_t start;
+    uint64_t end;
+    cff_capture_frame_t *frames;
+    size_t frame_count;
+    size_t frame_capacity;
+    bool incomplete;            // The frames end with a frame that runs past the end of the capture
+    uint64_t incomplete_offset; // Offset of that frame
+    cff_error_en_t error;
+} cff_capture_chunk_t;
+
+typedef struct cff_capture_job_t {
+    const uint8_t *data;
+    uint64_t data_size_bytes;
+    cff_capture_chunk_t *chunks;
+    size_t chunk_count;
+    size_t next_chunk;
+} cff_capture_job_t;
+
+// Scanning -----------------------------------------------------------------------------------------------------------
+
+//! Find the first preamble starting in [position, end), or return end if there is none
+static uint64_t cff_capture_find_preamble(const uint8_t *data, uint64_t data_size_bytes, uint64_t position,
+                                          uint64_t end)
+{
+    while (position < end) {
+        size_t size = (size_t) (end - position);
+        const uint8_t *found = (const uint8_t *) memchr(&data[position], CFF_PREAMBLE_BYTE_0, size);
+        if (found == NULL) {
+            return end;
+        }
+        position = (uint64_t) (found - data);
+        if (position + 1 < data_size_bytes && data[position + 1] == CFF_PREAMBLE_BYTE_1) {
+            return position;
+        }
+        position++;
+    }
+    return end;
+}
+
+static size_t cff_capture_frame_size_bytes(const cff_capture_frame_t *frame)
+{
+    return cff_calculate_frame_size_bytes(frame->header.payload_size_bytes);
+}
+
+static bool cff_capture_chunk_push(cff_capture_chunk_t *chunk, uint64_t offset_bytes, const cff_frame_t *frame)
+{
+    if (chunk->frame_count == chunk->frame_capacity) {
+        size_t capacity = chunk->frame_capacity == 0 ? 256 : 2 * chunk->frame_capacity;
+        cff_capture_frame_t *frames =
+            (cff_capture_frame_t *) realloc(chunk->frames, capacity * sizeof(cff_capture_frame_t));
+        if (frames == NULL) {
+            return false;
+        }
+        chunk->frames = frames;
+        chunk->frame_capacity = capacity;
+    }
+
+    cff_capture_frame_t *entry = &chunk->frames[chunk->frame_count++];
+    entry->offset_bytes = offset_bytes;
+    entry->header = frame->header;
+    entry->payload_crc = frame->payload_crc;
+    return true;
+}
+
+//! Follow the stream from the start of a chunk the way the serial parser would: skip past the preamble of anything
+//! that doesn't validate, past the whole frame of anything that does
+static void cff_capture_scan_chunk(const cff_capture_job_t *job, cff_capture_chunk_t *chunk)
+{
+    uint64_t position = chunk->start;
+    for (;;) {
+        position = cff_capture_find_preamble(job->data, job->data_size_bytes, position, chunk->end);
+        if (position >= chunk->end) {
+            return;
+        }
+
+        cff_frame_t frame;
+        cff_error_en_t error =
+            cff_validate_frame(&job->data[position], (size_t) (job->data_size_bytes - position), &frame);
+        if (error == cff_error_none) {
+            if (!cff_capture_chunk_push(chunk, position, &frame)) {
+                chunk->error = cff_error_out_of_memory;
+                return;
+            }
+            position += cff_calculate_frame_size_bytes(frame.payload_size_bytes);
+        }
+        else if (error == cff_error_incomplete_frame) {
+            chunk->incomplete = true;
+            chunk->incomplete_offset = position;
+            return;
+        }
+        else {
+            position += CFF_PREAMBLE_SIZE_BYTES;
+        }
+    }
+}
+
+static void *cff_capture_worker_main(void *argument)
+{
+    cff_capture_job_t *job = (cff_capture_job_t *) argument;
+    for (;;) {
+#if defined(CFF_CAPTURE_POSIX)
+        size_t index = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+#else
+        size_t index = job->next_chunk++;
+#endif
+        if (index >= job->chunk_count) {
+            return NULL;
+        }
+        cff_capture_scan_chunk(job, &job->chunks[index]);
+    }
+}
+
+//! Scan all chunks of a job on thread_count threads, including the calling one
+static cff_error_en_t cff_capture_scan_chunks(cff_capture_job_t *job, size_t thread_count)
+{
+    job->next_chunk = 0;
+
+#if defined(CFF_CAPTURE_POSIX)
+    pthread_t threads[CFF_CAPTURE_MAX_THREADS];
+    size_t threads_started = 0;
+    while (threads_started + 1 < thread_count &&
+           pthread_create(&threads[threads_started], NULL, cff_capture_worker_main, job) == 0) {
+        threads_started++;
+    }
+    cff_capture_worker_main(job);
+    for (size_t i = 0; i < threads_started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+#else
+    (void) thread_count;
+    cff_capture_worker_main(job);
+#endif
+
+    for (size_t i = 0; i < job->chunk_count; i++) {
+        if (job->chunks[i].error != cff_error_none) {
+            return job->chunks[i].error;
+        }
+    }
+    return cff_error_none;
+}
+
+// Stitching ----------------------------------------------------------------------------------------------------------
+
+typedef struct cff_capture_output_t {
+    const uint8_t *data;
+    cff_capture_callback_t callback;
+    void *user;
+    uint64_t frames_parsed;
+    bool stopped;
+} cff_capture_output_t;
+
+static void cff_capture_emit(cff_capture_output_t *output, uint64_t offset_bytes, const cff_header_t *header,
+                             uint16_t payload_crc)
+{
+    cff_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.header = *header;
+    frame.payload = &output->data[offset_bytes + CFF_HEADER_SIZE_BYTES];
+    frame.payload_crc = payload_crc;
+    frame.payload_size_bytes = header->payload_size_bytes;
+    frame.flags = CFF_FRAME_FLAG_PAYLOAD_CONTIGUOUS;
+
+    output->frames_parsed++;
+    if (output->callback(&frame, offset_bytes, output->user) == cff_callback_stop) {
+        output->stopped = true;
+    }
+}
+
+//! Deliver the frames of a chunk that lie on the serial path, which starts at *position. Where that position falls
+//! inside a frame the chunk scan accepted, the scan took a different path, so parse serially until both paths meet.
+static void cff_capture_stitch_chunk(const cff_capture_job_t *job, const cff_capture_chunk_t *chunk,
+                                     uint64_t *position, cff_capture_output_t *output)
+{
+    uint64_t pos = *position;
+    size_t next = 0;
+
+    while (pos < chunk->end && !output->stopped) {
+        while (next < chunk->frame_count && chunk->frames[next].offset_bytes < pos) {
+            next++;
+        }
+
+        // Every preamble between the end of a scanned frame and the next scanned frame failed to validate, so from
+        // anywhere in between the serial parser takes the same path
+        bool aligned = next == 0 || chunk->frames[next - 1].offset_bytes +
+                                            cff_capture_frame_size_bytes(&chunk->frames[next - 1]) <=
+                                        pos;
+        if (next == chunk->frame_count && chunk->incomplete && pos > chunk->incomplete_offset) {
+            aligned = false; // The scan stopped at the incomplete frame and never looked past it
+        }
+
+        if (aligned) {
+            for (; next < chunk->frame_count && !output->stopped; next++) {
+                const cff_capture_frame_t *frame = &chunk->frames[next];
+                cff_capture_emit(output, frame->offset_bytes, &frame->header, frame->payload_crc);
+                pos = frame->offset_bytes + cff_capture_frame_size_bytes(frame);
+            }
+            if (chunk->incomplete) {
+                output->stopped = true; // The serial parser would wait for the rest of this frame forever
+                break;
+            }
+            pos = pos > chunk->end ? pos : chunk->end;
+            break;
+        }
+
+        uint64_t candidate = cff_capture_find_preamble(job->data, job->data_size_bytes, pos, chunk->end);
+        if (candidate >= chunk->end) {
+            pos = chunk->end;
+            break;
+        }
+
+        cff_frame_t frame;
+        cff_error_en_t error =
+            cff_validate_frame(&job->data[candidate], (size_t) (job->data_size_bytes - candidate), &frame);
+        if (error == cff_error_none) {
+            cff_capture_emit(output, candidate, &frame.header, frame.payload_crc);
+            pos = candidate + cff_calculate_frame_size_bytes(frame.payload_size_bytes);
+        }
+        else if (error == cff_error_incomplete_frame) {
+            output->stopped = true;
+        }
+        else {
+            pos = candidate + CFF_PREAMBLE_SIZE_BYTES;
+        }
+    }
+
+    *position = pos;
+}
+
+cff_error_en_t cff_capture_parse(const uint8_t *data, uint64_t data_size_bytes, size_t thread_count,
+                                 cff_capture_callback_t callback, void *user, uint64_t *frames_parsed)
+{
+    if (frames_parsed != NULL) {
+        *frames_parsed = 0;
+    }
+
+    if ((data == NULL && data_size_bytes > 0) || callback == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (thread_count == 0 || thread_count > CFF_CAPTURE_MAX_THREADS) {
+        return cff_error_not_supported;
+    }
+
+    size_t chunks_per_round = thread_count * CFF_CAPTURE_CHUNKS_PER_THREAD;
+    cff_capture_chunk_t *chunks = (cff_capture_chunk_t *) calloc(chunks_per_round, sizeof(cff_capture_chunk_t));
+    if (chunks == NULL) {
+        return cff_error_out_of_memory;
+    }
+
+    cff_capture_job_t job = {data, data_size_bytes, chunks, 0, 0};
+    cff_capture_output_t output = {data, callback, user, 0, false};
+    cff_error_en_t error = cff_error_none;
+    uint64_t position = 0;
+    uint64_t round_start = 0;
+
+    while (round_start < data_size_bytes && !output.stopped) {
+        // Split the next part of the capture into chunks, keeping the frame arrays of the previous round
+        job.chunk_count = 0;
+        while (job.chunk_count < chunks_per_round && round_start < data_size_bytes) {
+            cff_capture_chunk_t *chunk = &chunks[job.chunk_count++];
+            uint64_t size = data_size_bytes - round_start;
+            chunk->start = round_start;
+            chunk->end = round_start + (size < CFF_CAPTURE_CHUNK_SIZE_BYTES ? size : CFF_CAPTURE_CHUNK_SIZE_BYTES);
+            chunk->frame_count = 0;
+            chunk->incomplete = false;
+            chunk->error = cff_error_none;
+            round_start = chunk->end;
+        }
+
+        error = cff_capture_scan_chunks(&job, thread_count);
+        if (error != cff_error_none) {
+            break;
+        }
+
+        for (size_t i = 0; i < job.chunk_count && !output.stopped; i++) {
+            if (position < chunks[i].end) {
+                cff_capture_stitch_chunk(&job, &chunks[i], &position, &output);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < chunks_per_round; i++) {
+        free(chunks[i].frames);
+    }
+    free(chunks);
+
+    if (frames_parsed != NULL) {
+        *frames_parsed = output.frames_parsed;
+    }
+    return error;
+}
+
+// Capture Files ------------------------------------------------------------------------------------------------------
+
+#if defined(CFF_CAPTURE_POSIX)
+
+bool cff_capture_supported(void)
+{
+    return true;
+}
+
+cff_error_en_t cff_capture_open(cff_capture_t *capture, const char *path)
+{
+    if (capture == NULL || path == NULL) {
+        return cff_error_null_pointer;
+    }
+    memset(capture, 0, sizeof(*capture));
+    capture->fd = -1;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return cff_error_io;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        close(fd);
+        return cff_error_io;
+    }
+
+    // An empty file can't be mapped, but parses fine as a capture without frames
+    void *mapping = NULL;
+    if (status.st_size > 0) {
+        mapping = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            close(fd);
+            return cff_error_io;
+        }
+        // The capture is read front to back by each thread
+        posix_madvise(mapping, (size_t) status.st_size, POSIX_MADV_SEQUENTIAL);
+    }
+
+    capture->data = (const uint8_t *) mapping;
+    capture->size_bytes = (uint64_t) status.st_size;
+    capture->fd = fd;
+    return cff_error_none;
+}
+
+cff_error_en_t cff_capture_close(cff_capture_t *capture)
+{
+    if (capture == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (capture->size_bytes > 0) {
+        munmap((void *) capture->data, (size_t) capture->size_bytes);
+    }
+    if (capture->fd >= 0) {
+        close(capture->fd);
+    }
+    memset(capture, 0, sizeof(*capture));
+    capture->fd = -1;
+    return cff_error_none;
+}
+
+#else
+
+bool cff_capture_supported(void)
+{
+    return false;
+}
+
+cff_error_en_t cff_capture_open(cff_capture_t *capture, const char *path)
+{
+    (void) path;
+    return capture == NULL ? cff_error_null_pointer : cff_error_not_supported;
+}
+
+cff_error_en_t cff_capture_close(cff_capture_t *capture)
+{
+    return capture == NULL ? cff_error_null_pointer : cff_error_not_supported;
+}
+
+#endif
@@ -0,0 +1,114 @@
+//! @file cff_capture.h
+//! @brief Parallel parser for recorded capture files
+//! @author Richard Keelan
+//! @date 2025
+//! @copyright MIT License
+//!
+//! Parses a capture that is entirely in memory, typically a file mapped with cff_capture_open(), on several threads.
+//! The capture is split into chunks and each thread validates the frames of a chunk with cff_validate_frame(),
+//! following them from the chunk start the way the serial parser would. The chunks are then stitched together in order:
+//! where a chunk's frames don't line up with the end of the previous chunk's last frame, the mismatching part is
+//! parsed again serially until both agree. The frames delivered, and the garbage and corrupted frames skipped, are
+//! exactly those of streaming the capture through a cff_parser_t. Available on POSIX hosts. Unlike the core library,
+//! this module allocates memory and starts threads.
+
+// MIT License
+
+// Copyright (c) 2025 Richard Keelan
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _CFF_CAPTURE_H_
+#define _CFF_CAPTURE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "cff.h"
+
+//! @defgroup cff_capture CFF Capture Files
+//! @brief Memory-mapped, parallel parsing of recorded streams
+//! @{
+
+//! @brief Maximum number of threads used by cff_capture_parse()
+#define CFF_CAPTURE_MAX_THREADS 64
+
+//! @brief Callback function type for frames parsed from a capture
+//!
+//! Called on the thread that called cff_capture_parse(), in stream order.
+//!
+//! @param frame Pointer to the parsed frame structure, its payload points into the capture
+//! @param offset_bytes Offset of the frame's first byte from the start of the capture
+//! @param user User pointer passed unchanged from cff_capture_parse()
+//! @return cff_callback_continue to keep parsing, cff_callback_stop to stop after this frame
+typedef cff_callback_result_en_t (*cff_capture_callback_t)(const cff_frame_t *frame, uint64_t offset_bytes,
+                                                           void *user);
+
+//! @brief Capture file mapped into memory
+typedef struct cff_capture_t {
+    const uint8_t *data; //!< Contents of the capture
+    uint64_t size_bytes; //!< Size of the capture in bytes
+    int fd;              //!< File descriptor of the mapped file
+} cff_capture_t;
+
+//! @brief Check whether capture files are supported on this platform
+//!
+//! @return true if cff_capture_open() and multi-threaded cff_capture_parse() can succeed
+bool cff_capture_supported(void);
+
+//! @brief Map a capture file into memory
+//!
+//! @param capture Pointer to capture structure to initialize
+//! @param path Path of the capture file
+//! @return cff_error_none on success, cff_error_not_supported if the platform has no support, cff_error_io if the file
+//!         could not be opened or mapped, error code on failure
+cff_error_en_t cff_capture_open(cff_capture_t *capture, const char *path);
+
+//! @brief Unmap a capture file opened with cff_capture_open()
+//!
+//! Frames delivered from the capture are invalid afterwards.
+//!
+//! @param capture Pointer to capture structure
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_capture_close(cff_capture_t *capture);
+
+//! @brief Parse all frames of a capture using several threads
+//!
+//! Parsing stops at the end of the data, at a trailing incomplete frame, or when the callback returns
+//! cff_callback_stop. With thread_count 1 the capture is parsed on the calling thread only.
+//!
+//! @param data Contents of the capture
+//! @param data_size_bytes Size of the capture in bytes
+//! @param thread_count Number of threads to validate frames on, 1 to CFF_CAPTURE_MAX_THREADS
+//! @param callback Callback function to call for each parsed frame
+//! @param user User pointer passed unchanged to the callback
+//! @param frames_parsed Receives the number of frames delivered, may be NULL
+//! @return cff_error_none on success, cff_error_not_supported if thread_count is out of range,
+//!         cff_error_out_of_memory if memory or threads could not be allocated, error code on failure
+cff_error_en_t cff_capture_parse(const uint8_t *data, uint64_t data_size_bytes, size_t thread_count,
+                                 cff_capture_callback_t callback, void *user, uint64_t *frames_parsed);
+
+//! @}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _CFF_CAPTURE_H_
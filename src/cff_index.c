@@ -0,0 +1,391 @@
+// MIT License
+
+// Copyright (c) 2025 Richard Keelan
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if defined(__linux__) || defined(__unix__)
+#define _POSIX_C_SOURCE 200809L // O_CLOEXEC
+#endif
+
+#include "cff_index.h"
+#include "cff_capture.h"
+#include <string.h>
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__unix__)
+#define CFF_INDEX_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//! Magic bytes at the start of an index file
+static const uint8_t cff_index_magic[8] = {'C', 'F', 'F', 'I', 'N', 'D', 'E', 'X'};
+
+//! Entry layout: offset (8), epoch (4), frame counter (2), payload size (2), then the optional timestamp (8)
+#define CFF_INDEX_ENTRY_SIZE_BYTES 16
+#define CFF_INDEX_TIMESTAMP_SIZE_BYTES 8
+
+// Encoding -----------------------------------------------------------------------------------------------------------
+
+static void cff_index_put_le(uint8_t *buffer, uint64_t value, size_t size_bytes)
+{
+    for (size_t i = 0; i < size_bytes; i++) {
+        buffer[i] = (uint8_t) (value >> (8 * i));
+    }
+}
+
+static uint64_t cff_index_get_le(const uint8_t *buffer, size_t size_bytes)
+{
+    uint64_t value = 0;
+    for (size_t i = 0; i < size_bytes; i++) {
+        value |= (uint64_t) buffer[i] << (8 * i);
+    }
+    return value;
+}
+
+//! Header layout: magic (8), version (4), flags (4), entry count (8), entry size (4), reserved (4)
+static void cff_index_encode_header(uint8_t header[CFF_INDEX_HEADER_SIZE_BYTES], uint32_t flags, uint64_t entry_count,
+                                    uint32_t entry_size_bytes)
+{
+    memset(header, 0, CFF_INDEX_HEADER_SIZE_BYTES);
+    memcpy(header, cff_index_magic, sizeof(cff_index_magic));
+    cff_index_put_le(&header[8], CFF_INDEX_VERSION, 4);
+    cff_index_put_le(&header[12], flags, 4);
+    cff_index_put_le(&header[16], entry_count, 8);
+    cff_index_put_le(&header[24], entry_size_bytes, 4);
+}
+
+uint64_t cff_index_entry_counter(const cff_index_entry_t *entry)
+{
+    return entry == NULL ? 0 : ((uint64_t) entry->epoch << 16) | entry->frame_counter;
+}
+
+// Writer -------------------------------------------------------------------------------------------------------------
+
+cff_error_en_t cff_index_writer_open(cff_index_writer_t *writer, const char *path, uint32_t flags)
+{
+    if (writer == NULL || path == NULL) {
+        return cff_error_null_pointer;
+    }
+    memset(writer, 0, sizeof(*writer));
+
+    writer->file = fopen(path, "wb");
+    if (writer->file == NULL) {
+        return cff_error_io;
+    }
+    writer->flags = flags;
+    writer->entry_size_bytes =
+        CFF_INDEX_ENTRY_SIZE_BYTES + ((flags & CFF_INDEX_FLAG_TIMESTAMPS) ? CFF_INDEX_TIMESTAMP_SIZE_BYTES : 0);
+
+    // The entry count is filled in by cff_index_writer_close()
+    uint8_t header[CFF_INDEX_HEADER_SIZE_BYTES];
+    cff_index_encode_header(header, flags, 0, writer->entry_size_bytes);
+    if (fwrite(header, sizeof(header), 1, writer->file) != 1) {
+        fclose(writer->file);
+        writer->file = NULL;
+        return cff_error_io;
+    }
+    return cff_error_none;
+}
+
+cff_error_en_t cff_index_writer_add(cff_index_writer_t *writer, uint64_t offset_bytes, const cff_frame_t *frame,
+                                    uint64_t timestamp)
+{
+    if (writer == NULL || writer->file == NULL || frame == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    // Same ordering as the parser's counter tracking: up to half the counter range ahead is newer
+    uint16_t counter = frame->header.frame_counter;
+    uint32_t epoch = writer->epoch;
+    if (writer->entry_count > 0) {
+        uint16_t delta = (uint16_t) (counter - writer->last_counter);
+        if (delta < 0x8000u) {
+            if (counter < writer->last_counter) {
+                writer->epoch++; // Rolled over
+            }
+            epoch = writer->epoch;
+            writer->last_counter = counter;
+        }
+        else if (counter > writer->last_counter && epoch > 0) {
+            epoch--; // A late frame from before the rollover
+        }
+    }
+    else {
+        writer->last_counter = counter;
+    }
+
+    uint8_t entry[CFF_INDEX_ENTRY_SIZE_BYTES + CFF_INDEX_TIMESTAMP_SIZE_BYTES];
+    cff_index_put_le(&entry[0], offset_bytes, 8);
+    cff_index_put_le(&entry[8], epoch, 4);
+    cff_index_put_le(&entry[12], counter, 2);
+    cff_index_put_le(&entry[14], frame->payload_size_bytes, 2);
+    cff_index_put_le(&entry[16], timestamp, 8);
+    if (fwrite(entry, writer->entry_size_bytes, 1, writer->file) != 1) {
+        return cff_error_io;
+    }
+
+    writer->entry_count++;
+    return cff_error_none;
+}
+
+cff_error_en_t cff_index_writer_close(cff_index_writer_t *writer)
+{
+    if (writer == NULL || writer->file == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    uint8_t header[CFF_INDEX_HEADER_SIZE_BYTES];
+    cff_index_encode_header(header, writer->flags, writer->entry_count, writer->entry_size_bytes);
+    bool written = fseek(writer->file, 0, SEEK_SET) == 0 && fwrite(header, sizeof(header), 1, writer->file) == 1;
+    written = fclose(writer->file) == 0 && written;
+    writer->file = NULL;
+
+    return written ? cff_error_none : cff_error_io;
+}
+
+typedef struct cff_index_build_context_t {
+    cff_index_writer_t writer;
+    cff_error_en_t error;
+} cff_index_build_context_t;
+
+static cff_callback_result_en_t cff_index_build_callback(const cff_frame_t *frame, uint64_t offset_bytes, void *user)
+{
+    cff_index_build_context_t *context = (cff_index_build_context_t *) user;
+    context->error = cff_index_writer_add(&context->writer, offset_bytes, frame, 0);
+    return context->error == cff_error_none ? cff_callback_continue : cff_callback_stop;
+}
+
+cff_error_en_t cff_index_build(const uint8_t *capture, uint64_t capture_size_bytes, size_t thread_count,
+                               const char *path, uint64_t *frames_indexed)
+{
+    if (frames_indexed != NULL) {
+        *frames_indexed = 0;
+    }
+
+    cff_index_build_context_t context;
+    cff_error_en_t error = cff_index_writer_open(&context.writer, path, 0);
+    if (error != cff_error_none) {
+        return error;
+    }
+
+    context.error = cff_error_none;
+    error = cff_capture_parse(capture, capture_size_bytes, thread_count, cff_index_build_callback, &context, NULL);
+    if (error == cff_error_none) {
+        error = context.error;
+    }
+    if (frames_indexed != NULL) {
+        *frames_indexed = context.writer.entry_count;
+    }
+
+    cff_error_en_t close_error = cff_index_writer_close(&context.writer);
+    return error != cff_error_none ? error : close_error;
+}
+
+// Reader -------------------------------------------------------------------------------------------------------------
+
+cff_error_en_t cff_index_entry(const cff_index_t *index, uint64_t entry_index, cff_index_entry_t *entry)
+{
+    if (index == NULL || entry == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (entry_index >= index->entry_count) {
+        return cff_error_buffer_too_small;
+    }
+
+    const uint8_t *data = &index->data[CFF_INDEX_HEADER_SIZE_BYTES + entry_index * index->entry_size_bytes];
+    entry->offset_bytes = cff_index_get_le(&data[0], 8);
+    entry->epoch = (uint32_t) cff_index_get_le(&data[8], 4);
+    entry->frame_counter = (uint16_t) cff_index_get_le(&data[12], 2);
+    entry->payload_size_bytes = (uint16_t) cff_index_get_le(&data[14], 2);
+    entry->timestamp = (index->flags & CFF_INDEX_FLAG_TIMESTAMPS) ? cff_index_get_le(&data[16], 8) : 0;
+    return cff_error_none;
+}
+
+//! Key an entry is searched by
+typedef uint64_t (*cff_index_key_t)(const cff_index_entry_t *entry);
+
+static uint64_t cff_index_timestamp_key(const cff_index_entry_t *entry)
+{
+    return entry->timestamp;
+}
+
+//! Find the first entry whose key is not less than value
+static uint64_t cff_index_lower_bound(const cff_index_t *index, cff_index_key_t key, uint64_t value)
+{
+    uint64_t first = 0;
+    uint64_t count = index->entry_count;
+    while (count > 0) {
+        uint64_t step = count / 2;
+        cff_index_entry_t entry;
+        cff_index_entry(index, first + step, &entry);
+        if (key(&entry) < value) {
+            first += step + 1;
+            count -= step + 1;
+        }
+        else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+cff_error_en_t cff_index_find_counter(const cff_index_t *index, uint64_t counter, uint64_t *entry_index)
+{
+    if (index == NULL || entry_index == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    *entry_index = cff_index_lower_bound(index, cff_index_entry_counter, counter);
+    return cff_error_none;
+}
+
+cff_error_en_t cff_index_find_timestamp(const cff_index_t *index, uint64_t timestamp, uint64_t *entry_index)
+{
+    if (index == NULL || entry_index == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if ((index->flags & CFF_INDEX_FLAG_TIMESTAMPS) == 0) {
+        return cff_error_not_supported;
+    }
+
+    *entry_index = cff_index_lower_bound(index, cff_index_timestamp_key, timestamp);
+    return cff_error_none;
+}
+
+cff_error_en_t cff_index_read_frame(const cff_index_t *index, const uint8_t *capture, uint64_t capture_size_bytes,
+                                    uint64_t entry_index, cff_frame_t *frame)
+{
+    if (capture == NULL || frame == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    cff_index_entry_t entry;
+    cff_error_en_t error = cff_index_entry(index, entry_index, &entry);
+    if (error != cff_error_none) {
+        return error;
+    }
+
+    if (entry.offset_bytes >= capture_size_bytes) {
+        return cff_error_incomplete_frame;
+    }
+
+    error = cff_validate_frame(&capture[entry.offset_bytes], (size_t) (capture_size_bytes - entry.offset_bytes), frame);
+    if (error != cff_error_none) {
+        return error;
+    }
+
+    // The header CRC passed, but a capture that was replaced could still have a different frame here
+    if (frame->header.frame_counter != entry.frame_counter || frame->payload_size_bytes != entry.payload_size_bytes) {
+        return cff_error_invalid_state;
+    }
+    return cff_error_none;
+}
+
+#if defined(CFF_INDEX_POSIX)
+
+cff_error_en_t cff_index_open(cff_index_t *index, const char *path)
+{
+    if (index == NULL || path == NULL) {
+        return cff_error_null_pointer;
+    }
+    memset(index, 0, sizeof(*index));
+    index->fd = -1;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return cff_error_io;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        close(fd);
+        return cff_error_io;
+    }
+    if ((uint64_t) status.st_size < CFF_INDEX_HEADER_SIZE_BYTES) {
+        close(fd);
+        return cff_error_not_supported;
+    }
+
+    void *mapping = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        close(fd);
+        return cff_error_io;
+    }
+
+    const uint8_t *data = (const uint8_t *) mapping;
+    uint64_t entry_count = cff_index_get_le(&data[16], 8);
+    uint32_t entry_size_bytes = (uint32_t) cff_index_get_le(&data[24], 4);
+    uint32_t flags = (uint32_t) cff_index_get_le(&data[12], 4);
+    uint32_t expected_entry_size_bytes =
+        CFF_INDEX_ENTRY_SIZE_BYTES + ((flags & CFF_INDEX_FLAG_TIMESTAMPS) ? CFF_INDEX_TIMESTAMP_SIZE_BYTES : 0);
+
+    // A truncated index, e.g. from a writer that never closed, is rejected rather than read past its end
+    if (memcmp(data, cff_index_magic, sizeof(cff_index_magic)) != 0 ||
+        cff_index_get_le(&data[8], 4) != CFF_INDEX_VERSION || entry_size_bytes != expected_entry_size_bytes ||
+        entry_count > ((uint64_t) status.st_size - CFF_INDEX_HEADER_SIZE_BYTES) / entry_size_bytes) {
+        munmap(mapping, (size_t) status.st_size);
+        close(fd);
+        return cff_error_not_supported;
+    }
+
+    index->data = data;
+    index->size_bytes = (uint64_t) status.st_size;
+    index->entry_count = entry_count;
+    index->flags = flags;
+    index->entry_size_bytes = entry_size_bytes;
+    index->fd = fd;
+    return cff_error_none;
+}
+
+cff_error_en_t cff_index_close(cff_index_t *index)
+{
+    if (index == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (index->data != NULL) {
+        munmap((void *) index->data, (size_t) index->size_bytes);
+    }
+    if (index->fd >= 0) {
+        close(index->fd);
+    }
+    memset(index, 0, sizeof(*index));
+    index->fd = -1;
+    return cff_error_none;
+}
+
+#else
+
+cff_error_en_t cff_index_open(cff_index_t *index, const char *path)
+{
+    (void) path;
+    return index == NULL ? cff_error_null_pointer : cff_error_not_supported;
+}
+
+cff_error_en_t cff_index_close(cff_index_t *index)
+{
+    return index == NULL ? cff_error_null_pointer : cff_error_not_supported;
+}
+
+#endif
@@ -0,0 +1,196 @@
+//! @file cff_index.h
+//! @brief Sidecar frame index for random access into capture files
+//! @author Richard Keelan
+//! @date 2025
+//! @copyright MIT License
+//!
+//! An index file lists, for every frame of a capture, its file offset, frame counter, payload size and optionally a
+//! timestamp. Frame counters are extended with an epoch that counts their 16-bit rollovers, so a counter identifies a
+//! frame across the whole capture. The index is written while parsing, by cff_index_build() or frame by frame with a
+//! cff_index_writer_t, and is read back mapped into memory to jump straight to a frame without parsing anything
+//! before it. All fields are stored little-endian. Available on POSIX hosts.
+
+// MIT License
+
+// Copyright (c) 2025 Richard Keelan
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _CFF_INDEX_H_
+#define _CFF_INDEX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "cff.h"
+#include <stdio.h>
+
+//! @defgroup cff_index CFF Capture Index
+//! @brief Sidecar index of the frames in a capture file
+//! @{
+
+//! @brief Version of the index file format written by this library
+#define CFF_INDEX_VERSION 1
+
+//! @brief Size of the index file header in bytes
+#define CFF_INDEX_HEADER_SIZE_BYTES 32
+
+//! @brief Index flag set when every entry carries a timestamp
+#define CFF_INDEX_FLAG_TIMESTAMPS 0x01
+
+//! @brief One frame of an indexed capture
+typedef struct cff_index_entry_t {
+    uint64_t offset_bytes;       //!< Offset of the frame's first byte in the capture
+    uint64_t timestamp;          //!< Timestamp given when the frame was indexed, 0 without CFF_INDEX_FLAG_TIMESTAMPS
+    uint32_t epoch;              //!< Number of frame counter rollovers before this frame
+    uint16_t frame_counter;      //!< Frame counter from the frame header
+    uint16_t payload_size_bytes; //!< Payload size from the frame header
+} cff_index_entry_t;
+
+//! @brief Index file being written
+typedef struct cff_index_writer_t {
+    FILE *file;                //!< Index file
+    uint32_t flags;            //!< Combination of CFF_INDEX_FLAG_* values
+    uint64_t entry_count;      //!< Number of entries written so far
+    uint32_t epoch;            //!< Epoch of the newest frame counter
+    uint16_t last_counter;     //!< Newest frame counter, valid once entry_count > 0
+    uint32_t entry_size_bytes; //!< Size of one entry in the file
+} cff_index_writer_t;
+
+//! @brief Index file mapped into memory
+typedef struct cff_index_t {
+    const uint8_t *data;       //!< Contents of the index file
+    uint64_t size_bytes;       //!< Size of the index file in bytes
+    uint64_t entry_count;      //!< Number of entries
+    uint32_t flags;            //!< Combination of CFF_INDEX_FLAG_* values
+    uint32_t entry_size_bytes; //!< Size of one entry in the file
+    int fd;                    //!< File descriptor of the mapped file
+} cff_index_t;
+
+//! @brief Combine an entry's epoch and frame counter into a counter that doesn't roll over
+//!
+//! @param entry Pointer to index entry
+//! @return Extended frame counter
+uint64_t cff_index_entry_counter(const cff_index_entry_t *entry);
+
+//! @brief Create an index file
+//!
+//! @param writer Pointer to writer structure to initialize
+//! @param path Path of the index file, replaced if it exists
+//! @param flags Combination of CFF_INDEX_FLAG_* values
+//! @return cff_error_none on success, cff_error_io if the file could not be created, error code on failure
+cff_error_en_t cff_index_writer_open(cff_index_writer_t *writer, const char *path, uint32_t flags);
+
+//! @brief Add the next frame of the capture to an index
+//!
+//! Frames must be added in stream order. The epoch advances when a counter rolls over from 65535 to 0. A late frame
+//! from before the rollover keeps the previous epoch.
+//!
+//! @param writer Pointer to open writer
+//! @param offset_bytes Offset of the frame's first byte in the capture
+//! @param frame Pointer to the parsed frame
+//! @param timestamp Timestamp to store, ignored without CFF_INDEX_FLAG_TIMESTAMPS
+//! @return cff_error_none on success, cff_error_io if the entry could not be written, error code on failure
+cff_error_en_t cff_index_writer_add(cff_index_writer_t *writer, uint64_t offset_bytes, const cff_frame_t *frame,
+                                    uint64_t timestamp);
+
+//! @brief Complete an index file and close it
+//!
+//! @param writer Pointer to open writer
+//! @return cff_error_none on success, cff_error_io if the file could not be completed, error code on failure
+cff_error_en_t cff_index_writer_close(cff_index_writer_t *writer);
+
+//! @brief Parse a capture and write its index
+//!
+//! Parses with cff_capture_parse(), so the indexed frames are exactly those a streaming parser would deliver.
+//!
+//! @param capture Contents of the capture
+//! @param capture_size_bytes Size of the capture in bytes
+//! @param thread_count Number of threads to parse on, see cff_capture_parse()
+//! @param path Path of the index file, replaced if it exists
+//! @param frames_indexed Receives the number of frames indexed, may be NULL
+//! @return cff_error_none on success, cff_error_not_supported if thread_count is out of range, cff_error_io if the
+//!         index file could not be written, error code on failure
+cff_error_en_t cff_index_build(const uint8_t *capture, uint64_t capture_size_bytes, size_t thread_count,
+                               const char *path, uint64_t *frames_indexed);
+
+//! @brief Map an index file into memory
+//!
+//! @param index Pointer to index structure to initialize
+//! @param path Path of the index file
+//! @return cff_error_none on success, cff_error_not_supported if the file is not an index of a supported version,
+//!         cff_error_io if the file could not be opened or mapped, error code on failure
+cff_error_en_t cff_index_open(cff_index_t *index, const char *path);
+
+//! @brief Unmap an index file opened with cff_index_open()
+//!
+//! @param index Pointer to index structure
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_index_close(cff_index_t *index);
+
+//! @brief Read one entry of an index
+//!
+//! @param index Pointer to open index
+//! @param entry_index Number of the entry, counted from 0 in stream order
+//! @param entry Pointer to entry structure to fill
+//! @return cff_error_none on success, cff_error_buffer_too_small if entry_index is past the last entry, error code on
+//!         failure
+cff_error_en_t cff_index_entry(const cff_index_t *index, uint64_t entry_index, cff_index_entry_t *entry);
+
+//! @brief Find the first entry whose extended frame counter is not less than counter
+//!
+//! Uses a binary search, which relies on the extended counters increasing through the capture. Frames that arrived
+//! out of order can make the result land a few entries early or late.
+//!
+//! @param index Pointer to open index
+//! @param counter Extended frame counter, see cff_index_entry_counter()
+//! @param entry_index Receives the number of the entry, or entry_count if every counter is less than counter
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_index_find_counter(const cff_index_t *index, uint64_t counter, uint64_t *entry_index);
+
+//! @brief Find the first entry whose timestamp is not less than timestamp
+//!
+//! Uses a binary search, which relies on the timestamps not decreasing through the capture.
+//!
+//! @param index Pointer to open index
+//! @param timestamp Timestamp to search for
+//! @param entry_index Receives the number of the entry, or entry_count if every timestamp is less than timestamp
+//! @return cff_error_none on success, cff_error_not_supported if the index has no timestamps, error code on failure
+cff_error_en_t cff_index_find_timestamp(const cff_index_t *index, uint64_t timestamp, uint64_t *entry_index);
+
+//! @brief Validate and return the frame of an entry
+//!
+//! @param index Pointer to open index
+//! @param capture Contents of the indexed capture
+//! @param capture_size_bytes Size of the capture in bytes
+//! @param entry_index Number of the entry
+//! @param frame Pointer to frame structure to fill, its payload points into the capture
+//! @return cff_error_none on success, cff_error_buffer_too_small if entry_index is past the last entry, another error
+//!         if the capture doesn't match the index
+cff_error_en_t cff_index_read_frame(const cff_index_t *index, const uint8_t *capture, uint64_t capture_size_bytes,
+                                    uint64_t entry_index, cff_frame_t *frame);
+
+//! @}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _CFF_INDEX_H_
@@ -0,0 +1,154 @@
+// MIT License
+
+// Copyright (c) 2025 Richard Keelan
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#if defined(__linux__)
+#define _GNU_SOURCE // memfd_create
+#endif
+
+#include "cff_mirror.h"
+#include <string.h>
+
+#if defined(__linux__) || defined(__APPLE__) || defined(__unix__)
+#define CFF_MIRROR_POSIX 1
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined(CFF_MIRROR_POSIX)
+
+// Create an anonymous shared memory object of the given size and return its file descriptor, or -1 on failure
+static int cff_mirror_create_memory(size_t size_bytes)
+{
+#if defined(__linux__)
+    int fd = memfd_create("cff_ring_buffer", MFD_CLOEXEC);
+#else
+    // Without memfd, a named object is created and immediately unlinked so nothing is left behind
+    static unsigned int counter = 0;
+    char name[64];
+    snprintf(name, sizeof(name), "/cff-ring-%ld-%u", (long) getpid(), counter++);
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        shm_unlink(name);
+    }
+#endif
+    if (fd < 0) {
+        return -1;
+    }
+
+    if (ftruncate(fd, (off_t) size_bytes) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool cff_ring_buffer_mirrored_supported(void)
+{
+    return true;
+}
+
+cff_error_en_t cff_ring_buffer_init_mirrored(cff_ring_buffer_t *ring_buffer, uint32_t minimum_size)
+{
+    if (ring_buffer == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (minimum_size == 0) {
+        return cff_error_buffer_too_small;
+    }
+
+    // Both mappings must start on a page boundary, so the storage is a whole number of pages
+    size_t page_size = (size_t) sysconf(_SC_PAGESIZE);
+    size_t size_bytes = ((size_t) minimum_size * sizeof(CFF_RB_T) + page_size - 1) / page_size * page_size;
+    if (size_bytes / sizeof(CFF_RB_T) > UINT32_MAX || size_bytes % sizeof(CFF_RB_T) != 0) {
+        return cff_error_not_supported;
+    }
+
+    int fd = cff_mirror_create_memory(size_bytes);
+    if (fd < 0) {
+        return cff_error_out_of_memory;
+    }
+
+    // Reserve address space for both copies, then map the memory over each half
+    uint8_t *base = (uint8_t *) mmap(NULL, 2 * size_bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return cff_error_out_of_memory;
+    }
+
+    void *first = mmap(base, size_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    void *second = mmap(base + size_bytes, size_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    close(fd); // The mappings keep the memory alive
+
+    if (first != base || second != base + size_bytes) {
+        munmap(base, 2 * size_bytes);
+        return cff_error_out_of_memory;
+    }
+
+    uint32_t buffer_size = (uint32_t) (size_bytes / sizeof(CFF_RB_T));
+    cff_error_en_t error = cff_ring_buffer_init(ring_buffer, (CFF_RB_T *) base, buffer_size);
+    if (error != cff_error_none) {
+        munmap(base, 2 * size_bytes);
+        return error;
+    }
+    ring_buffer->flags |= CFF_RING_BUFFER_FLAG_MIRRORED;
+
+    return cff_error_none;
+}
+
+cff_error_en_t cff_ring_buffer_free_mirrored(cff_ring_buffer_t *ring_buffer)
+{
+    if (ring_buffer == NULL || ring_buffer->buffer == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if ((ring_buffer->flags & CFF_RING_BUFFER_FLAG_MIRRORED) == 0) {
+        return cff_error_not_supported;
+    }
+
+    munmap(ring_buffer->buffer, 2 * (size_t) ring_buffer->buffer_size * sizeof(CFF_RB_T));
+    memset(ring_buffer, 0, sizeof(*ring_buffer));
+
+    return cff_error_none;
+}
+
+#else
+
+bool cff_ring_buffer_mirrored_supported(void)
+{
+    return false;
+}
+
+cff_error_en_t cff_ring_buffer_init_mirrored(cff_ring_buffer_t *ring_buffer, uint32_t minimum_size)
+{
+    (void) minimum_size;
+    return ring_buffer == NULL ? cff_error_null_pointer : cff_error_not_supported;
+}
+
+cff_error_en_t cff_ring_buffer_free_mirrored(cff_ring_buffer_t *ring_buffer)
+{
+    return ring_buffer == NULL ? cff_error_null_pointer : cff_error_not_supported;
+}
+
+#endif
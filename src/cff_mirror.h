@@ -0,0 +1,76 @@
+//! @file cff_mirror.h
+//! @brief Mirrored ring buffer storage for hosts with virtual memory
+//! @author Richard Keelan
+//! @date 2025
+//! @copyright MIT License
+//!
+//! Maps the storage of a ring buffer twice, back to back, so that any region of up to buffer_size elements is
+//! contiguous in memory. Frames parsed from a mirrored ring buffer never wrap: frame->payload always points to the
+//! whole payload, and peeking, CRC calculation and payload copies never split the data. Available on Linux (memfd) and
+//! other POSIX systems such as macOS (shm_open). Unlike the rest of the library, this module allocates memory.
+
+// MIT License
+
+// Copyright (c) 2025 Richard Keelan
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _CFF_MIRROR_H_
+#define _CFF_MIRROR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "cff.h"
+
+//! @defgroup cff_mirror CFF Mirrored Ring Buffer
+//! @brief Ring buffer storage mapped twice so that frames never wrap
+//! @{
+
+//! @brief Check whether mirrored ring buffers are supported on this platform
+//!
+//! @return true if cff_ring_buffer_init_mirrored() can succeed
+bool cff_ring_buffer_mirrored_supported(void);
+
+//! @brief Initialize a ring buffer with mirrored storage
+//!
+//! Allocates storage of at least minimum_size elements and maps it twice, back to back. The size is rounded up to a
+//! multiple of the page size, so ring_buffer->buffer_size may be larger than requested. The storage must be released
+//! with cff_ring_buffer_free_mirrored().
+//!
+//! @param ring_buffer Pointer to ring buffer structure to initialize
+//! @param minimum_size Minimum size of the buffer in elements
+//! @return cff_error_none on success, cff_error_not_supported if the platform has no support, cff_error_out_of_memory
+//! if the mappings could not be created, error code on failure
+cff_error_en_t cff_ring_buffer_init_mirrored(cff_ring_buffer_t *ring_buffer, uint32_t minimum_size);
+
+//! @brief Release the storage of a mirrored ring buffer
+//!
+//! @param ring_buffer Pointer to ring buffer initialized with cff_ring_buffer_init_mirrored()
+//! @return cff_error_none on success, cff_error_not_supported if the ring buffer is not mirrored, error code on failure
+cff_error_en_t cff_ring_buffer_free_mirrored(cff_ring_buffer_t *ring_buffer);
+
+//! @}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _CFF_MIRROR_H_
@@ -0,0 +1,518 @@
+// MIT License
+
+// Copyright (c) 2025 Richard Keelan
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "cff_mux.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#define CFF_MUX_EPOLL 1
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+#if defined(CFF_MUX_EPOLL)
+
+//! Number of epoll events handled per cff_mux_poll() call
+#define CFF_MUX_POLL_EVENTS 64
+
+struct cff_mux_stream_t {
+    cff_mux_t *mux;
+    int fd; // Written by the reader only, read by a worker re-arming polling
+    cff_ring_buffer_t ring_buffer;
+    cff_parser_t parser;
+    cff_callback_ex_t callback;
+    void *user;
+
+    // Number of times data arrived since a worker last saw the count. The thread that raises it from zero queues the
+    // stream, the worker only lets go of it once it has parsed without the count rising again, so at most one worker
+    // parses a stream at a time.
+    uint32_t pending;
+    // Set while polling of fd is paused because the ring buffer is full
+    uint32_t paused;
+
+    cff_mux_stream_t *next_queued; // Link in a worker queue
+    cff_mux_stream_t *previous;    // Links in the list of all streams
+    cff_mux_stream_t *next;
+};
+
+typedef struct cff_mux_queue_t {
+    pthread_mutex_t lock;
+    cff_mux_stream_t *head;
+    cff_mux_stream_t *tail;
+} cff_mux_queue_t;
+
+typedef struct cff_mux_worker_t {
+    cff_mux_t *mux;
+    size_t index;
+    pthread_t thread;
+    cff_mux_queue_t queue;
+} cff_mux_worker_t;
+
+struct cff_mux_t {
+    int epoll_fd;
+    size_t worker_count;
+    cff_mux_worker_t workers[CFF_MUX_MAX_WORKERS];
+    size_t next_worker;
+
+    // Protects the counters below and is waited on by idle workers and cff_mux_wait_idle()
+    pthread_mutex_t lock;
+    pthread_cond_t work_available;
+    pthread_cond_t idle;
+    size_t queued_streams; // Streams in the queues that no worker has claimed yet
+    size_t active_streams; // Streams that are queued or being parsed
+    bool stopping;
+
+    cff_mux_stream_t *streams;
+};
+
+bool cff_mux_supported(void)
+{
+    return true;
+}
+
+// Queues --------------------------------------------------------------------------------------------------------------
+
+static void cff_mux_queue_push(cff_mux_queue_t *queue, cff_mux_stream_t *stream)
+{
+    pthread_mutex_lock(&queue->lock);
+    stream->next_queued = NULL;
+    if (queue->tail != NULL) {
+        queue->tail->next_queued = stream;
+    }
+    else {
+        queue->head = stream;
+    }
+    queue->tail = stream;
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static cff_mux_stream_t *cff_mux_queue_pop(cff_mux_queue_t *queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    cff_mux_stream_t *stream = queue->head;
+    if (stream != NULL) {
+        queue->head = stream->next_queued;
+        if (queue->head == NULL) {
+            queue->tail = NULL;
+        }
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return stream;
+}
+
+// Scheduling ----------------------------------------------------------------------------------------------------------
+
+//! Record that data arrived for a stream and queue it unless it is already queued or being parsed
+static void cff_mux_schedule(cff_mux_stream_t *stream)
+{
+    if (__atomic_fetch_add(&stream->pending, 1, __ATOMIC_ACQ_REL) != 0) {
+        return; // The worker that owns it will see the new count
+    }
+
+    cff_mux_t *mux = stream->mux;
+    pthread_mutex_lock(&mux->lock);
+    mux->active_streams++;
+    size_t worker = mux->next_worker;
+    mux->next_worker = (mux->next_worker + 1) % mux->worker_count;
+    pthread_mutex_unlock(&mux->lock);
+
+    cff_mux_queue_push(&mux->workers[worker].queue, stream);
+
+    pthread_mutex_lock(&mux->lock);
+    mux->queued_streams++;
+    pthread_cond_signal(&mux->work_available);
+    pthread_mutex_unlock(&mux->lock);
+}
+
+//! Resume polling a stream that was paused with a full ring buffer, if there is room again. Called by the reader after
+//! pausing and by the worker after parsing; whichever clears the flag first re-arms the file descriptor.
+static void cff_mux_resume_polling(cff_mux_stream_t *stream)
+{
+    if (__atomic_load_n(&stream->paused, __ATOMIC_ACQUIRE) == 0 ||
+        cff_ring_buffer_free_space(&stream->ring_buffer) == 0) {
+        return;
+    }
+
+    uint32_t expected = 1;
+    if (__atomic_compare_exchange_n(&stream->paused, &expected, 0, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        struct epoll_event event = {.events = EPOLLIN, .data.ptr = stream};
+        epoll_ctl(stream->mux->epoll_fd, EPOLL_CTL_MOD, __atomic_load_n(&stream->fd, __ATOMIC_ACQUIRE), &event);
+    }
+}
+
+//! Parse a stream until no more data arrived while it was being parsed
+static void cff_mux_run_stream(cff_mux_stream_t *stream)
+{
+    // Once pending drops to zero the stream may be removed, so it must not be touched after that
+    cff_mux_t *mux = stream->mux;
+    uint32_t seen = __atomic_load_n(&stream->pending, __ATOMIC_ACQUIRE);
+    for (;;) {
+        cff_parser_parse_frames_ex(&stream->parser, stream->callback, stream->user);
+        cff_mux_resume_polling(stream);
+
+        uint32_t remaining = __atomic_sub_fetch(&stream->pending, seen, __ATOMIC_ACQ_REL);
+        if (remaining == 0) {
+            break;
+        }
+        seen = remaining;
+    }
+
+    pthread_mutex_lock(&mux->lock);
+    if (--mux->active_streams == 0) {
+        pthread_cond_broadcast(&mux->idle);
+    }
+    pthread_mutex_unlock(&mux->lock);
+}
+
+static void *cff_mux_worker_main(void *argument)
+{
+    cff_mux_worker_t *worker = (cff_mux_worker_t *) argument;
+    cff_mux_t *mux = worker->mux;
+
+    for (;;) {
+        // Claim one queued stream, then find it: in the own queue first, otherwise steal it from another worker
+        pthread_mutex_lock(&mux->lock);
+        while (mux->queued_streams == 0 && !mux->stopping) {
+            pthread_cond_wait(&mux->work_available, &mux->lock);
+        }
+        if (mux->stopping) {
+            pthread_mutex_unlock(&mux->lock);
+            return NULL;
+        }
+        mux->queued_streams--;
+        pthread_mutex_unlock(&mux->lock);
+
+        cff_mux_stream_t *stream = NULL;
+        while (stream == NULL) {
+            for (size_t i = 0; i < mux->worker_count && stream == NULL; i++) {
+                stream = cff_mux_queue_pop(&mux->workers[(worker->index + i) % mux->worker_count].queue);
+            }
+        }
+
+        cff_mux_run_stream(stream);
+    }
+}
+
+// Multiplexer ---------------------------------------------------------------------------------------------------------
+
+cff_error_en_t cff_mux_create(cff_mux_t **mux, size_t worker_count)
+{
+    if (mux == NULL) {
+        return cff_error_null_pointer;
+    }
+    *mux = NULL;
+
+    if (worker_count == 0 || worker_count > CFF_MUX_MAX_WORKERS) {
+        return cff_error_not_supported;
+    }
+
+    cff_mux_t *new_mux = (cff_mux_t *) calloc(1, sizeof(*new_mux));
+    if (new_mux == NULL) {
+        return cff_error_out_of_memory;
+    }
+
+    new_mux->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (new_mux->epoll_fd < 0) {
+        free(new_mux);
+        return cff_error_out_of_memory;
+    }
+
+    pthread_mutex_init(&new_mux->lock, NULL);
+    pthread_cond_init(&new_mux->work_available, NULL);
+    pthread_cond_init(&new_mux->idle, NULL);
+    new_mux->worker_count = worker_count;
+
+    for (size_t i = 0; i < worker_count; i++) {
+        cff_mux_worker_t *worker = &new_mux->workers[i];
+        worker->mux = new_mux;
+        worker->index = i;
+        pthread_mutex_init(&worker->queue.lock, NULL);
+        if (pthread_create(&worker->thread, NULL, cff_mux_worker_main, worker) != 0) {
+            pthread_mutex_destroy(&worker->queue.lock);
+            new_mux->worker_count = i; // Only the workers started so far are joined
+            cff_mux_destroy(new_mux);
+            return cff_error_out_of_memory;
+        }
+    }
+
+    *mux = new_mux;
+    return cff_error_none;
+}
+
+static void cff_mux_free_stream(cff_mux_stream_t *stream)
+{
+    free(stream->ring_buffer.buffer);
+    free(stream);
+}
+
+void cff_mux_destroy(cff_mux_t *mux)
+{
+    if (mux == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&mux->lock);
+    mux->stopping = true;
+    pthread_cond_broadcast(&mux->work_available);
+    pthread_mutex_unlock(&mux->lock);
+
+    for (size_t i = 0; i < mux->worker_count; i++) {
+        pthread_join(mux->workers[i].thread, NULL);
+        pthread_mutex_destroy(&mux->workers[i].queue.lock);
+    }
+
+    while (mux->streams != NULL) {
+        cff_mux_stream_t *stream = mux->streams;
+        mux->streams = stream->next;
+        cff_mux_free_stream(stream);
+    }
+
+    close(mux->epoll_fd);
+    pthread_cond_destroy(&mux->idle);
+    pthread_cond_destroy(&mux->work_available);
+    pthread_mutex_destroy(&mux->lock);
+    free(mux);
+}
+
+cff_error_en_t cff_mux_add_stream(cff_mux_t *mux, int fd, uint32_t ring_buffer_size, cff_callback_ex_t callback,
+                                  void *user, cff_mux_stream_t **stream)
+{
+    if (mux == NULL || callback == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (ring_buffer_size < CFF_MIN_FRAME_SIZE_BYTES) {
+        return cff_error_buffer_too_small;
+    }
+
+    cff_mux_stream_t *new_stream = (cff_mux_stream_t *) calloc(1, sizeof(*new_stream));
+    CFF_RB_T *storage = (CFF_RB_T *) malloc(ring_buffer_size * sizeof(CFF_RB_T));
+    if (new_stream == NULL || storage == NULL) {
+        free(new_stream);
+        free(storage);
+        return cff_error_out_of_memory;
+    }
+
+    cff_error_en_t error = cff_ring_buffer_init(&new_stream->ring_buffer, storage, ring_buffer_size);
+    if (error != cff_error_none) {
+        cff_mux_free_stream(new_stream);
+        return error;
+    }
+    cff_parser_init(&new_stream->parser, &new_stream->ring_buffer);
+    new_stream->mux = mux;
+    new_stream->fd = fd;
+    new_stream->callback = callback;
+    new_stream->user = user;
+
+    if (fd >= 0) {
+        int flags = fcntl(fd, F_GETFL);
+        struct epoll_event event = {.events = EPOLLIN, .data.ptr = new_stream};
+        if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0 ||
+            epoll_ctl(mux->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            cff_mux_free_stream(new_stream);
+            return cff_error_out_of_memory;
+        }
+    }
+
+    new_stream->next = mux->streams;
+    if (mux->streams != NULL) {
+        mux->streams->previous = new_stream;
+    }
+    mux->streams = new_stream;
+
+    if (stream != NULL) {
+        *stream = new_stream;
+    }
+    return cff_error_none;
+}
+
+cff_error_en_t cff_mux_remove_stream(cff_mux_t *mux, cff_mux_stream_t *stream)
+{
+    if (mux == NULL || stream == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    if (stream->mux != mux) {
+        return cff_error_invalid_state;
+    }
+
+    if (stream->fd >= 0) {
+        epoll_ctl(mux->epoll_fd, EPOLL_CTL_DEL, stream->fd, NULL);
+    }
+
+    // A worker may still hold the stream; no new work can be scheduled since the caller is the only producer
+    while (__atomic_load_n(&stream->pending, __ATOMIC_ACQUIRE) != 0) {
+        sched_yield();
+    }
+
+    if (stream->previous != NULL) {
+        stream->previous->next = stream->next;
+    }
+    else {
+        mux->streams = stream->next;
+    }
+    if (stream->next != NULL) {
+        stream->next->previous = stream->previous;
+    }
+
+    cff_mux_free_stream(stream);
+    return cff_error_none;
+}
+
+cff_error_en_t cff_mux_feed(cff_mux_stream_t *stream, const uint8_t *data, uint32_t data_size_bytes)
+{
+    if (stream == NULL || data == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    cff_error_en_t error = cff_ring_buffer_append(&stream->ring_buffer, data, data_size_bytes);
+    if (error != cff_error_none) {
+        return error;
+    }
+
+    cff_mux_schedule(stream);
+    return cff_error_none;
+}
+
+//! Read what is available on a stream's file descriptor into its ring buffer
+static void cff_mux_read_stream(cff_mux_t *mux, cff_mux_stream_t *stream)
+{
+    CFF_RB_T *region;
+    uint32_t region_size;
+    if (cff_ring_buffer_reserve(&stream->ring_buffer, &region, &region_size) != cff_error_none) {
+        // Full: stop polling until the worker has made room, and make sure it runs even if nothing else arrives.
+        // Disarming before setting the flag means a worker that sees the flag re-arms after the disarm.
+        struct epoll_event event = {.events = 0, .data.ptr = stream};
+        epoll_ctl(mux->epoll_fd, EPOLL_CTL_MOD, stream->fd, &event);
+        __atomic_store_n(&stream->paused, 1, __ATOMIC_RELEASE);
+        cff_mux_resume_polling(stream);
+        cff_mux_schedule(stream);
+        return;
+    }
+
+    ssize_t received = read(stream->fd, region, region_size * sizeof(CFF_RB_T));
+    if (received > 0) {
+        cff_ring_buffer_commit(&stream->ring_buffer, (uint32_t) ((size_t) received / sizeof(CFF_RB_T)));
+        cff_mux_schedule(stream);
+    }
+    else if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        // End of file or a failed link, the data received so far stays in the ring buffer
+        epoll_ctl(mux->epoll_fd, EPOLL_CTL_DEL, stream->fd, NULL);
+        __atomic_store_n(&stream->fd, -1, __ATOMIC_RELEASE);
+    }
+}
+
+cff_error_en_t cff_mux_poll(cff_mux_t *mux, int timeout_ms)
+{
+    if (mux == NULL) {
+        return cff_error_null_pointer;
+    }
+
+    struct epoll_event events[CFF_MUX_POLL_EVENTS];
+    int ready = epoll_wait(mux->epoll_fd, events, CFF_MUX_POLL_EVENTS, timeout_ms);
+    if (ready < 0) {
+        return errno == EINTR ? cff_error_none : cff_error_invalid_state;
+    }
+
+    for (int i = 0; i < ready; i++) {
+        cff_mux_read_stream(mux, (cff_mux_stream_t *) events[i].data.ptr);
+    }
+
+    return cff_error_none;
+}
+
+void cff_mux_wait_idle(cff_mux_t *mux)
+{
+    if (mux == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&mux->lock);
+    while (mux->active_streams != 0) {
+        pthread_cond_wait(&mux->idle, &mux->lock);
+    }
+    pthread_mutex_unlock(&mux->lock);
+}
+
+#else
+
+bool cff_mux_supported(void)
+{
+    return false;
+}
+
+cff_error_en_t cff_mux_create(cff_mux_t **mux, size_t worker_count)
+{
+    (void) worker_count;
+    if (mux == NULL) {
+        return cff_error_null_pointer;
+    }
+    *mux = NULL;
+    return cff_error_not_supported;
+}
+
+void cff_mux_destroy(cff_mux_t *mux)
+{
+    (void) mux;
+}
+
+cff_error_en_t cff_mux_add_stream(cff_mux_t *mux, int fd, uint32_t ring_buffer_size, cff_callback_ex_t callback,
+                                  void *user, cff_mux_stream_t **stream)
+{
+    (void) fd;
+    (void) ring_buffer_size;
+    (void) callback;
+    (void) user;
+    (void) stream;
+    return mux == NULL ? cff_error_null_pointer : cff_error_not_supported;
+}
+
+cff_error_en_t cff_mux_remove_stream(cff_mux_t *mux, cff_mux_stream_t *stream)
+{
+    (void) stream;
+    return mux == NULL ? cff_error_null_pointer : cff_error_not_supported;
+}
+
+cff_error_en_t cff_mux_feed(cff_mux_stream_t *stream, const uint8_t *data, uint32_t data_size_bytes)
+{
+    (void) data;
+    (void) data_size_bytes;
+    return stream == NULL ? cff_error_null_pointer : cff_error_not_supported;
+}
+
+cff_error_en_t cff_mux_poll(cff_mux_t *mux, int timeout_ms)
+{
+    (void) timeout_ms;
+    return mux == NULL ? cff_error_null_pointer : cff_error_not_supported;
+}
+
+void cff_mux_wait_idle(cff_mux_t *mux)
+{
+    (void) mux;
+}
+
+#endif
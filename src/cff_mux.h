@@ -0,0 +1,138 @@
+//! @file cff_mux.h
+//! @brief Multi-stream demultiplexer for hosts terminating many links
+//! @author Richard Keelan
+//! @date 2025
+//! @copyright MIT License
+//!
+//! Owns a ring buffer and a resumable parser per stream. A single reader thread calls cff_mux_poll(), which waits on
+//! all stream file descriptors with epoll and reads whatever arrived straight into the ring buffers. Streams with new
+//! data are scheduled onto a fixed pool of worker threads that parse them and deliver frames through each stream's
+//! callback. Every worker has its own queue and steals from the others when it runs dry, so a few hot links keep the
+//! whole pool busy. A stream is never parsed by two workers at once, so its callback sees frames in order. Available on
+//! Linux. Unlike the core library, this module allocates memory and starts threads.
+
+// MIT License
+
+// Copyright (c) 2025 Richard Keelan
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef _CFF_MUX_H_
+#define _CFF_MUX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "cff.h"
+
+//! @defgroup cff_mux CFF Multi-Stream Demultiplexer
+//! @brief Parse many links on a fixed pool of worker threads
+//! @{
+
+//! @brief Maximum number of worker threads of a multiplexer
+#define CFF_MUX_MAX_WORKERS 64
+
+//! @brief Opaque multiplexer, created with cff_mux_create()
+typedef struct cff_mux_t cff_mux_t;
+
+//! @brief Opaque stream owned by a multiplexer, created with cff_mux_add_stream()
+typedef struct cff_mux_stream_t cff_mux_stream_t;
+
+//! @brief Check whether the multiplexer is supported on this platform
+//!
+//! @return true if cff_mux_create() can succeed
+bool cff_mux_supported(void);
+
+//! @brief Create a multiplexer and start its worker threads
+//!
+//! @param mux Receives the new multiplexer
+//! @param worker_count Number of worker threads, 1 to CFF_MUX_MAX_WORKERS
+//! @return cff_error_none on success, cff_error_not_supported if the platform has no support or worker_count is out of
+//!         range, cff_error_out_of_memory if memory or threads could not be allocated, error code on failure
+cff_error_en_t cff_mux_create(cff_mux_t **mux, size_t worker_count);
+
+//! @brief Stop the worker threads and release the multiplexer and all of its streams
+//!
+//! Frames that were received but not yet parsed are dropped. File descriptors are not closed.
+//!
+//! @param mux Multiplexer created with cff_mux_create(), may be NULL
+void cff_mux_destroy(cff_mux_t *mux);
+
+//! @brief Add a stream to a multiplexer
+//!
+//! If fd is not negative it is switched to non-blocking mode and registered with cff_mux_poll(). Otherwise data is
+//! supplied with cff_mux_feed(). The callback is called on a worker thread, never concurrently for the same stream.
+//! Returning cff_callback_stop leaves the remaining frames in the ring buffer until more data arrives.
+//!
+//! @param mux Multiplexer created with cff_mux_create()
+//! @param fd File descriptor to read from, or -1
+//! @param ring_buffer_size Size of the stream's ring buffer in bytes, at least CFF_MIN_FRAME_SIZE_BYTES
+//! @param callback Callback function to call for each parsed frame
+//! @param user User pointer passed unchanged to the callback
+//! @param stream Receives the new stream, may be NULL if the stream is only released by cff_mux_destroy()
+//! @return cff_error_none on success, cff_error_out_of_memory if the stream could not be allocated or registered,
+//!         error code on failure
+cff_error_en_t cff_mux_add_stream(cff_mux_t *mux, int fd, uint32_t ring_buffer_size, cff_callback_ex_t callback,
+                                  void *user, cff_mux_stream_t **stream);
+
+//! @brief Remove a stream from its multiplexer and release it
+//!
+//! Waits for a worker that is parsing the stream to finish. Must be called from the thread that calls cff_mux_poll()
+//! and cff_mux_feed(), and not from a callback. The file descriptor is not closed.
+//!
+//! @param mux Multiplexer the stream was added to
+//! @param stream Stream to remove
+//! @return cff_error_none on success, error code on failure
+cff_error_en_t cff_mux_remove_stream(cff_mux_t *mux, cff_mux_stream_t *stream);
+
+//! @brief Append received data to a stream and schedule it for parsing
+//!
+//! For streams whose data doesn't come from a file descriptor. Only one thread may feed a given stream.
+//!
+//! @param stream Stream to append to
+//! @param data Received data
+//! @param data_size_bytes Number of bytes in data
+//! @return cff_error_none on success, cff_error_insufficient_space if the ring buffer has no room for all of the data
+//!         (nothing is appended), error code on failure
+cff_error_en_t cff_mux_feed(cff_mux_stream_t *stream, const uint8_t *data, uint32_t data_size_bytes);
+
+//! @brief Wait for data on the streams' file descriptors and schedule the streams that received any
+//!
+//! Reads at most one contiguous region per ready stream, so a fast link can't starve the others. A stream whose ring
+//! buffer is full is skipped until its worker has consumed some of it. A stream whose file descriptor reached end of
+//! file or failed is unregistered from polling but keeps its data until it is removed.
+//!
+//! @param mux Multiplexer created with cff_mux_create()
+//! @param timeout_ms Maximum time to wait in milliseconds, -1 to wait indefinitely
+//! @return cff_error_none on success or timeout, error code on failure
+cff_error_en_t cff_mux_poll(cff_mux_t *mux, int timeout_ms);
+
+//! @brief Wait until every scheduled stream has been parsed
+//!
+//! @param mux Multiplexer created with cff_mux_create()
+void cff_mux_wait_idle(cff_mux_t *mux);
+
+//! @}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _CFF_MUX_H_
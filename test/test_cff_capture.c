@@ -0,0 +1,329 @@
+#include "cff.h"
+#include "cff_capture.h"
+#include "unity.h"
+#include <stdlib.h>
+#include <string.h>
+
+// A frame as seen by either parser
+typedef struct parsed_frame_t {
+    uint16_t frame_counter;
+    uint16_t payload_size_bytes;
+    uint16_t payload_crc;
+    uint64_t offset_bytes;
+} parsed_frame_t;
+
+typedef struct frame_list_t {
+    parsed_frame_t *frames;
+    size_t count;
+    size_t capacity;
+    size_t stop_after;
+} frame_list_t;
+
+static frame_list_t serial_frames;
+static frame_list_t capture_frames;
+static uint8_t *stream;
+static const uint8_t *capture_data; // What capture_callback payloads point into
+static uint32_t random_state;
+
+static uint32_t next_random(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+
+static void frame_list_push(frame_list_t *list, const cff_frame_t *frame, uint64_t offset_bytes)
+{
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity == 0 ? 1024 : 2 * list->capacity;
+        list->frames = (parsed_frame_t *) realloc(list->frames, list->capacity * sizeof(parsed_frame_t));
+        TEST_ASSERT_NOT_NULL(list->frames);
+    }
+    parsed_frame_t *entry = &list->frames[list->count++];
+    entry->frame_counter = frame->header.frame_counter;
+    entry->payload_size_bytes = (uint16_t) frame->payload_size_bytes;
+    entry->payload_crc = frame->payload_crc;
+    entry->offset_bytes = offset_bytes;
+}
+
+static cff_callback_result_en_t serial_callback(const cff_frame_t *frame, void *user)
+{
+    frame_list_push((frame_list_t *) user, frame, 0);
+    return cff_callback_continue;
+}
+
+static cff_callback_result_en_t capture_callback(const cff_frame_t *frame, uint64_t offset_bytes, void *user)
+{
+    frame_list_t *list = (frame_list_t *) user;
+
+    // The payload points into the capture, so the payload CRC can be checked there
+    uint16_t payload_crc = cff_crc16_begin();
+    if (frame->payload_size_bytes > 0) {
+        payload_crc = cff_crc16_update(payload_crc, frame->payload, frame->payload_size_bytes);
+    }
+    TEST_ASSERT_EQUAL_HEX16(frame->payload_crc, cff_crc16_finish(payload_crc));
+    TEST_ASSERT_EQUAL_PTR(&capture_data[offset_bytes + CFF_HEADER_SIZE_BYTES], frame->payload);
+
+    frame_list_push(list, frame, offset_bytes);
+    return list->count == list->stop_after ? cff_callback_stop : cff_callback_continue;
+}
+
+// Stream the data through a resumable parser the way a receiver would
+static void parse_serially(const uint8_t *data, size_t data_size_bytes)
+{
+    static uint8_t ring_storage[128 * 1024];
+    cff_ring_buffer_t ring_buffer;
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+    cff_parser_t parser;
+    cff_parser_init(&parser, &ring_buffer);
+
+    size_t appended = 0;
+    while (appended < data_size_bytes) {
+        uint32_t size = (uint32_t) CFF_MIN(CFF_MIN(4096u, data_size_bytes - appended),
+                                           cff_ring_buffer_free_space(&ring_buffer));
+        TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_append(&ring_buffer, &data[appended], size));
+        appended += size;
+        cff_parser_parse_frames_ex(&parser, serial_callback, &serial_frames);
+    }
+}
+
+static void assert_matches_serial_parse(void)
+{
+    TEST_ASSERT_EQUAL(serial_frames.count, capture_frames.count);
+    for (size_t i = 0; i < serial_frames.count; i++) {
+        TEST_ASSERT_EQUAL(serial_frames.frames[i].frame_counter, capture_frames.frames[i].frame_counter);
+        TEST_ASSERT_EQUAL(serial_frames.frames[i].payload_size_bytes, capture_frames.frames[i].payload_size_bytes);
+        TEST_ASSERT_EQUAL(serial_frames.frames[i].payload_crc, capture_frames.frames[i].payload_crc);
+    }
+}
+
+static size_t append_frame(uint8_t *buffer, uint16_t counter, const uint8_t *payload, size_t payload_size)
+{
+    cff_frame_builder_t builder;
+    size_t frame_size = cff_calculate_frame_size_bytes(payload_size);
+    cff_frame_builder_init(&builder, buffer, frame_size);
+    builder.frame_counter = counter;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_build_frame(&builder, payload, payload_size));
+    return frame_size;
+}
+
+// Build a hostile stream: garbage, stray and false preambles, corrupted frames, and large frames whose payloads are
+// themselves made of valid frames, so chunk boundaries regularly fall where the chunk scan goes astray
+static size_t build_noisy_stream(uint8_t *buffer, size_t buffer_size)
+{
+    static uint8_t payload[CFF_MAX_PAYLOAD_SIZE_BYTES];
+    size_t size = 0;
+    uint16_t counter = 0;
+
+    while (size + cff_calculate_frame_size_bytes(CFF_MAX_PAYLOAD_SIZE_BYTES) + 64 < buffer_size) {
+        uint32_t kind = next_random() % 8;
+        if (kind == 0) {
+            // Garbage sprinkled with preamble bytes
+            size_t garbage_size = next_random() % 48;
+            for (size_t i = 0; i < garbage_size; i++) {
+                uint32_t r = next_random() % 4;
+                buffer[size++] = r == 0 ? CFF_PREAMBLE_BYTE_0 : r == 1 ? CFF_PREAMBLE_BYTE_1 : (uint8_t) next_random();
+            }
+        }
+        else if (kind == 1) {
+            // Large frame with small frames inside its payload
+            size_t payload_size = 30000 + next_random() % 35000;
+            size_t inner = 0;
+            while (inner + 64 < payload_size) {
+                uint8_t inner_payload[40];
+                size_t inner_size = next_random() % sizeof(inner_payload);
+                memset(inner_payload, (int) next_random(), inner_size);
+                inner += append_frame(&payload[inner], (uint16_t) (0x8000 + inner), inner_payload, inner_size);
+            }
+            memset(&payload[inner], 0x11, payload_size - inner);
+            size += append_frame(&buffer[size], counter++, payload, payload_size);
+        }
+        else {
+            size_t payload_size = next_random() % (kind == 2 ? 4000 : 200);
+            for (size_t i = 0; i < payload_size; i++) {
+                payload[i] = (uint8_t) next_random();
+            }
+            size_t frame_size = append_frame(&buffer[size], counter++, payload, payload_size);
+            if (kind == 3) {
+                buffer[size + next_random() % frame_size] ^= (uint8_t) (1 + next_random() % 255); // Corrupt it
+            }
+            size += frame_size;
+        }
+    }
+    return size;
+}
+
+void setUp(void)
+{
+    memset(&serial_frames, 0, sizeof(serial_frames));
+    memset(&capture_frames, 0, sizeof(capture_frames));
+    stream = NULL;
+    capture_data = NULL;
+    random_state = 0x12345678;
+}
+
+void tearDown(void)
+{
+    free(serial_frames.frames);
+    free(capture_frames.frames);
+    free(stream);
+}
+
+void test_capture_parse_rejects_invalid_arguments(void)
+{
+    uint8_t data[4] = {0};
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_capture_parse(NULL, 4, 1, capture_callback, NULL, NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_capture_parse(data, 4, 1, NULL, NULL, NULL));
+    TEST_ASSERT_EQUAL(cff_error_not_supported, cff_capture_parse(data, 4, 0, capture_callback, NULL, NULL));
+    TEST_ASSERT_EQUAL(cff_error_not_supported,
+                      cff_capture_parse(data, 4, CFF_CAPTURE_MAX_THREADS + 1, capture_callback, NULL, NULL));
+
+    uint64_t frames_parsed = 1;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_capture_parse(NULL, 0, 1, capture_callback, NULL, &frames_parsed));
+    TEST_ASSERT_EQUAL(0, frames_parsed);
+}
+
+void test_capture_parse_matches_serial_parse_of_noisy_stream(void)
+{
+    const size_t buffer_size = 6 * 1024 * 1024;
+    stream = (uint8_t *) malloc(buffer_size);
+    TEST_ASSERT_NOT_NULL(stream);
+    size_t stream_size = build_noisy_stream(stream, buffer_size);
+    capture_data = stream;
+
+    parse_serially(stream, stream_size);
+    TEST_ASSERT_GREATER_THAN(500, serial_frames.count);
+
+    const size_t thread_counts[] = {1, 2, 3, 8};
+    for (size_t i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+        capture_frames.count = 0;
+        uint64_t frames_parsed = 0;
+        TEST_ASSERT_EQUAL(cff_error_none, cff_capture_parse(stream, stream_size, thread_counts[i], capture_callback,
+                                                            &capture_frames, &frames_parsed));
+        TEST_ASSERT_EQUAL(capture_frames.count, frames_parsed);
+        assert_matches_serial_parse();
+    }
+}
+
+// Build a frame whose payload ends with the header of a valid frame that overlaps the end of the outer frame. Parsed
+// from inside the outer payload, the overlapping frame is accepted and the outer frame's end is skipped.
+static size_t append_overlapping_frames(uint8_t *buffer, uint16_t counter)
+{
+    uint8_t payload[2000];
+    memset(payload, 0x11, sizeof(payload));
+    const size_t inner_start = 1900;
+    const uint16_t inner_payload_size = 104; // Rest of the outer payload, outer payload CRC, 10 bytes of garbage
+
+    uint8_t *inner = &payload[inner_start];
+    inner[0] = CFF_PREAMBLE_BYTE_0;
+    inner[1] = CFF_PREAMBLE_BYTE_1;
+    inner[2] = 0xEF;
+    inner[3] = 0xBE;
+    inner[4] = (uint8_t) inner_payload_size;
+    inner[5] = (uint8_t) (inner_payload_size >> 8);
+    uint16_t header_crc;
+    cff_crc16(inner, 6, &header_crc);
+    inner[6] = (uint8_t) header_crc;
+    inner[7] = (uint8_t) (header_crc >> 8);
+
+    size_t size = append_frame(buffer, counter, payload, sizeof(payload));
+    memset(&buffer[size], 0x22, 10);
+    size += 10;
+
+    uint16_t inner_payload_crc;
+    size_t inner_offset = CFF_HEADER_SIZE_BYTES + inner_start;
+    cff_crc16(&buffer[inner_offset + CFF_HEADER_SIZE_BYTES], inner_payload_size, &inner_payload_crc);
+    buffer[size++] = (uint8_t) inner_payload_crc;
+    buffer[size++] = (uint8_t) (inner_payload_crc >> 8);
+
+    return size + append_frame(&buffer[size], (uint16_t) (counter + 1), (const uint8_t *) "next", 4);
+}
+
+void test_capture_parse_resyncs_where_chunk_scan_goes_astray(void)
+{
+    const size_t buffer_size = 3 * 1024 * 1024;
+    stream = (uint8_t *) malloc(buffer_size);
+    TEST_ASSERT_NOT_NULL(stream);
+    capture_data = stream;
+
+    // Chunks start at multiples of 1 MiB. Pad the start so those fall early in an outer payload.
+    uint8_t sample[4096];
+    size_t group_size = append_overlapping_frames(sample, 0);
+    size_t stream_size = group_size - (1024 * 1024) % group_size + 100;
+    memset(stream, 0x33, stream_size);
+    uint16_t counter = 0;
+    while (stream_size + group_size < buffer_size) {
+        stream_size += append_overlapping_frames(&stream[stream_size], counter);
+        counter = (uint16_t) (counter + 2);
+    }
+
+    parse_serially(stream, stream_size);
+    TEST_ASSERT_EQUAL(counter, serial_frames.count);
+
+    TEST_ASSERT_EQUAL(cff_error_none,
+                      cff_capture_parse(stream, stream_size, 2, capture_callback, &capture_frames, NULL));
+    assert_matches_serial_parse();
+}
+
+void test_capture_parse_stops_at_trailing_incomplete_frame(void)
+{
+    // A frame claiming a large payload, cut short, with valid frames in the part that is present
+    const size_t buffer_size = 3 * 1024 * 1024;
+    stream = (uint8_t *) malloc(buffer_size);
+    TEST_ASSERT_NOT_NULL(stream);
+    size_t stream_size = build_noisy_stream(stream, buffer_size - 70000);
+    capture_data = stream;
+
+    static uint8_t payload[60000];
+    size_t inner = 0;
+    while (inner + 64 < sizeof(payload)) {
+        inner += append_frame(&payload[inner], 7, (const uint8_t *) "inner", 5);
+    }
+    append_frame(&stream[stream_size], 1, payload, sizeof(payload));
+    stream_size += CFF_HEADER_SIZE_BYTES + 20000;
+
+    parse_serially(stream, stream_size);
+    TEST_ASSERT_EQUAL(cff_error_none,
+                      cff_capture_parse(stream, stream_size, 4, capture_callback, &capture_frames, NULL));
+    assert_matches_serial_parse();
+    TEST_ASSERT_NOT_EQUAL(7, capture_frames.frames[capture_frames.count - 1].frame_counter);
+}
+
+void test_capture_parse_stops_when_callback_asks(void)
+{
+    const size_t buffer_size = 3 * 1024 * 1024;
+    stream = (uint8_t *) malloc(buffer_size);
+    TEST_ASSERT_NOT_NULL(stream);
+    size_t stream_size = build_noisy_stream(stream, buffer_size);
+    capture_data = stream;
+
+    capture_frames.stop_after = 5;
+    uint64_t frames_parsed = 0;
+    TEST_ASSERT_EQUAL(cff_error_none,
+                      cff_capture_parse(stream, stream_size, 4, capture_callback, &capture_frames, &frames_parsed));
+    TEST_ASSERT_EQUAL(5, frames_parsed);
+    TEST_ASSERT_EQUAL(5, capture_frames.count);
+}
+
+void test_capture_open_parses_recorded_stream(void)
+{
+    if (!cff_capture_supported()) {
+        TEST_IGNORE_MESSAGE("Capture files are not supported on this platform");
+    }
+
+    cff_capture_t capture;
+    TEST_ASSERT_EQUAL(cff_error_io, cff_capture_open(&capture, "test/support/does_not_exist.bin"));
+    // Opens, but a directory can't be mapped
+    TEST_ASSERT_EQUAL(cff_error_io, cff_capture_open(&capture, "test/support"));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_capture_open(&capture, "test/support/stream.bin"));
+    capture_data = capture.data;
+
+    parse_serially(capture.data, (size_t) capture.size_bytes);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_capture_parse(capture.data, capture.size_bytes, 2, capture_callback,
+                                                        &capture_frames, NULL));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_capture_close(&capture));
+
+    TEST_ASSERT_GREATER_THAN(0, serial_frames.count);
+    assert_matches_serial_parse();
+}
@@ -2,14 +2,55 @@
 #include "unity.h"
 #include <string.h>
 
+// Test CRC provider that stands in for a CRC peripheral
+typedef struct {
+    int begin_calls;
+    int update_calls;
+    int finish_calls;
+    size_t bytes_processed;
+} mock_crc_peripheral_t;
+
+static mock_crc_peripheral_t mock_peripheral;
+
+static uint16_t mock_crc_begin(void *context)
+{
+    ((mock_crc_peripheral_t *) context)->begin_calls++;
+    return CFF_CRC_INIT;
+}
+
+static uint16_t mock_crc_update(void *context, uint16_t crc, const uint8_t *data, size_t data_size_bytes)
+{
+    mock_crc_peripheral_t *peripheral = (mock_crc_peripheral_t *) context;
+    peripheral->update_calls++;
+    peripheral->bytes_processed += data_size_bytes;
+
+    // Bit-at-a-time implementation, independent of the library's tables
+    for (size_t i = 0; i < data_size_bytes; i++) {
+        crc ^= (uint16_t) (data[i] << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ CFF_CRC_POLYNOMIAL) : (uint16_t) (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t mock_crc_finish(void *context, uint16_t crc)
+{
+    ((mock_crc_peripheral_t *) context)->finish_calls++;
+    return crc;
+}
+
+static const cff_crc_provider_t mock_provider = {mock_crc_begin, mock_crc_update, mock_crc_finish, &mock_peripheral};
+
 void setUp(void)
 {
-    // Set up code to run before each test
+    memset(&mock_peripheral, 0, sizeof(mock_peripheral));
 }
 
 void tearDown(void)
 {
-    // Clean up code to run after each test
+    // Always restore the software implementation so other tests are unaffected
+    cff_crc_set_provider(NULL);
 }
 
 void test_crc16_known_test_vector(void)
@@ -80,3 +121,225 @@ void test_crc16_different_lengths(void)
     TEST_ASSERT_EQUAL(cff_error_none, result2);
     TEST_ASSERT_NOT_EQUAL(crc_short, crc_long);
 }
+
+static const cff_crc_backend_en_t all_backends[] = {cff_crc_backend_bytewise, cff_crc_backend_slicing_by_4,
+                                                    cff_crc_backend_slicing_by_8, cff_crc_backend_clmul};
+static const size_t num_backends = sizeof(all_backends) / sizeof(all_backends[0]);
+
+void test_crc16_bytewise_backend_always_available(void)
+{
+    TEST_ASSERT_EQUAL(true, cff_crc16_backend_available(cff_crc_backend_bytewise));
+}
+
+void test_crc16_known_test_vector_all_backends(void)
+{
+    const char *test_data = "123456789";
+
+    for (size_t i = 0; i < num_backends; i++) {
+        if (!cff_crc16_backend_available(all_backends[i])) {
+            continue;
+        }
+
+        uint16_t crc;
+        cff_error_en_t result = cff_crc16_with_backend(all_backends[i], (const uint8_t *) test_data, strlen(test_data),
+                                                       &crc);
+
+        TEST_ASSERT_EQUAL(cff_error_none, result);
+        TEST_ASSERT_EQUAL_HEX16(0x29B1, crc);
+    }
+}
+
+void test_crc16_empty_data_all_backends(void)
+{
+    for (size_t i = 0; i < num_backends; i++) {
+        if (!cff_crc16_backend_available(all_backends[i])) {
+            continue;
+        }
+
+        uint16_t crc;
+        cff_error_en_t result = cff_crc16_with_backend(all_backends[i], (const uint8_t *) "", 0, &crc);
+
+        TEST_ASSERT_EQUAL(cff_error_none, result);
+        TEST_ASSERT_EQUAL_HEX16(CFF_CRC_INIT, crc);
+    }
+}
+
+void test_crc16_all_backends_match_reference(void)
+{
+    // Cover every tail length and alignment around the 4, 8, 16 and 64 byte strides used by the faster backends
+    uint8_t test_data[1024 + 16];
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < sizeof(test_data); i++) {
+        seed = seed * 1103515245 + 12345;
+        test_data[i] = (uint8_t) (seed >> 16);
+    }
+
+    for (size_t offset = 0; offset < 16; offset += 3) {
+        for (size_t length = 0; length <= 1024; length += (length < 300 ? 1 : 61)) {
+            uint16_t reference_crc;
+            cff_crc16_with_backend(cff_crc_backend_bytewise, test_data + offset, length, &reference_crc);
+
+            uint16_t default_crc;
+            TEST_ASSERT_EQUAL(cff_error_none, cff_crc16(test_data + offset, length, &default_crc));
+            TEST_ASSERT_EQUAL_HEX16(reference_crc, default_crc);
+
+            for (size_t i = 0; i < num_backends; i++) {
+                if (!cff_crc16_backend_available(all_backends[i])) {
+                    continue;
+                }
+
+                uint16_t crc;
+                TEST_ASSERT_EQUAL(cff_error_none,
+                                  cff_crc16_with_backend(all_backends[i], test_data + offset, length, &crc));
+                TEST_ASSERT_EQUAL_HEX16(reference_crc, crc);
+            }
+        }
+    }
+}
+
+void test_crc16_with_backend_null_pointer(void)
+{
+    uint16_t crc;
+    uint8_t data = 0;
+
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_crc16_with_backend(cff_crc_backend_bytewise, NULL, 1, &crc));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_crc16_with_backend(cff_crc_backend_bytewise, &data, 1, NULL));
+}
+
+void test_crc16_with_backend_unavailable(void)
+{
+    uint16_t crc;
+    uint8_t data = 0;
+
+    cff_error_en_t result = cff_crc16_with_backend((cff_crc_backend_en_t) 99, &data, 1, &crc);
+
+    TEST_ASSERT_EQUAL(cff_error_not_supported, result);
+}
+
+void test_crc16_ring_buffer_wraparound_matches_linear(void)
+{
+    uint8_t test_data[200];
+    for (size_t i = 0; i < sizeof(test_data); i++) {
+        test_data[i] = (uint8_t) (i * 7 + 3);
+    }
+
+    uint16_t expected_crc;
+    cff_crc16(test_data, sizeof(test_data), &expected_crc);
+
+    // Push the consume index most of the way through the storage so the data wraps around
+    uint8_t ring_storage[256];
+    cff_ring_buffer_t ring_buffer;
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+    uint8_t filler[180] = {0};
+    cff_ring_buffer_append(&ring_buffer, filler, sizeof(filler));
+    cff_ring_buffer_advance(&ring_buffer, sizeof(filler));
+    cff_ring_buffer_append(&ring_buffer, test_data, sizeof(test_data));
+
+    uint16_t actual_crc;
+    cff_error_en_t result = cff_crc16_ring_buffer(&ring_buffer, 0, sizeof(test_data), &actual_crc);
+
+    TEST_ASSERT_EQUAL(cff_error_none, result);
+    TEST_ASSERT_EQUAL_HEX16(expected_crc, actual_crc);
+}
+
+void test_crc_set_provider_rejects_incomplete_provider(void)
+{
+    cff_crc_provider_t incomplete_provider = {mock_crc_begin, NULL, mock_crc_finish, &mock_peripheral};
+
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_crc_set_provider(&incomplete_provider));
+}
+
+void test_crc16_routes_through_provider(void)
+{
+    const char *test_data = "123456789";
+    TEST_ASSERT_EQUAL(cff_error_none, cff_crc_set_provider(&mock_provider));
+
+    uint16_t crc;
+    cff_error_en_t result = cff_crc16((const uint8_t *) test_data, strlen(test_data), &crc);
+
+    TEST_ASSERT_EQUAL(cff_error_none, result);
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, crc);
+    TEST_ASSERT_EQUAL(1, mock_peripheral.begin_calls);
+    TEST_ASSERT_EQUAL(1, mock_peripheral.update_calls);
+    TEST_ASSERT_EQUAL(1, mock_peripheral.finish_calls);
+    TEST_ASSERT_EQUAL(strlen(test_data), mock_peripheral.bytes_processed);
+}
+
+void test_crc16_incremental_matches_single_shot(void)
+{
+    const char *test_data = "123456789";
+
+    uint16_t crc = cff_crc16_begin();
+    crc = cff_crc16_update(crc, (const uint8_t *) test_data, 4);
+    crc = cff_crc16_update(crc, (const uint8_t *) test_data + 4, 5);
+    crc = cff_crc16_finish(crc);
+
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, crc);
+}
+
+void test_crc16_ring_buffer_feeds_provider_both_segments(void)
+{
+    uint8_t test_data[40];
+    for (size_t i = 0; i < sizeof(test_data); i++) {
+        test_data[i] = (uint8_t) (i + 1);
+    }
+
+    uint16_t expected_crc;
+    cff_crc16(test_data, sizeof(test_data), &expected_crc);
+
+    uint8_t ring_storage[64];
+    cff_ring_buffer_t ring_buffer;
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+    uint8_t filler[50] = {0};
+    cff_ring_buffer_append(&ring_buffer, filler, sizeof(filler));
+    cff_ring_buffer_advance(&ring_buffer, sizeof(filler));
+    cff_ring_buffer_append(&ring_buffer, test_data, sizeof(test_data));
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_crc_set_provider(&mock_provider));
+
+    uint16_t actual_crc;
+    cff_error_en_t result = cff_crc16_ring_buffer(&ring_buffer, 0, sizeof(test_data), &actual_crc);
+
+    TEST_ASSERT_EQUAL(cff_error_none, result);
+    TEST_ASSERT_EQUAL_HEX16(expected_crc, actual_crc);
+    TEST_ASSERT_EQUAL(1, mock_peripheral.begin_calls);
+    TEST_ASSERT_EQUAL(2, mock_peripheral.update_calls);
+    TEST_ASSERT_EQUAL(sizeof(test_data), mock_peripheral.bytes_processed);
+}
+
+void test_build_and_parse_frame_use_provider(void)
+{
+    TEST_ASSERT_EQUAL(cff_error_none, cff_crc_set_provider(&mock_provider));
+
+    uint8_t frame_buffer[64];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+    const char *payload = "Hello";
+    TEST_ASSERT_EQUAL(cff_error_none, cff_build_frame(&builder, (const uint8_t *) payload, strlen(payload)));
+
+    // Header CRC and payload CRC
+    TEST_ASSERT_EQUAL(2, mock_peripheral.finish_calls);
+
+    uint8_t ring_storage[64];
+    cff_ring_buffer_t ring_buffer;
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+    cff_ring_buffer_append(&ring_buffer, frame_buffer, (uint32_t) cff_calculate_frame_size_bytes(strlen(payload)));
+
+    cff_frame_t frame;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_parse_frame(&ring_buffer, &frame));
+    TEST_ASSERT_EQUAL(4, mock_peripheral.finish_calls);
+}
+
+void test_crc16_table_matches_bitwise_calculation(void)
+{
+    // Every entry of the precomputed table is reached by some single-byte input
+    for (int value = 0; value < 256; value++) {
+        uint8_t byte = (uint8_t) value;
+        uint16_t expected_crc = mock_crc_update(&mock_peripheral, CFF_CRC_INIT, &byte, 1);
+
+        uint16_t actual_crc;
+        cff_crc16(&byte, 1, &actual_crc);
+
+        TEST_ASSERT_EQUAL_HEX16(expected_crc, actual_crc);
+    }
+}
@@ -358,3 +358,301 @@ void test_zero_and_max_counter_values(void)
     TEST_ASSERT_EQUAL(cff_error_none, parse_result2);
     TEST_ASSERT_EQUAL(65535, frame2.header.frame_counter);
 }
+
+// Concatenate the segments of a scatter-gather frame, as writev() would put them on the wire
+static size_t gather_segments(const cff_span_t segments[CFF_FRAME_SEGMENT_COUNT], uint8_t *buffer)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < CFF_FRAME_SEGMENT_COUNT; i++) {
+        if (segments[i].size_bytes > 0) {
+            memcpy(buffer + size, segments[i].data, segments[i].size_bytes);
+        }
+        size += segments[i].size_bytes;
+    }
+    return size;
+}
+
+void test_build_frame_segments_null_pointers(void)
+{
+    uint8_t frame_buffer[CFF_MIN_FRAME_SIZE_BYTES];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+    cff_span_t segments[CFF_FRAME_SEGMENT_COUNT];
+    const uint8_t payload[4] = {1, 2, 3, 4};
+
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_build_frame_segments(NULL, payload, 4, segments));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_build_frame_segments(&builder, NULL, 4, segments));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_build_frame_segments(&builder, payload, 4, NULL));
+    TEST_ASSERT_EQUAL(cff_error_payload_too_large,
+                      cff_build_frame_segments(&builder, payload, CFF_MAX_PAYLOAD_SIZE_BYTES + 1, segments));
+    TEST_ASSERT_EQUAL(0, builder.frame_counter);
+}
+
+void test_build_frame_segments_matches_build_frame(void)
+{
+    // The payload is much larger than the builder's buffer, which only needs room for the header and payload CRC
+    static uint8_t payload[60 * 1024];
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t) (i * 31 + 7);
+    }
+    uint8_t small_buffer[CFF_MIN_FRAME_SIZE_BYTES];
+    cff_frame_builder_t segment_builder;
+    cff_frame_builder_init(&segment_builder, small_buffer, sizeof(small_buffer));
+
+    static uint8_t full_buffer[sizeof(payload) + CFF_MIN_FRAME_SIZE_BYTES];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, full_buffer, sizeof(full_buffer));
+
+    static uint8_t gathered[sizeof(full_buffer)];
+    const size_t payload_sizes[] = {0, 1, 100, sizeof(payload)};
+    for (size_t i = 0; i < sizeof(payload_sizes) / sizeof(payload_sizes[0]); i++) {
+        cff_span_t segments[CFF_FRAME_SEGMENT_COUNT];
+        TEST_ASSERT_EQUAL(cff_error_none,
+                          cff_build_frame_segments(&segment_builder, payload, payload_sizes[i], segments));
+        TEST_ASSERT_EQUAL(cff_error_none, cff_build_frame(&builder, payload, payload_sizes[i]));
+
+        // The payload segment is the caller's buffer, not a copy
+        TEST_ASSERT_EQUAL_PTR(payload, segments[1].data);
+        TEST_ASSERT_EQUAL(CFF_HEADER_SIZE_BYTES, segments[0].size_bytes);
+        TEST_ASSERT_EQUAL(CFF_PAYLOAD_CRC_SIZE_BYTES, segments[2].size_bytes);
+
+        size_t frame_size = gather_segments(segments, gathered);
+        TEST_ASSERT_EQUAL(cff_calculate_frame_size_bytes(payload_sizes[i]), frame_size);
+        TEST_ASSERT_EQUAL_MEMORY(full_buffer, gathered, frame_size);
+    }
+    TEST_ASSERT_EQUAL(4, segment_builder.frame_counter);
+}
+
+void test_build_frame_segments_empty_payload_without_pointer(void)
+{
+    uint8_t frame_buffer[CFF_MIN_FRAME_SIZE_BYTES];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+    cff_span_t segments[CFF_FRAME_SEGMENT_COUNT];
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_build_frame_segments(&builder, NULL, 0, segments));
+
+    uint8_t gathered[CFF_MIN_FRAME_SIZE_BYTES];
+    size_t frame_size = gather_segments(segments, gathered);
+    uint8_t ring_storage[32];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), gathered, frame_size);
+
+    cff_frame_t frame;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_parse_frame(&ring_buffer, &frame));
+    TEST_ASSERT_EQUAL(0, frame.payload_size_bytes);
+}
+
+void test_frame_builder_payload_null_pointers(void)
+{
+    uint8_t frame_buffer[32];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+    uint8_t *payload;
+    size_t capacity;
+
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_builder_payload(NULL, &payload, &capacity));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_builder_payload(&builder, NULL, &capacity));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_builder_payload(&builder, &payload, NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_finalize_frame(NULL, 0));
+}
+
+void test_frame_builder_payload_slot_and_capacity(void)
+{
+    uint8_t frame_buffer[32];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+    uint8_t *payload;
+    size_t capacity;
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_payload(&builder, &payload, &capacity));
+    TEST_ASSERT_EQUAL_PTR(&frame_buffer[CFF_HEADER_SIZE_BYTES], payload);
+    TEST_ASSERT_EQUAL(sizeof(frame_buffer) - CFF_MIN_FRAME_SIZE_BYTES, capacity);
+
+    // Writing past the capacity is rejected without touching the counter
+    TEST_ASSERT_EQUAL(cff_error_buffer_too_small, cff_finalize_frame(&builder, capacity + 1));
+    TEST_ASSERT_EQUAL(cff_error_payload_too_large, cff_finalize_frame(&builder, CFF_MAX_PAYLOAD_SIZE_BYTES + 1));
+    TEST_ASSERT_EQUAL(0, builder.frame_counter);
+
+    // The capacity never exceeds the largest payload the format allows
+    static uint8_t large_buffer[CFF_MAX_PAYLOAD_SIZE_BYTES + 100];
+    cff_frame_builder_init(&builder, large_buffer, sizeof(large_buffer));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_payload(&builder, &payload, &capacity));
+    TEST_ASSERT_EQUAL(CFF_MAX_PAYLOAD_SIZE_BYTES, capacity);
+}
+
+void test_finalize_frame_matches_build_frame(void)
+{
+    const char *message = "Encoded in place";
+    size_t message_size = strlen(message);
+
+    uint8_t in_place_buffer[64];
+    cff_frame_builder_t in_place_builder;
+    cff_frame_builder_init(&in_place_builder, in_place_buffer, sizeof(in_place_buffer));
+    uint8_t copy_buffer[64];
+    cff_frame_builder_t copy_builder;
+    cff_frame_builder_init(&copy_builder, copy_buffer, sizeof(copy_buffer));
+
+    for (int i = 0; i < 3; i++) {
+        uint8_t *payload;
+        size_t capacity;
+        cff_frame_builder_payload(&in_place_builder, &payload, &capacity);
+        memcpy(payload, message, message_size);
+        TEST_ASSERT_EQUAL(cff_error_none, cff_finalize_frame(&in_place_builder, message_size));
+
+        cff_build_frame(&copy_builder, (const uint8_t *) message, message_size);
+        TEST_ASSERT_EQUAL_MEMORY(copy_buffer, in_place_buffer, cff_calculate_frame_size_bytes(message_size));
+    }
+    TEST_ASSERT_EQUAL(3, in_place_builder.frame_counter);
+}
+
+void test_frame_builder_streaming_null_pointers_and_state(void)
+{
+    uint8_t frame_buffer[32];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+    const uint8_t data[4] = {1, 2, 3, 4};
+
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_builder_begin(NULL, 4));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_builder_append(NULL, data, 4));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_builder_end(NULL));
+
+    // Nothing to append to or end before a frame is begun
+    TEST_ASSERT_EQUAL(cff_error_invalid_state, cff_frame_builder_append(&builder, data, 4));
+    TEST_ASSERT_EQUAL(cff_error_invalid_state, cff_frame_builder_end(&builder));
+
+    TEST_ASSERT_EQUAL(cff_error_buffer_too_small, cff_frame_builder_begin(&builder, sizeof(frame_buffer)));
+    TEST_ASSERT_EQUAL(cff_error_payload_too_large, cff_frame_builder_begin(&builder, CFF_MAX_PAYLOAD_SIZE_BYTES + 1));
+
+    // Appended data must add up to exactly the declared size
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_begin(&builder, 6));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_builder_append(&builder, NULL, 4));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_append(&builder, data, 4));
+    TEST_ASSERT_EQUAL(cff_error_payload_too_large, cff_frame_builder_append(&builder, data, 3));
+    TEST_ASSERT_EQUAL(cff_error_incomplete_frame, cff_frame_builder_end(&builder));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_append(&builder, data, 2));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_end(&builder));
+    TEST_ASSERT_EQUAL(cff_error_invalid_state, cff_frame_builder_end(&builder));
+    TEST_ASSERT_EQUAL(1, builder.frame_counter);
+}
+
+void test_frame_builder_streaming_matches_build_frame(void)
+{
+    // A packet assembled from a header struct, sample blocks and a trailer
+    uint8_t packet[120];
+    for (size_t i = 0; i < sizeof(packet); i++) {
+        packet[i] = (uint8_t) (i * 3 + 1);
+    }
+    const size_t piece_sizes[] = {12, 0, 50, 50, 8};
+
+    uint8_t streaming_buffer[160];
+    cff_frame_builder_t streaming_builder;
+    cff_frame_builder_init(&streaming_builder, streaming_buffer, sizeof(streaming_buffer));
+    uint8_t expected_buffer[160];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, expected_buffer, sizeof(expected_buffer));
+
+    for (int frame = 0; frame < 2; frame++) {
+        TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_begin(&streaming_builder, sizeof(packet)));
+        size_t offset = 0;
+        for (size_t i = 0; i < sizeof(piece_sizes) / sizeof(piece_sizes[0]); i++) {
+            cff_error_en_t result = cff_frame_builder_append(&streaming_builder, &packet[offset], piece_sizes[i]);
+            TEST_ASSERT_EQUAL(cff_error_none, result);
+            offset += piece_sizes[i];
+        }
+        TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_end(&streaming_builder));
+
+        cff_build_frame(&builder, packet, sizeof(packet));
+        TEST_ASSERT_EQUAL_MEMORY(expected_buffer, streaming_buffer, cff_calculate_frame_size_bytes(sizeof(packet)));
+    }
+}
+
+void test_frame_builder_build_frame_abandons_streaming_frame(void)
+{
+    uint8_t frame_buffer[32];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+
+    cff_frame_builder_begin(&builder, 4);
+    cff_frame_builder_append(&builder, (const uint8_t *) "ab", 2);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_build_frame(&builder, (const uint8_t *) "xyz", 3));
+
+    // The half-built frame's header was overwritten, so it can't be completed
+    TEST_ASSERT_EQUAL(cff_error_invalid_state, cff_frame_builder_end(&builder));
+    TEST_ASSERT_EQUAL(1, builder.frame_counter);
+}
+
+void test_batch_build_frame_null_pointers(void)
+{
+    uint8_t frame_buffer[32];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+    cff_span_t batch;
+
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_batch_build_frame(NULL, (const uint8_t *) "a", 1));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_batch_build_frame(&builder, NULL, 1));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_builder_batch(NULL, &batch));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_builder_batch(&builder, NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_builder_reset_batch(NULL));
+}
+
+void test_batch_build_frame_packs_frames_until_full(void)
+{
+    // Room for three 30 byte frames but not four
+    uint8_t frame_buffer[100];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+    uint8_t payload[20];
+    size_t frame_size = cff_calculate_frame_size_bytes(sizeof(payload));
+
+    for (int i = 0; i < 3; i++) {
+        memset(payload, 'A' + i, sizeof(payload));
+        TEST_ASSERT_EQUAL(cff_error_none, cff_batch_build_frame(&builder, payload, sizeof(payload)));
+    }
+    TEST_ASSERT_EQUAL(cff_error_buffer_full, cff_batch_build_frame(&builder, payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL(3, builder.frame_counter);
+
+    // A frame that could never fit is a different error
+    uint8_t large_payload[100] = {0};
+    cff_error_en_t result = cff_batch_build_frame(&builder, large_payload, sizeof(large_payload));
+    TEST_ASSERT_EQUAL(cff_error_buffer_too_small, result);
+
+    cff_span_t batch;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_batch(&builder, &batch));
+    TEST_ASSERT_EQUAL_PTR(frame_buffer, batch.data);
+    TEST_ASSERT_EQUAL(3 * frame_size, batch.size_bytes);
+
+    // The batch parses back into the same frames, in order
+    uint8_t ring_storage[128];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), batch.data, batch.size_bytes);
+    for (int i = 0; i < 3; i++) {
+        cff_frame_t frame;
+        TEST_ASSERT_EQUAL(cff_error_none, cff_parse_frame(&ring_buffer, &frame));
+        TEST_ASSERT_EQUAL(i, frame.header.frame_counter);
+        TEST_ASSERT_EQUAL_HEX8('A' + i, frame.payload[0]);
+    }
+
+    // After sending, the batch starts over at the beginning of the buffer and the counter carries on
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_reset_batch(&builder));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_batch_build_frame(&builder, payload, sizeof(payload)));
+    cff_frame_builder_batch(&builder, &batch);
+    TEST_ASSERT_EQUAL(frame_size, batch.size_bytes);
+    TEST_ASSERT_EQUAL(4, builder.frame_counter);
+}
+
+void test_build_frame_discards_batch(void)
+{
+    uint8_t frame_buffer[100];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+
+    cff_batch_build_frame(&builder, (const uint8_t *) "one", 3);
+    cff_batch_build_frame(&builder, (const uint8_t *) "two", 3);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_build_frame(&builder, (const uint8_t *) "single", 6));
+
+    cff_span_t batch;
+    cff_frame_builder_batch(&builder, &batch);
+    TEST_ASSERT_EQUAL(0, batch.size_bytes);
+    TEST_ASSERT_EQUAL(3, builder.frame_counter);
+}
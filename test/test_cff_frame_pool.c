@@ -0,0 +1,203 @@
+#include "cff.h"
+#include "unity.h"
+#include <string.h>
+
+#define SMALL_SLOTS 4
+#define SMALL_CAPACITY 16
+#define LARGE_SLOTS 2
+#define LARGE_CAPACITY 200
+
+static cff_frame_pool_t pool;
+static cff_pooled_frame_t small_slots[SMALL_SLOTS];
+static cff_pooled_frame_t large_slots[LARGE_SLOTS];
+static uint8_t small_storage[CFF_FRAME_POOL_STORAGE_SIZE_BYTES(SMALL_SLOTS, SMALL_CAPACITY)];
+static uint8_t large_storage[CFF_FRAME_POOL_STORAGE_SIZE_BYTES(LARGE_SLOTS, LARGE_CAPACITY)];
+
+static uint8_t ring_storage[256];
+static cff_ring_buffer_t ring_buffer;
+static cff_pooled_frame_t *stored[8];
+static size_t stored_count;
+
+static void store_callback(const cff_frame_t *frame)
+{
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_pool_store(&pool, frame, &stored[stored_count]));
+    stored_count++;
+}
+
+void setUp(void)
+{
+    stored_count = 0;
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_pool_init(&pool));
+    TEST_ASSERT_EQUAL(cff_error_none,
+                      cff_frame_pool_add_class(&pool, small_slots, small_storage, SMALL_SLOTS, SMALL_CAPACITY));
+    TEST_ASSERT_EQUAL(cff_error_none,
+                      cff_frame_pool_add_class(&pool, large_slots, large_storage, LARGE_SLOTS, LARGE_CAPACITY));
+}
+
+void tearDown(void)
+{
+}
+
+// Build a frame with payload_size_bytes bytes counting up from first into the ring buffer
+static void append_frame(uint16_t frame_counter, size_t payload_size_bytes, uint8_t first)
+{
+    uint8_t payload[LARGE_CAPACITY + 1];
+    uint8_t frame[LARGE_CAPACITY + 1 + CFF_MIN_FRAME_SIZE_BYTES];
+    cff_frame_builder_t builder;
+
+    for (size_t i = 0; i < payload_size_bytes; i++) {
+        payload[i] = (uint8_t) (first + i);
+    }
+    cff_frame_builder_init(&builder, frame, sizeof(frame));
+    builder.frame_counter = frame_counter;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_build_frame(&builder, payload, payload_size_bytes));
+    uint32_t frame_size_bytes = (uint32_t) cff_calculate_frame_size_bytes(payload_size_bytes);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_append(&ring_buffer, frame, frame_size_bytes));
+}
+
+static void assert_payload(const cff_pooled_frame_t *handle, size_t payload_size_bytes, uint8_t first)
+{
+    TEST_ASSERT_EQUAL(payload_size_bytes, handle->frame.payload_size_bytes);
+    for (size_t i = 0; i < payload_size_bytes; i++) {
+        TEST_ASSERT_EQUAL_HEX8((uint8_t) (first + i), handle->frame.payload[i]);
+    }
+}
+
+void test_frame_pool_null_pointers_and_class_order(void)
+{
+    cff_pooled_frame_t *handle;
+    cff_frame_t frame = {0};
+
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_pool_init(NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_pool_add_class(&pool, NULL, small_storage, 1, 1));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_pool_store(&pool, NULL, &handle));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_pool_store(&pool, &frame, NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_pooled_frame_retain(NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_pooled_frame_release(NULL));
+
+    // Both classes are in use, and classes must grow
+    TEST_ASSERT_EQUAL(cff_error_invalid_state, cff_frame_pool_add_class(&pool, small_slots, small_storage, 1, 1000));
+    cff_frame_pool_init(&pool);
+    TEST_ASSERT_EQUAL(cff_error_payload_too_large, cff_frame_pool_add_class(&pool, small_slots, small_storage, 1,
+                                                                            CFF_MAX_PAYLOAD_SIZE_BYTES + 1));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_pool_add_class(&pool, small_slots, small_storage, 1, 16));
+    TEST_ASSERT_EQUAL(cff_error_invalid_state, cff_frame_pool_add_class(&pool, large_slots, large_storage, 1, 16));
+}
+
+void test_frame_pool_frame_outlives_ring_buffer(void)
+{
+    append_frame(7, 10, 0x40);
+    append_frame(8, 150, 0x80);
+    TEST_ASSERT_EQUAL(2, cff_parse_frames(&ring_buffer, store_callback));
+
+    // Overwrite the ring buffer storage the frames were parsed from
+    memset(ring_storage, 0, sizeof(ring_storage));
+
+    TEST_ASSERT_EQUAL(7, stored[0]->frame.header.frame_counter);
+    TEST_ASSERT_EQUAL(8, stored[1]->frame.header.frame_counter);
+    assert_payload(stored[0], 10, 0x40);
+    assert_payload(stored[1], 150, 0x80);
+    TEST_ASSERT_NULL(stored[0]->frame.ring_buffer);
+    TEST_ASSERT_TRUE(stored[1]->frame.flags & CFF_FRAME_FLAG_PAYLOAD_CONTIGUOUS);
+
+    // Small and large frames go to their own classes
+    TEST_ASSERT_EQUAL(0, stored[0]->class_index);
+    TEST_ASSERT_EQUAL(1, stored[1]->class_index);
+    TEST_ASSERT_EQUAL(SMALL_SLOTS - 1, pool.classes[0].free_count);
+    TEST_ASSERT_EQUAL(LARGE_SLOTS - 1, pool.classes[1].free_count);
+
+    // The copy still verifies against its payload CRC
+    TEST_ASSERT_EQUAL(cff_error_none, cff_verify_frame_payload(&stored[1]->frame));
+}
+
+void test_frame_pool_copies_wrapped_payload(void)
+{
+    // Move the indices so the next payload wraps around the end of the storage
+    uint8_t filler[200] = {0};
+    cff_ring_buffer_append(&ring_buffer, filler, sizeof(filler));
+    cff_ring_buffer_advance(&ring_buffer, sizeof(filler));
+
+    append_frame(1, 120, 0x10);
+    TEST_ASSERT_EQUAL(1, cff_parse_frames(&ring_buffer, store_callback));
+
+    assert_payload(stored[0], 120, 0x10);
+    uint8_t copy[120];
+    TEST_ASSERT_EQUAL(cff_error_none, cff_copy_frame_payload(&stored[0]->frame, copy, sizeof(copy)));
+    TEST_ASSERT_EQUAL_MEMORY(stored[0]->frame.payload, copy, sizeof(copy));
+}
+
+void test_frame_pool_falls_back_to_larger_class(void)
+{
+    for (uint16_t i = 0; i < SMALL_SLOTS + 1; i++) {
+        append_frame(i, 4, (uint8_t) i);
+    }
+    TEST_ASSERT_EQUAL(SMALL_SLOTS + 1, cff_parse_frames(&ring_buffer, store_callback));
+
+    TEST_ASSERT_EQUAL(0, pool.classes[0].free_count);
+    TEST_ASSERT_EQUAL(1, stored[SMALL_SLOTS]->class_index);
+    assert_payload(stored[SMALL_SLOTS], 4, SMALL_SLOTS);
+}
+
+void test_frame_pool_exhausted_and_too_large(void)
+{
+    cff_pooled_frame_t *handle;
+    static cff_pooled_frame_t *large[LARGE_SLOTS];
+    cff_frame_t frame = {0};
+
+    frame.flags = CFF_FRAME_FLAG_PAYLOAD_CONTIGUOUS;
+    frame.payload = large_storage;
+    frame.payload_size_bytes = LARGE_CAPACITY + 1;
+    TEST_ASSERT_EQUAL(cff_error_payload_too_large, cff_frame_pool_store(&pool, &frame, &handle));
+
+    uint8_t payload[LARGE_CAPACITY] = {0};
+    frame.payload = payload;
+    frame.payload_size_bytes = LARGE_CAPACITY;
+    for (size_t i = 0; i < LARGE_SLOTS; i++) {
+        TEST_ASSERT_EQUAL(cff_error_none, cff_frame_pool_store(&pool, &frame, &large[i]));
+    }
+    TEST_ASSERT_EQUAL(cff_error_buffer_full, cff_frame_pool_store(&pool, &frame, &handle));
+
+    // A released slot is reused
+    TEST_ASSERT_EQUAL(cff_error_none, cff_pooled_frame_release(large[1]));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_pool_store(&pool, &frame, &handle));
+    TEST_ASSERT_EQUAL_PTR(large[1], handle);
+
+    // Small frames are still served
+    frame.payload_size_bytes = 1;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_pool_store(&pool, &frame, &handle));
+    TEST_ASSERT_EQUAL(0, handle->class_index);
+}
+
+void test_frame_pool_reference_counting(void)
+{
+    append_frame(3, 8, 0x20);
+    TEST_ASSERT_EQUAL(1, cff_parse_frames(&ring_buffer, store_callback));
+    cff_pooled_frame_t *handle = stored[0];
+
+    TEST_ASSERT_EQUAL(1, handle->reference_count);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_pooled_frame_retain(handle));
+    TEST_ASSERT_EQUAL(2, handle->reference_count);
+
+    // The slot stays in use until the last holder lets go
+    TEST_ASSERT_EQUAL(cff_error_none, cff_pooled_frame_release(handle));
+    TEST_ASSERT_EQUAL(SMALL_SLOTS - 1, pool.classes[0].free_count);
+    assert_payload(handle, 8, 0x20);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_pooled_frame_release(handle));
+    TEST_ASSERT_EQUAL(SMALL_SLOTS, pool.classes[0].free_count);
+
+    // A free slot can't be retained or released again
+    TEST_ASSERT_EQUAL(cff_error_invalid_state, cff_pooled_frame_release(handle));
+    TEST_ASSERT_EQUAL(cff_error_invalid_state, cff_pooled_frame_retain(handle));
+    TEST_ASSERT_EQUAL(SMALL_SLOTS, pool.classes[0].free_count);
+}
+
+void test_frame_pool_empty_payload(void)
+{
+    append_frame(9, 0, 0);
+    TEST_ASSERT_EQUAL(1, cff_parse_frames(&ring_buffer, store_callback));
+
+    TEST_ASSERT_EQUAL(0, stored[0]->frame.payload_size_bytes);
+    TEST_ASSERT_EQUAL(9, stored[0]->frame.header.frame_counter);
+    TEST_ASSERT_EQUAL(0, stored[0]->class_index);
+}
@@ -0,0 +1,174 @@
+#include "cff.h"
+#include "cff_capture.h"
+#include "cff_index.h"
+#include "unity.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static char index_path[64];
+static uint8_t stream[16 * 1024];
+static size_t stream_size;
+
+// Append a frame with the given counter, preceded by a little garbage
+static void append_frame(uint16_t counter, size_t payload_size)
+{
+    static const uint8_t garbage[] = {0x00, CFF_PREAMBLE_BYTE_0, 0x42, CFF_PREAMBLE_BYTE_1};
+    memcpy(&stream[stream_size], garbage, counter % sizeof(garbage));
+    stream_size += counter % sizeof(garbage);
+
+    uint8_t payload[64];
+    memset(payload, (int) counter, sizeof(payload));
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, &stream[stream_size], sizeof(stream) - stream_size);
+    builder.frame_counter = counter;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_build_frame(&builder, payload, payload_size));
+    stream_size += cff_calculate_frame_size_bytes(payload_size);
+}
+
+void setUp(void)
+{
+    if (!cff_capture_supported()) {
+        TEST_IGNORE_MESSAGE("Index files are not supported on this platform");
+    }
+    strcpy(index_path, "/tmp/test_cff_index_XXXXXX");
+    int fd = mkstemp(index_path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+    stream_size = 0;
+}
+
+void tearDown(void)
+{
+    unlink(index_path);
+}
+
+void test_index_build_and_seek_across_counter_rollover(void)
+{
+    // Two and a half counter epochs, a few hundred frames
+    uint16_t counter = 65500;
+    for (size_t i = 0; i < 300; i++) {
+        append_frame(counter, i % 40);
+        counter = (uint16_t) (counter + 1 + (i % 97 == 0 ? 400 : 0));
+    }
+
+    uint64_t frames_indexed = 0;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_index_build(stream, stream_size, 2, index_path, &frames_indexed));
+    TEST_ASSERT_EQUAL(300, frames_indexed);
+
+    cff_index_t index;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_index_open(&index, index_path));
+    TEST_ASSERT_EQUAL(300, index.entry_count);
+
+    uint64_t previous_counter = 0;
+    for (uint64_t i = 0; i < index.entry_count; i++) {
+        cff_index_entry_t entry;
+        TEST_ASSERT_EQUAL(cff_error_none, cff_index_entry(&index, i, &entry));
+        TEST_ASSERT_EQUAL(i % 40, entry.payload_size_bytes);
+        if (i > 0) {
+            TEST_ASSERT_TRUE(cff_index_entry_counter(&entry) > previous_counter);
+        }
+        previous_counter = cff_index_entry_counter(&entry);
+
+        // Jump straight to the frame, by number and by counter
+        cff_frame_t frame;
+        TEST_ASSERT_EQUAL(cff_error_none, cff_index_read_frame(&index, stream, stream_size, i, &frame));
+        TEST_ASSERT_EQUAL(entry.frame_counter, frame.header.frame_counter);
+        TEST_ASSERT_EQUAL_PTR(&stream[entry.offset_bytes + CFF_HEADER_SIZE_BYTES], frame.payload);
+
+        uint64_t found;
+        TEST_ASSERT_EQUAL(cff_error_none, cff_index_find_counter(&index, cff_index_entry_counter(&entry), &found));
+        TEST_ASSERT_EQUAL(i, found);
+    }
+
+    cff_index_entry_t last;
+    cff_index_entry(&index, index.entry_count - 1, &last);
+    TEST_ASSERT_GREATER_THAN(0, last.epoch);
+
+    uint64_t found;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_index_find_counter(&index, previous_counter + 1, &found));
+    TEST_ASSERT_EQUAL(index.entry_count, found);
+    cff_frame_t frame;
+    TEST_ASSERT_EQUAL(cff_error_buffer_too_small, cff_index_read_frame(&index, stream, stream_size, 300, &frame));
+    TEST_ASSERT_EQUAL(cff_error_not_supported, cff_index_find_timestamp(&index, 0, &found));
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_index_close(&index));
+}
+
+void test_index_writer_stores_timestamps_and_late_frame_epochs(void)
+{
+    const uint16_t counters[] = {65534, 65535, 0, 65533, 1};
+    for (size_t i = 0; i < 5; i++) {
+        append_frame(counters[i], 8);
+    }
+
+    cff_index_writer_t writer;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_index_writer_open(&writer, index_path, CFF_INDEX_FLAG_TIMESTAMPS));
+    size_t offset = 0;
+    for (size_t i = 0; i < 5; i++) {
+        cff_frame_t frame;
+        while (cff_validate_frame(&stream[offset], stream_size - offset, &frame) != cff_error_none) {
+            offset++;
+        }
+        TEST_ASSERT_EQUAL(cff_error_none, cff_index_writer_add(&writer, offset, &frame, 1000 + 10 * i));
+        offset += cff_calculate_frame_size_bytes(frame.payload_size_bytes);
+    }
+    TEST_ASSERT_EQUAL(cff_error_none, cff_index_writer_close(&writer));
+
+    cff_index_t index;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_index_open(&index, index_path));
+    const uint32_t epochs[] = {0, 0, 1, 0, 1};
+    for (uint64_t i = 0; i < 5; i++) {
+        cff_index_entry_t entry;
+        TEST_ASSERT_EQUAL(cff_error_none, cff_index_entry(&index, i, &entry));
+        TEST_ASSERT_EQUAL(counters[i], entry.frame_counter);
+        TEST_ASSERT_EQUAL(epochs[i], entry.epoch);
+        TEST_ASSERT_EQUAL(1000 + 10 * i, entry.timestamp);
+    }
+
+    uint64_t found;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_index_find_timestamp(&index, 1015, &found));
+    TEST_ASSERT_EQUAL(2, found);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_index_find_timestamp(&index, 0, &found));
+    TEST_ASSERT_EQUAL(0, found);
+    cff_index_close(&index);
+}
+
+void test_index_open_rejects_files_that_are_not_complete_indexes(void)
+{
+    cff_index_t index;
+    TEST_ASSERT_EQUAL(cff_error_not_supported, cff_index_open(&index, "test/support/stream.bin"));
+    TEST_ASSERT_EQUAL(cff_error_io, cff_index_open(&index, "test/support/does_not_exist.idx"));
+
+    // An index whose header claims more entries than the file holds
+    append_frame(1, 4);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_index_build(stream, stream_size, 1, index_path, NULL));
+    TEST_ASSERT_EQUAL(0, truncate(index_path, CFF_INDEX_HEADER_SIZE_BYTES + 4));
+    TEST_ASSERT_EQUAL(cff_error_not_supported, cff_index_open(&index, index_path));
+}
+
+void test_index_writer_reports_io_errors(void)
+{
+    cff_index_writer_t writer;
+    TEST_ASSERT_EQUAL(cff_error_io, cff_index_writer_open(&writer, "test/support/does_not_exist/index.idx", 0));
+
+    append_frame(1, 4);
+    TEST_ASSERT_EQUAL(cff_error_io,
+                      cff_index_build(stream, stream_size, 1, "test/support/does_not_exist/index.idx", NULL));
+}
+
+void test_index_read_frame_detects_mismatched_capture(void)
+{
+    append_frame(5, 4);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_index_build(stream, stream_size, 1, index_path, NULL));
+    cff_index_t index;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_index_open(&index, index_path));
+
+    // Another capture with a different frame at the same offset
+    stream_size = 0;
+    append_frame(9, 4);
+    cff_frame_t frame;
+    TEST_ASSERT_EQUAL(cff_error_invalid_state, cff_index_read_frame(&index, stream, stream_size, 0, &frame));
+    TEST_ASSERT_EQUAL(cff_error_incomplete_frame, cff_index_read_frame(&index, stream, 0, 0, &frame));
+    cff_index_close(&index);
+}
@@ -0,0 +1,123 @@
+#include "cff.h"
+#include "cff_mirror.h"
+#include "unity.h"
+#include <string.h>
+
+static cff_ring_buffer_t ring_buffer;
+static int callback_count = 0;
+static cff_frame_t captured_frame;
+
+static void frame_callback(const cff_frame_t *frame)
+{
+    captured_frame = *frame;
+    callback_count++;
+}
+
+void setUp(void)
+{
+    memset(&ring_buffer, 0, sizeof(ring_buffer));
+    callback_count = 0;
+    if (!cff_ring_buffer_mirrored_supported()) {
+        TEST_IGNORE_MESSAGE("Mirrored ring buffers are not supported on this platform");
+    }
+}
+
+void tearDown(void)
+{
+    if (ring_buffer.flags & CFF_RING_BUFFER_FLAG_MIRRORED) {
+        cff_ring_buffer_free_mirrored(&ring_buffer);
+    }
+}
+
+// Move both indices to start_index so the next append starts there
+static void move_ring_buffer_to_index(uint32_t start_index)
+{
+    uint8_t filler[64] = {0};
+    while (start_index > 0) {
+        uint32_t size = start_index < sizeof(filler) ? start_index : (uint32_t) sizeof(filler);
+        cff_ring_buffer_append(&ring_buffer, filler, size);
+        cff_ring_buffer_advance(&ring_buffer, size);
+        start_index -= size;
+    }
+}
+
+void test_init_mirrored_null_pointers(void)
+{
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_ring_buffer_init_mirrored(NULL, 100));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_ring_buffer_free_mirrored(NULL));
+    TEST_ASSERT_EQUAL(cff_error_buffer_too_small, cff_ring_buffer_init_mirrored(&ring_buffer, 0));
+}
+
+void test_free_mirrored_rejects_plain_ring_buffer(void)
+{
+    uint8_t storage[16];
+    cff_ring_buffer_init(&ring_buffer, storage, sizeof(storage));
+    TEST_ASSERT_EQUAL(cff_error_not_supported, cff_ring_buffer_free_mirrored(&ring_buffer));
+}
+
+void test_init_mirrored_rounds_up_and_aliases_storage(void)
+{
+    TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_init_mirrored(&ring_buffer, 100));
+    TEST_ASSERT_TRUE(ring_buffer.flags & CFF_RING_BUFFER_FLAG_MIRRORED);
+    TEST_ASSERT_TRUE(ring_buffer.buffer_size >= 100);
+    TEST_ASSERT_EQUAL(ring_buffer.buffer_size, cff_ring_buffer_free_space(&ring_buffer));
+
+    // Writes through either mapping are visible through the other
+    ring_buffer.buffer[3] = 0xAB;
+    TEST_ASSERT_EQUAL_HEX8(0xAB, ring_buffer.buffer[ring_buffer.buffer_size + 3]);
+    ring_buffer.buffer[ring_buffer.buffer_size + 7] = 0xCD;
+    TEST_ASSERT_EQUAL_HEX8(0xCD, ring_buffer.buffer[7]);
+}
+
+void test_mirrored_ring_buffer_wrapping_frame_is_contiguous(void)
+{
+    TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_init_mirrored(&ring_buffer, 1));
+
+    uint8_t payload[300];
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t) (i * 13);
+    }
+    uint8_t frame_buffer[512];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+    cff_build_frame(&builder, payload, sizeof(payload));
+    size_t frame_size = cff_calculate_frame_size_bytes(sizeof(payload));
+
+    // Place the frame so its payload runs past the end of the storage
+    move_ring_buffer_to_index(ring_buffer.buffer_size - 100);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_append(&ring_buffer, frame_buffer, (uint32_t) frame_size));
+    TEST_ASSERT_EQUAL(1, cff_parse_frames(&ring_buffer, frame_callback));
+
+    // The payload pointer covers the whole payload, read through the second mapping
+    TEST_ASSERT_TRUE(captured_frame.flags & CFF_FRAME_FLAG_PAYLOAD_CONTIGUOUS);
+    TEST_ASSERT_EQUAL_MEMORY(payload, captured_frame.payload, sizeof(payload));
+
+    cff_span_t spans[CFF_PAYLOAD_SPAN_COUNT];
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_payload_spans(&captured_frame, spans));
+    TEST_ASSERT_EQUAL(sizeof(payload), spans[0].size_bytes);
+    TEST_ASSERT_EQUAL(0, spans[1].size_bytes);
+
+    uint8_t copied_payload[sizeof(payload)];
+    TEST_ASSERT_EQUAL(cff_error_none, cff_copy_frame_payload(&captured_frame, copied_payload, sizeof(copied_payload)));
+    TEST_ASSERT_EQUAL_MEMORY(payload, copied_payload, sizeof(payload));
+}
+
+void test_mirrored_ring_buffer_preamble_straddling_end(void)
+{
+    TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_init_mirrored(&ring_buffer, 1));
+
+    uint8_t frame_buffer[64];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+    cff_build_frame(&builder, (const uint8_t *) "Hello", 5);
+
+    // Garbage, then a frame whose preamble is split across the end of the storage
+    uint8_t garbage[9] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99};
+    move_ring_buffer_to_index(ring_buffer.buffer_size - sizeof(garbage) - 1);
+    cff_ring_buffer_append(&ring_buffer, garbage, sizeof(garbage));
+    cff_ring_buffer_append(&ring_buffer, frame_buffer, (uint32_t) cff_calculate_frame_size_bytes(5));
+
+    TEST_ASSERT_EQUAL(1, cff_parse_frames(&ring_buffer, frame_callback));
+    TEST_ASSERT_EQUAL_MEMORY("Hello", captured_frame.payload, 5);
+    TEST_ASSERT_EQUAL(ring_buffer.buffer_size, cff_ring_buffer_free_space(&ring_buffer));
+}
@@ -0,0 +1,199 @@
+#include "cff.h"
+#include "cff_mux.h"
+#include "unity.h"
+#include <string.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#define STREAM_COUNT 16
+#define FRAMES_PER_STREAM 200
+
+// Per-stream state checked by the callback, which runs on the worker threads
+typedef struct stream_context_t {
+    uint32_t frames_received;
+    uint32_t out_of_order;
+    uint32_t in_callback;
+    uint32_t concurrent_calls;
+    uint16_t next_counter;
+} stream_context_t;
+
+static cff_mux_t *mux;
+static stream_context_t contexts[STREAM_COUNT];
+
+static cff_callback_result_en_t stream_callback(const cff_frame_t *frame, void *user)
+{
+    stream_context_t *context = (stream_context_t *) user;
+    if (__atomic_exchange_n(&context->in_callback, 1, __ATOMIC_ACQ_REL) != 0) {
+        context->concurrent_calls++;
+    }
+    if (frame->header.frame_counter != context->next_counter) {
+        context->out_of_order++;
+    }
+    context->next_counter = (uint16_t) (frame->header.frame_counter + 1);
+    __atomic_store_n(&context->in_callback, 0, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&context->frames_received, 1, __ATOMIC_ACQ_REL);
+    return cff_callback_continue;
+}
+
+static uint32_t frames_received(const stream_context_t *context)
+{
+    return __atomic_load_n(&context->frames_received, __ATOMIC_ACQUIRE);
+}
+
+// Build count frames with consecutive counters starting at first_counter and return the total size
+static size_t build_stream(uint8_t *buffer, size_t buffer_size, uint16_t first_counter, size_t count)
+{
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, buffer, buffer_size);
+    builder.frame_counter = first_counter;
+    size_t stream_size = 0;
+    for (size_t i = 0; i < count; i++) {
+        builder.buffer = &buffer[stream_size];
+        builder.buffer_size_bytes = buffer_size - stream_size;
+        cff_build_frame(&builder, (const uint8_t *) "Payload", 7);
+        stream_size += cff_calculate_frame_size_bytes(7);
+    }
+    return stream_size;
+}
+
+void setUp(void)
+{
+    mux = NULL;
+    memset(contexts, 0, sizeof(contexts));
+    if (!cff_mux_supported()) {
+        TEST_IGNORE_MESSAGE("The multiplexer is not supported on this platform");
+    }
+}
+
+void tearDown(void)
+{
+    cff_mux_destroy(mux);
+}
+
+void test_mux_create_rejects_invalid_arguments(void)
+{
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_mux_create(NULL, 1));
+    TEST_ASSERT_EQUAL(cff_error_not_supported, cff_mux_create(&mux, 0));
+    TEST_ASSERT_NULL(mux);
+    TEST_ASSERT_EQUAL(cff_error_not_supported, cff_mux_create(&mux, CFF_MUX_MAX_WORKERS + 1));
+    TEST_ASSERT_NULL(mux);
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_mux_create(&mux, 2));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_mux_add_stream(NULL, -1, 64, stream_callback, NULL, NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_mux_add_stream(mux, -1, 64, NULL, NULL, NULL));
+    TEST_ASSERT_EQUAL(cff_error_buffer_too_small, cff_mux_add_stream(mux, -1, 4, stream_callback, NULL, NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_mux_feed(NULL, (const uint8_t *) "x", 1));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_mux_poll(NULL, 0));
+}
+
+void test_mux_parses_fed_streams_in_order(void)
+{
+    TEST_ASSERT_EQUAL(cff_error_none, cff_mux_create(&mux, 4));
+
+    cff_mux_stream_t *streams[STREAM_COUNT];
+    for (size_t i = 0; i < STREAM_COUNT; i++) {
+        TEST_ASSERT_EQUAL(cff_error_none, cff_mux_add_stream(mux, -1, 256, stream_callback, &contexts[i], &streams[i]));
+    }
+
+    // Feed every stream in small chunks, interleaved, so workers keep picking streams up and releasing them
+    static uint8_t stream_data[FRAMES_PER_STREAM * 32];
+    size_t stream_size = build_stream(stream_data, sizeof(stream_data), 0, FRAMES_PER_STREAM);
+    size_t fed[STREAM_COUNT] = {0};
+    bool all_fed = false;
+    while (!all_fed) {
+        all_fed = true;
+        for (size_t i = 0; i < STREAM_COUNT; i++) {
+            uint32_t size = (uint32_t) CFF_MIN(5 + i, stream_size - fed[i]);
+            if (size > 0 && cff_mux_feed(streams[i], &stream_data[fed[i]], size) == cff_error_none) {
+                fed[i] += size;
+            }
+            all_fed = all_fed && fed[i] == stream_size;
+        }
+    }
+    cff_mux_wait_idle(mux);
+
+    for (size_t i = 0; i < STREAM_COUNT; i++) {
+        TEST_ASSERT_EQUAL(FRAMES_PER_STREAM, frames_received(&contexts[i]));
+        TEST_ASSERT_EQUAL(0, contexts[i].out_of_order);
+        TEST_ASSERT_EQUAL(0, contexts[i].concurrent_calls);
+    }
+}
+
+#if defined(__linux__)
+
+void test_mux_reads_file_descriptors(void)
+{
+    TEST_ASSERT_EQUAL(cff_error_none, cff_mux_create(&mux, 3));
+
+    int pipes[STREAM_COUNT][2];
+    static uint8_t stream_data[FRAMES_PER_STREAM * 32];
+    for (size_t i = 0; i < STREAM_COUNT; i++) {
+        TEST_ASSERT_EQUAL(0, pipe(pipes[i]));
+        TEST_ASSERT_EQUAL(cff_error_none,
+                          cff_mux_add_stream(mux, pipes[i][0], 512, stream_callback, &contexts[i], NULL));
+
+        contexts[i].next_counter = (uint16_t) (i * 1000);
+        size_t stream_size = build_stream(stream_data, sizeof(stream_data), (uint16_t) (i * 1000), FRAMES_PER_STREAM);
+        TEST_ASSERT_EQUAL(stream_size, (size_t) write(pipes[i][1], stream_data, stream_size));
+        close(pipes[i][1]);
+    }
+
+    // Rings are much smaller than what is queued in the pipes, so polling pauses and resumes repeatedly
+    bool done = false;
+    for (int iteration = 0; iteration < 100000 && !done; iteration++) {
+        TEST_ASSERT_EQUAL(cff_error_none, cff_mux_poll(mux, 10));
+        done = true;
+        for (size_t i = 0; i < STREAM_COUNT; i++) {
+            done = done && frames_received(&contexts[i]) == FRAMES_PER_STREAM;
+        }
+    }
+    cff_mux_wait_idle(mux);
+
+    for (size_t i = 0; i < STREAM_COUNT; i++) {
+        TEST_ASSERT_EQUAL(FRAMES_PER_STREAM, frames_received(&contexts[i]));
+        TEST_ASSERT_EQUAL(0, contexts[i].out_of_order);
+        TEST_ASSERT_EQUAL(0, contexts[i].concurrent_calls);
+    }
+
+    for (size_t i = 0; i < STREAM_COUNT; i++) {
+        close(pipes[i][0]);
+    }
+}
+
+#endif
+
+void test_mux_remove_stream(void)
+{
+    TEST_ASSERT_EQUAL(cff_error_none, cff_mux_create(&mux, 2));
+
+    cff_mux_stream_t *first;
+    cff_mux_stream_t *second;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_mux_add_stream(mux, -1, 128, stream_callback, &contexts[0], &first));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_mux_add_stream(mux, -1, 128, stream_callback, &contexts[1], &second));
+
+    uint8_t stream_data[64];
+    size_t stream_size = build_stream(stream_data, sizeof(stream_data), 0, 3);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_mux_feed(first, stream_data, (uint32_t) stream_size));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_mux_remove_stream(mux, first));
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_mux_feed(second, stream_data, (uint32_t) stream_size));
+    cff_mux_wait_idle(mux);
+    TEST_ASSERT_EQUAL(3, frames_received(&contexts[1]));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_mux_remove_stream(mux, second));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_mux_remove_stream(mux, NULL));
+}
+
+void test_mux_feed_rejects_data_that_does_not_fit(void)
+{
+    TEST_ASSERT_EQUAL(cff_error_none, cff_mux_create(&mux, 1));
+
+    cff_mux_stream_t *stream;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_mux_add_stream(mux, -1, 16, stream_callback, &contexts[0], &stream));
+
+    uint8_t garbage[17] = {0};
+    TEST_ASSERT_EQUAL(cff_error_insufficient_space, cff_mux_feed(stream, garbage, sizeof(garbage)));
+    cff_mux_wait_idle(mux);
+    TEST_ASSERT_EQUAL(0, frames_received(&contexts[0]));
+}
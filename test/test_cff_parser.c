@@ -433,3 +433,847 @@ void test_parse_frames_small_buffer(void)
         TEST_ASSERT_EQUAL(0, callback_count);
     }
 }
+
+// Helper to place data in a ring buffer so that it starts at the given storage index
+static void setup_ring_buffer_at_index(cff_ring_buffer_t *ring_buffer, uint8_t *ring_storage, uint32_t storage_size,
+                                       uint32_t start_index, const uint8_t *data, size_t data_size)
+{
+    cff_ring_buffer_init(ring_buffer, ring_storage, storage_size);
+    for (uint32_t i = 0; i < start_index; i++) {
+        uint8_t filler = 0;
+        cff_ring_buffer_append(ring_buffer, &filler, 1);
+    }
+    cff_ring_buffer_advance(ring_buffer, start_index);
+    cff_ring_buffer_append(ring_buffer, data, (uint32_t) data_size);
+}
+
+void test_parse_frames_preamble_at_every_wrap_position(void)
+{
+    uint8_t stream[100];
+    uint8_t garbage[] = {0x00, 0xFA, 0x11, 0xCE, 0xFA};
+    memcpy(stream, garbage, sizeof(garbage));
+    size_t frame_size = build_test_frame(stream + sizeof(garbage), sizeof(stream) - sizeof(garbage), "Hello");
+    size_t stream_size = sizeof(garbage) + frame_size;
+
+    // Rotate the stream through the storage so the wrap point falls on every byte, including between the two
+    // preamble bytes
+    uint8_t ring_storage[64];
+    for (uint32_t start_index = 0; start_index < sizeof(ring_storage); start_index++) {
+        callback_count = 0;
+        cff_ring_buffer_t ring_buffer;
+        setup_ring_buffer_at_index(&ring_buffer, ring_storage, sizeof(ring_storage), start_index, stream, stream_size);
+
+        size_t frames_parsed = cff_parse_frames(&ring_buffer, frame_callback);
+
+        TEST_ASSERT_EQUAL(1, frames_parsed);
+        TEST_ASSERT_EQUAL(5, captured_frames[0].header.payload_size_bytes);
+
+        uint8_t copied_payload[5];
+        TEST_ASSERT_EQUAL(cff_error_none,
+                          cff_copy_frame_payload(&captured_frames[0], copied_payload, sizeof(copied_payload)));
+        TEST_ASSERT_EQUAL_MEMORY("Hello", copied_payload, sizeof(copied_payload));
+    }
+}
+
+void test_parse_frames_after_preamble_byte_flood(void)
+{
+    // A long run of first preamble bytes must not hide the real preamble at its end
+    uint8_t stream[300];
+    memset(stream, CFF_PREAMBLE_BYTE_0, 200);
+    size_t frame_size = build_test_frame(stream + 200, sizeof(stream) - 200, "Hello");
+
+    uint8_t ring_storage[512];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), stream, 200 + frame_size);
+
+    size_t frames_parsed = cff_parse_frames(&ring_buffer, frame_callback);
+
+    TEST_ASSERT_EQUAL(1, frames_parsed);
+    TEST_ASSERT_EQUAL(5, captured_frames[0].header.payload_size_bytes);
+}
+
+void test_parse_frames_discards_scanned_garbage(void)
+{
+    uint8_t frame_buffer[64];
+    size_t frame_size = build_test_frame(frame_buffer, sizeof(frame_buffer), "Hello");
+
+    // Fill the ring with garbage that ends in the first preamble byte of a frame that is still arriving
+    uint8_t ring_storage[32];
+    uint8_t garbage[sizeof(ring_storage)];
+    memset(garbage, 0x55, sizeof(garbage));
+    garbage[sizeof(garbage) - 1] = frame_buffer[0];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), garbage, sizeof(garbage));
+
+    TEST_ASSERT_EQUAL(0, cff_parse_frames(&ring_buffer, frame_callback));
+
+    // Only the trailing preamble byte may be kept, so there must be room for the rest of the frame
+    cff_error_en_t append_result = cff_ring_buffer_append(&ring_buffer, frame_buffer + 1, (uint32_t) frame_size - 1);
+    TEST_ASSERT_EQUAL(cff_error_none, append_result);
+    TEST_ASSERT_EQUAL(1, cff_parse_frames(&ring_buffer, frame_callback));
+    TEST_ASSERT_EQUAL(5, captured_frames[0].header.payload_size_bytes);
+}
+
+void test_parse_frames_waits_for_partial_header(void)
+{
+    uint8_t frame_buffer[64];
+    size_t frame_size = build_test_frame(frame_buffer, sizeof(frame_buffer), "Hello");
+
+    uint8_t ring_storage[64];
+    cff_ring_buffer_t ring_buffer;
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+
+    // Deliver the frame one byte at a time, as a UART would
+    for (size_t i = 0; i < frame_size; i++) {
+        cff_ring_buffer_append(&ring_buffer, &frame_buffer[i], 1);
+        size_t frames_parsed = cff_parse_frames(&ring_buffer, frame_callback);
+        TEST_ASSERT_EQUAL(i == frame_size - 1 ? 1 : 0, frames_parsed);
+    }
+    TEST_ASSERT_EQUAL(1, callback_count);
+}
+
+void test_parse_frame_rejects_frame_larger_than_ring_buffer(void)
+{
+    // A valid header for a frame that can't fit in the ring must not stall the parser
+    uint8_t large_payload[100] = {0};
+    uint8_t frame_buffer[128];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+    cff_build_frame(&builder, large_payload, sizeof(large_payload));
+
+    uint8_t ring_storage[64];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), frame_buffer, CFF_HEADER_SIZE_BYTES);
+
+    cff_frame_t parsed_frame;
+    TEST_ASSERT_EQUAL(cff_error_payload_too_large, cff_parse_frame(&ring_buffer, &parsed_frame));
+
+    // cff_parse_frames skips it and finds the next frame
+    size_t small_frame_size = build_test_frame(frame_buffer, sizeof(frame_buffer), "Hi");
+    cff_ring_buffer_append(&ring_buffer, frame_buffer, (uint32_t) small_frame_size);
+    TEST_ASSERT_EQUAL(1, cff_parse_frames(&ring_buffer, frame_callback));
+    TEST_ASSERT_EQUAL(2, captured_frames[0].header.payload_size_bytes);
+}
+
+// CRC provider that counts the bytes it is fed
+static size_t crc_bytes_processed = 0;
+
+static uint16_t counting_crc_begin(void *context)
+{
+    (void) context;
+    return CFF_CRC_INIT;
+}
+
+static uint16_t counting_crc_update(void *context, uint16_t crc, const uint8_t *data, size_t data_size_bytes)
+{
+    (void) context;
+    crc_bytes_processed += data_size_bytes;
+    for (size_t i = 0; i < data_size_bytes; i++) {
+        crc ^= (uint16_t) (data[i] << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ CFF_CRC_POLYNOMIAL) : (uint16_t) (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t counting_crc_finish(void *context, uint16_t crc)
+{
+    (void) context;
+    return crc;
+}
+
+static const cff_crc_provider_t counting_provider = {counting_crc_begin, counting_crc_update, counting_crc_finish,
+                                                     NULL};
+
+void test_parser_init_null_pointers(void)
+{
+    cff_parser_t parser;
+    uint8_t ring_storage[16];
+    cff_ring_buffer_t ring_buffer;
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_parser_init(NULL, &ring_buffer));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_parser_init(&parser, NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_parser_reset(NULL));
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_parser_init(&parser, &ring_buffer));
+    TEST_ASSERT_EQUAL(0, cff_parser_parse_frames(NULL, frame_callback));
+    TEST_ASSERT_EQUAL(0, cff_parser_parse_frames(&parser, NULL));
+}
+
+void test_parser_hashes_each_byte_once_when_chunked(void)
+{
+    uint8_t payload[200];
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t) (i * 7);
+    }
+    uint8_t frame_buffer[256];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+    cff_build_frame(&builder, payload, sizeof(payload));
+    size_t frame_size = cff_calculate_frame_size_bytes(sizeof(payload));
+
+    // Start near the end of the storage so the frame wraps around
+    uint8_t ring_storage[256];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_at_index(&ring_buffer, ring_storage, sizeof(ring_storage), 200, frame_buffer, 0);
+    cff_parser_t parser;
+    cff_parser_init(&parser, &ring_buffer);
+
+    cff_crc_set_provider(&counting_provider);
+    crc_bytes_processed = 0;
+
+    // Deliver the frame in small pieces, as DMA half-transfer interrupts would
+    const size_t chunk_size = 7;
+    for (size_t offset = 0; offset < frame_size; offset += chunk_size) {
+        uint32_t size = (uint32_t) CFF_MIN(chunk_size, frame_size - offset);
+        cff_ring_buffer_append(&ring_buffer, &frame_buffer[offset], size);
+        size_t frames_parsed = cff_parser_parse_frames(&parser, frame_callback);
+        TEST_ASSERT_EQUAL(offset + size == frame_size ? 1 : 0, frames_parsed);
+    }
+
+    cff_crc_set_provider(NULL);
+
+    // The header CRC covers 6 bytes, then every payload byte is hashed exactly once
+    TEST_ASSERT_EQUAL(6 + sizeof(payload), crc_bytes_processed);
+    TEST_ASSERT_EQUAL(1, callback_count);
+    TEST_ASSERT_EQUAL(sizeof(ring_storage), cff_ring_buffer_free_space(&ring_buffer));
+
+    uint8_t copied_payload[sizeof(payload)];
+    TEST_ASSERT_EQUAL(cff_error_none, cff_copy_frame_payload(&captured_frames[0], copied_payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL_MEMORY(payload, copied_payload, sizeof(payload));
+}
+
+void test_parser_chunked_stream_matches_single_call(void)
+{
+    // Frames separated by garbage, including a corrupted frame
+    uint8_t stream[256];
+    size_t stream_size = 0;
+    const char *payloads[] = {"First", "Second frame", "Corrupted", "Fourth"};
+    cff_frame_builder_t builder;
+    for (size_t i = 0; i < 4; i++) {
+        stream[stream_size++] = 0x42;
+        stream[stream_size++] = CFF_PREAMBLE_BYTE_0;
+        cff_frame_builder_init(&builder, &stream[stream_size], sizeof(stream) - stream_size);
+        builder.frame_counter = (uint16_t) i;
+        cff_build_frame(&builder, (const uint8_t *) payloads[i], strlen(payloads[i]));
+        if (i == 2) {
+            stream[stream_size + CFF_HEADER_SIZE_BYTES] ^= 0xFF;
+        }
+        stream_size += cff_calculate_frame_size_bytes(strlen(payloads[i]));
+    }
+
+    // The ring buffer holds a chunk plus whatever is left of an incomplete frame
+    for (size_t chunk_size = 1; chunk_size <= 32; chunk_size++) {
+        callback_count = 0;
+        uint8_t ring_storage[64];
+        cff_ring_buffer_t ring_buffer;
+        cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+        cff_parser_t parser;
+        cff_parser_init(&parser, &ring_buffer);
+
+        for (size_t offset = 0; offset < stream_size; offset += chunk_size) {
+            uint32_t size = (uint32_t) CFF_MIN(chunk_size, stream_size - offset);
+            TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_append(&ring_buffer, &stream[offset], size));
+            cff_parser_parse_frames(&parser, frame_callback);
+        }
+
+        TEST_ASSERT_EQUAL_MESSAGE(3, callback_count, "Frames lost for this chunk size");
+        TEST_ASSERT_EQUAL(0, captured_frames[0].header.frame_counter);
+        TEST_ASSERT_EQUAL(1, captured_frames[1].header.frame_counter);
+        TEST_ASSERT_EQUAL(3, captured_frames[2].header.frame_counter);
+    }
+}
+
+void test_parser_reset_discards_frame_in_progress(void)
+{
+    uint8_t frame_buffer[64];
+    size_t frame_size = build_test_frame(frame_buffer, sizeof(frame_buffer), "Hello, World!");
+
+    uint8_t ring_storage[64];
+    cff_ring_buffer_t ring_buffer;
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+    cff_parser_t parser;
+    cff_parser_init(&parser, &ring_buffer);
+
+    // Half a frame, then the link is reset and the ring buffer flushed
+    cff_ring_buffer_append(&ring_buffer, frame_buffer, (uint32_t) frame_size / 2);
+    TEST_ASSERT_EQUAL(0, cff_parser_parse_frames(&parser, frame_callback));
+    TEST_ASSERT_EQUAL(cff_parser_state_payload, parser.state);
+    cff_ring_buffer_advance(&ring_buffer, (uint32_t) frame_size / 2);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_parser_reset(&parser));
+    TEST_ASSERT_EQUAL(cff_parser_state_searching, parser.state);
+
+    // A complete frame afterwards is parsed normally
+    cff_ring_buffer_append(&ring_buffer, frame_buffer, (uint32_t) frame_size);
+    TEST_ASSERT_EQUAL(1, cff_parser_parse_frames(&parser, frame_callback));
+    TEST_ASSERT_EQUAL(13, captured_frames[0].header.payload_size_bytes);
+}
+
+// Per-link context for the user pointer tests
+typedef struct {
+    int frames_received;
+    int stop_after;
+    uint16_t last_frame_counter;
+} link_context_t;
+
+static cff_callback_result_en_t link_callback(const cff_frame_t *frame, void *user)
+{
+    link_context_t *link = (link_context_t *) user;
+    link->frames_received++;
+    link->last_frame_counter = frame->header.frame_counter;
+    return link->frames_received == link->stop_after ? cff_callback_stop : cff_callback_continue;
+}
+
+// Build count frames with consecutive counters into buffer and return the total size
+static size_t build_test_stream(uint8_t *buffer, size_t buffer_size, size_t count)
+{
+    cff_frame_builder_t builder;
+    size_t stream_size = 0;
+    for (size_t i = 0; i < count; i++) {
+        cff_frame_builder_init(&builder, &buffer[stream_size], buffer_size - stream_size);
+        builder.frame_counter = (uint16_t) i;
+        cff_build_frame(&builder, (const uint8_t *) "Data", 4);
+        stream_size += cff_calculate_frame_size_bytes(4);
+    }
+    return stream_size;
+}
+
+void test_parse_frames_ex_null_pointers(void)
+{
+    uint8_t ring_storage[16];
+    cff_ring_buffer_t ring_buffer;
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+    link_context_t link = {0};
+
+    TEST_ASSERT_EQUAL(0, cff_parse_frames_ex(NULL, link_callback, &link));
+    TEST_ASSERT_EQUAL(0, cff_parse_frames_ex(&ring_buffer, NULL, &link));
+    TEST_ASSERT_EQUAL(0, cff_parser_parse_frames_ex(NULL, link_callback, &link));
+}
+
+void test_parse_frames_ex_passes_user_pointer_per_link(void)
+{
+    uint8_t stream[128];
+    size_t stream_size = build_test_stream(stream, sizeof(stream), 3);
+
+    // Two links parsed with the same callback keep separate state
+    uint8_t ring_storage_a[128];
+    uint8_t ring_storage_b[128];
+    cff_ring_buffer_t ring_a;
+    cff_ring_buffer_t ring_b;
+    setup_ring_buffer_from_data(&ring_a, ring_storage_a, sizeof(ring_storage_a), stream, stream_size);
+    setup_ring_buffer_from_data(&ring_b, ring_storage_b, sizeof(ring_storage_b), stream, 2 * (stream_size / 3));
+
+    link_context_t link_a = {0};
+    link_context_t link_b = {0};
+    TEST_ASSERT_EQUAL(3, cff_parse_frames_ex(&ring_a, link_callback, &link_a));
+    TEST_ASSERT_EQUAL(2, cff_parse_frames_ex(&ring_b, link_callback, &link_b));
+
+    TEST_ASSERT_EQUAL(3, link_a.frames_received);
+    TEST_ASSERT_EQUAL(2, link_a.last_frame_counter);
+    TEST_ASSERT_EQUAL(2, link_b.frames_received);
+    TEST_ASSERT_EQUAL(1, link_b.last_frame_counter);
+}
+
+void test_parse_frames_ex_stop_leaves_remaining_frames(void)
+{
+    uint8_t stream[128];
+    size_t stream_size = build_test_stream(stream, sizeof(stream), 4);
+
+    uint8_t ring_storage[128];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), stream, stream_size);
+    cff_parser_t parser;
+    cff_parser_init(&parser, &ring_buffer);
+
+    // Stop after the first frame, then resume where parsing stopped
+    link_context_t link = {0, 1, 0};
+    TEST_ASSERT_EQUAL(1, cff_parser_parse_frames_ex(&parser, link_callback, &link));
+    TEST_ASSERT_EQUAL(0, link.last_frame_counter);
+    TEST_ASSERT_EQUAL(3 * cff_calculate_frame_size_bytes(4), cff_ring_buffer_available_data(&ring_buffer));
+
+    link.stop_after = 0;
+    TEST_ASSERT_EQUAL(3, cff_parser_parse_frames_ex(&parser, link_callback, &link));
+    TEST_ASSERT_EQUAL(4, link.frames_received);
+    TEST_ASSERT_EQUAL(3, link.last_frame_counter);
+}
+
+void test_frame_payload_spans_null_pointers(void)
+{
+    cff_frame_t frame;
+    cff_span_t spans[CFF_PAYLOAD_SPAN_COUNT];
+    memset(&frame, 0, sizeof(frame));
+
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_payload_spans(NULL, spans));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_payload_spans(&frame, NULL));
+}
+
+void test_frame_payload_spans_contiguous(void)
+{
+    uint8_t frame_buffer[64];
+    size_t frame_size = build_test_frame(frame_buffer, sizeof(frame_buffer), "Hello");
+
+    uint8_t ring_storage[64];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), frame_buffer, frame_size);
+
+    cff_frame_t frame;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_parse_frame(&ring_buffer, &frame));
+    TEST_ASSERT_TRUE(frame.flags & CFF_FRAME_FLAG_PAYLOAD_CONTIGUOUS);
+
+    cff_span_t spans[CFF_PAYLOAD_SPAN_COUNT];
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_payload_spans(&frame, spans));
+    TEST_ASSERT_EQUAL_PTR(&ring_storage[CFF_HEADER_SIZE_BYTES], spans[0].data);
+    TEST_ASSERT_EQUAL(5, spans[0].size_bytes);
+    TEST_ASSERT_EQUAL(0, spans[1].size_bytes);
+    TEST_ASSERT_EQUAL_MEMORY("Hello", spans[0].data, 5);
+}
+
+void test_frame_payload_spans_at_every_wrap_position(void)
+{
+    uint8_t frame_buffer[64];
+    const char *payload = "Hello, World!";
+    size_t payload_size = strlen(payload);
+    size_t frame_size = build_test_frame(frame_buffer, sizeof(frame_buffer), payload);
+
+    uint8_t ring_storage[32];
+    for (uint32_t start_index = 0; start_index < sizeof(ring_storage); start_index++) {
+        cff_ring_buffer_t ring_buffer;
+        setup_ring_buffer_at_index(&ring_buffer, ring_storage, sizeof(ring_storage), start_index, frame_buffer,
+                                   frame_size);
+
+        cff_frame_t frame;
+        TEST_ASSERT_EQUAL(cff_error_none, cff_parse_frame(&ring_buffer, &frame));
+
+        // The payload wraps if it starts before the end of the storage and runs past it
+        uint32_t payload_start = (start_index + CFF_HEADER_SIZE_BYTES) % sizeof(ring_storage);
+        bool wraps = payload_start + payload_size > sizeof(ring_storage);
+        TEST_ASSERT_EQUAL(!wraps, (frame.flags & CFF_FRAME_FLAG_PAYLOAD_CONTIGUOUS) != 0);
+
+        cff_span_t spans[CFF_PAYLOAD_SPAN_COUNT];
+        TEST_ASSERT_EQUAL(cff_error_none, cff_frame_payload_spans(&frame, spans));
+        TEST_ASSERT_EQUAL(payload_size, spans[0].size_bytes + spans[1].size_bytes);
+        TEST_ASSERT_EQUAL(wraps, spans[1].size_bytes > 0);
+        TEST_ASSERT_EQUAL_MEMORY(payload, spans[0].data, spans[0].size_bytes);
+        if (wraps) {
+            TEST_ASSERT_EQUAL_PTR(ring_storage, spans[1].data);
+            TEST_ASSERT_EQUAL_MEMORY(payload + spans[0].size_bytes, spans[1].data, spans[1].size_bytes);
+        }
+
+        uint8_t copied_payload[32];
+        TEST_ASSERT_EQUAL(cff_error_none, cff_copy_frame_payload(&frame, copied_payload, sizeof(copied_payload)));
+        TEST_ASSERT_EQUAL_MEMORY(payload, copied_payload, payload_size);
+    }
+}
+
+void test_parse_frames_batch_null_pointers(void)
+{
+    uint8_t ring_storage[16];
+    cff_ring_buffer_t ring_buffer;
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+    cff_frame_t frames[2];
+
+    TEST_ASSERT_EQUAL(0, cff_parse_frames_batch(NULL, frames, 2));
+    TEST_ASSERT_EQUAL(0, cff_parse_frames_batch(&ring_buffer, NULL, 2));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_commit_frames(NULL, frames, 1));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_commit_frames(&ring_buffer, NULL, 1));
+}
+
+void test_parse_frames_batch_leaves_frames_until_commit(void)
+{
+    uint8_t stream[128];
+    size_t stream_size = build_test_stream(stream, sizeof(stream), 3);
+    size_t frame_size = cff_calculate_frame_size_bytes(4);
+
+    uint8_t ring_storage[128];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), stream, stream_size);
+
+    cff_frame_t frames[4];
+    TEST_ASSERT_EQUAL(3, cff_parse_frames_batch(&ring_buffer, frames, 4));
+    TEST_ASSERT_EQUAL(stream_size, cff_ring_buffer_available_data(&ring_buffer));
+    for (size_t i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(i, frames[i].header.frame_counter);
+        TEST_ASSERT_EQUAL(i * frame_size, frames[i].offset_bytes);
+        TEST_ASSERT_EQUAL(4, frames[i].payload_size_bytes);
+        TEST_ASSERT_EQUAL_MEMORY("Data", frames[i].payload, 4);
+    }
+
+    // Parsing again before the commit returns the same frames
+    TEST_ASSERT_EQUAL(3, cff_parse_frames_batch(&ring_buffer, frames, 4));
+    TEST_ASSERT_EQUAL(0, frames[0].header.frame_counter);
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_commit_frames(&ring_buffer, frames, 3));
+    TEST_ASSERT_EQUAL(0, cff_ring_buffer_available_data(&ring_buffer));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_commit_frames(&ring_buffer, frames, 0));
+}
+
+void test_parse_frames_batch_respects_max_frames(void)
+{
+    uint8_t stream[128];
+    size_t stream_size = build_test_stream(stream, sizeof(stream), 4);
+    size_t frame_size = cff_calculate_frame_size_bytes(4);
+
+    uint8_t ring_storage[128];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), stream, stream_size);
+
+    cff_frame_t frames[2];
+    TEST_ASSERT_EQUAL(2, cff_parse_frames_batch(&ring_buffer, frames, 2));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_commit_frames(&ring_buffer, frames, 2));
+    TEST_ASSERT_EQUAL(2 * frame_size, cff_ring_buffer_available_data(&ring_buffer));
+
+    TEST_ASSERT_EQUAL(2, cff_parse_frames_batch(&ring_buffer, frames, 2));
+    TEST_ASSERT_EQUAL(2, frames[0].header.frame_counter);
+    TEST_ASSERT_EQUAL(0, frames[0].offset_bytes);
+
+    // Releasing a prefix of the batch leaves the rest for the next call
+    TEST_ASSERT_EQUAL(cff_error_none, cff_commit_frames(&ring_buffer, frames, 1));
+    TEST_ASSERT_EQUAL(1, cff_parse_frames_batch(&ring_buffer, frames, 2));
+    TEST_ASSERT_EQUAL(3, frames[0].header.frame_counter);
+    TEST_ASSERT_EQUAL(0, cff_parse_frames_batch(&ring_buffer, frames, 0));
+}
+
+void test_parse_frames_batch_skips_garbage_between_frames(void)
+{
+    size_t frame_size = cff_calculate_frame_size_bytes(4);
+    uint8_t stream[128];
+    size_t stream_size = 0;
+    memset(stream, 0x55, sizeof(stream));
+    stream_size += 5; // Leading garbage
+    stream_size += build_test_stream(&stream[stream_size], sizeof(stream) - stream_size, 1);
+    stream[stream_size++] = CFF_PREAMBLE_BYTE_0; // Stray preamble byte
+    stream_size += 3;
+    stream_size += build_test_stream(&stream[stream_size], sizeof(stream) - stream_size, 1);
+    size_t second_frame_start = stream_size - frame_size;
+    stream_size += 6; // Trailing garbage
+
+    uint8_t ring_storage[128];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), stream, stream_size);
+
+    // Only the garbage in front of the first frame is discarded
+    cff_frame_t frames[4];
+    TEST_ASSERT_EQUAL(2, cff_parse_frames_batch(&ring_buffer, frames, 4));
+    TEST_ASSERT_EQUAL(stream_size - 5, cff_ring_buffer_available_data(&ring_buffer));
+    TEST_ASSERT_EQUAL(0, frames[0].offset_bytes);
+    TEST_ASSERT_EQUAL(second_frame_start - 5, frames[1].offset_bytes);
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_commit_frames(&ring_buffer, frames, 2));
+    TEST_ASSERT_EQUAL(6, cff_ring_buffer_available_data(&ring_buffer));
+    TEST_ASSERT_EQUAL(0, cff_parse_frames_batch(&ring_buffer, frames, 4));
+    TEST_ASSERT_EQUAL(0, cff_ring_buffer_available_data(&ring_buffer));
+}
+
+void test_parse_frames_batch_at_every_wrap_position(void)
+{
+    uint8_t stream[64];
+    size_t stream_size = build_test_stream(stream, sizeof(stream), 2);
+
+    uint8_t ring_storage[40];
+    for (uint32_t start_index = 0; start_index < sizeof(ring_storage); start_index++) {
+        cff_ring_buffer_t ring_buffer;
+        setup_ring_buffer_at_index(&ring_buffer, ring_storage, sizeof(ring_storage), start_index, stream, stream_size);
+
+        cff_frame_t frames[2];
+        TEST_ASSERT_EQUAL(2, cff_parse_frames_batch(&ring_buffer, frames, 2));
+        for (size_t i = 0; i < 2; i++) {
+            uint8_t payload[4];
+            TEST_ASSERT_EQUAL(i, frames[i].header.frame_counter);
+            TEST_ASSERT_EQUAL(cff_error_none, cff_copy_frame_payload(&frames[i], payload, sizeof(payload)));
+            TEST_ASSERT_EQUAL_MEMORY("Data", payload, 4);
+        }
+        TEST_ASSERT_EQUAL(cff_error_none, cff_commit_frames(&ring_buffer, frames, 2));
+        TEST_ASSERT_EQUAL(0, cff_ring_buffer_available_data(&ring_buffer));
+    }
+}
+
+void test_commit_frames_rejects_consumed_frames(void)
+{
+    uint8_t stream[64];
+    size_t stream_size = build_test_stream(stream, sizeof(stream), 1);
+
+    uint8_t ring_storage[64];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), stream, stream_size);
+
+    cff_frame_t frame;
+    TEST_ASSERT_EQUAL(1, cff_parse_frames_batch(&ring_buffer, &frame, 1));
+    cff_ring_buffer_advance(&ring_buffer, 1);
+    TEST_ASSERT_EQUAL(cff_error_invalid_state, cff_commit_frames(&ring_buffer, &frame, 1));
+}
+
+void test_parser_skip_payload_crc_hashes_only_header(void)
+{
+    uint8_t payload[100];
+    memset(payload, 0xA5, sizeof(payload));
+    uint8_t frame_buffer[128];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+    cff_build_frame(&builder, payload, sizeof(payload));
+    size_t frame_size = cff_calculate_frame_size_bytes(sizeof(payload));
+
+    uint8_t ring_storage[128];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), frame_buffer, frame_size);
+    cff_parser_t parser;
+    cff_parser_init(&parser, &ring_buffer);
+    parser.options = CFF_PARSER_OPTION_SKIP_PAYLOAD_CRC;
+
+    cff_crc_set_provider(&counting_provider);
+    crc_bytes_processed = 0;
+    TEST_ASSERT_EQUAL(1, cff_parser_parse_frames(&parser, frame_callback));
+    cff_crc_set_provider(NULL);
+
+    TEST_ASSERT_EQUAL(6, crc_bytes_processed);
+    TEST_ASSERT_TRUE(captured_frames[0].flags & CFF_FRAME_FLAG_PAYLOAD_UNVERIFIED);
+    TEST_ASSERT_EQUAL(sizeof(payload), captured_frames[0].payload_size_bytes);
+}
+
+void test_parser_skip_payload_crc_accepts_corrupted_payload(void)
+{
+    uint8_t frame_buffer[64];
+    size_t frame_size = build_test_frame(frame_buffer, sizeof(frame_buffer), "Hello, World!");
+    frame_buffer[CFF_HEADER_SIZE_BYTES + 3] ^= 0xFF;
+
+    uint8_t ring_storage[64];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), frame_buffer, frame_size);
+    cff_parser_t parser;
+    cff_parser_init(&parser, &ring_buffer);
+    parser.options = CFF_PARSER_OPTION_SKIP_PAYLOAD_CRC;
+
+    TEST_ASSERT_EQUAL(1, cff_parser_parse_frames(&parser, frame_callback));
+    TEST_ASSERT_TRUE(captured_frames[0].flags & CFF_FRAME_FLAG_PAYLOAD_UNVERIFIED);
+
+    // The frame is consumed, but its bytes are still in the storage
+    TEST_ASSERT_EQUAL(cff_error_invalid_payload_crc, cff_verify_frame_payload(&captured_frames[0]));
+    TEST_ASSERT_TRUE(captured_frames[0].flags & CFF_FRAME_FLAG_PAYLOAD_UNVERIFIED);
+}
+
+void test_verify_frame_payload_at_every_wrap_position(void)
+{
+    uint8_t frame_buffer[64];
+    size_t frame_size = build_test_frame(frame_buffer, sizeof(frame_buffer), "Hello, World!");
+
+    uint8_t ring_storage[32];
+    for (uint32_t start_index = 0; start_index < sizeof(ring_storage); start_index++) {
+        cff_ring_buffer_t ring_buffer;
+        setup_ring_buffer_at_index(&ring_buffer, ring_storage, sizeof(ring_storage), start_index, frame_buffer,
+                                   frame_size);
+        cff_parser_t parser;
+        cff_parser_init(&parser, &ring_buffer);
+        parser.options = CFF_PARSER_OPTION_SKIP_PAYLOAD_CRC;
+
+        callback_count = 0;
+        TEST_ASSERT_EQUAL(1, cff_parser_parse_frames(&parser, frame_callback));
+        TEST_ASSERT_EQUAL(cff_error_none, cff_verify_frame_payload(&captured_frames[0]));
+        TEST_ASSERT_FALSE(captured_frames[0].flags & CFF_FRAME_FLAG_PAYLOAD_UNVERIFIED);
+    }
+
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_verify_frame_payload(NULL));
+}
+
+void test_parser_verifies_payload_by_default(void)
+{
+    uint8_t frame_buffer[64];
+    size_t frame_size = build_test_frame(frame_buffer, sizeof(frame_buffer), "Hello");
+
+    uint8_t ring_storage[64];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), frame_buffer, frame_size);
+    cff_parser_t parser;
+    cff_parser_init(&parser, &ring_buffer);
+
+    TEST_ASSERT_EQUAL(1, cff_parser_parse_frames(&parser, frame_callback));
+    TEST_ASSERT_FALSE(captured_frames[0].flags & CFF_FRAME_FLAG_PAYLOAD_UNVERIFIED);
+}
+
+// Build one frame per entry of counters into buffer and return the total size
+static size_t build_counter_stream(uint8_t *buffer, size_t buffer_size, const uint16_t *counters, size_t count)
+{
+    cff_frame_builder_t builder;
+    size_t stream_size = 0;
+    for (size_t i = 0; i < count; i++) {
+        cff_frame_builder_init(&builder, &buffer[stream_size], buffer_size - stream_size);
+        builder.frame_counter = counters[i];
+        cff_build_frame(&builder, (const uint8_t *) "Data", 4);
+        stream_size += cff_calculate_frame_size_bytes(4);
+    }
+    return stream_size;
+}
+
+static void parse_counter_stream(cff_parser_t *parser, cff_ring_buffer_t *ring_buffer, uint8_t *ring_storage,
+                                 uint32_t storage_size, const uint16_t *counters, size_t count)
+{
+    uint8_t stream[256];
+    size_t stream_size = build_counter_stream(stream, sizeof(stream), counters, count);
+    setup_ring_buffer_from_data(ring_buffer, ring_storage, storage_size, stream, stream_size);
+    cff_parser_init(parser, ring_buffer);
+    TEST_ASSERT_EQUAL(count, cff_parser_parse_frames(parser, frame_callback));
+}
+
+void test_parser_counts_frame_counter_gaps(void)
+{
+    const uint16_t counters[] = {10, 11, 14, 15, 20};
+    uint8_t ring_storage[256];
+    cff_ring_buffer_t ring_buffer;
+    cff_parser_t parser;
+    parse_counter_stream(&parser, &ring_buffer, ring_storage, sizeof(ring_storage), counters, 5);
+
+    TEST_ASSERT_EQUAL(0, captured_frames[0].flags & CFF_FRAME_FLAG_COUNTER_GAP);
+    TEST_ASSERT_EQUAL(0, captured_frames[1].flags & CFF_FRAME_FLAG_COUNTER_GAP);
+    TEST_ASSERT_TRUE(captured_frames[2].flags & CFF_FRAME_FLAG_COUNTER_GAP);
+    TEST_ASSERT_EQUAL(0, captured_frames[3].flags & CFF_FRAME_FLAG_COUNTER_GAP);
+    TEST_ASSERT_TRUE(captured_frames[4].flags & CFF_FRAME_FLAG_COUNTER_GAP);
+    TEST_ASSERT_EQUAL(6, parser.frames_lost);
+    TEST_ASSERT_EQUAL(0, parser.frames_duplicated);
+    TEST_ASSERT_EQUAL(0, parser.frames_reordered);
+    TEST_ASSERT_EQUAL(20, parser.last_frame_counter);
+}
+
+void test_parser_frame_counter_rollover_is_not_a_gap(void)
+{
+    const uint16_t counters[] = {65534, 65535, 0, 1, 3};
+    uint8_t ring_storage[256];
+    cff_ring_buffer_t ring_buffer;
+    cff_parser_t parser;
+    parse_counter_stream(&parser, &ring_buffer, ring_storage, sizeof(ring_storage), counters, 5);
+
+    for (size_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(0, captured_frames[i].flags & (CFF_FRAME_FLAG_COUNTER_GAP | CFF_FRAME_FLAG_COUNTER_DUPLICATE |
+                                                         CFF_FRAME_FLAG_COUNTER_REORDERED));
+    }
+    TEST_ASSERT_TRUE(captured_frames[4].flags & CFF_FRAME_FLAG_COUNTER_GAP);
+    TEST_ASSERT_EQUAL(1, parser.frames_lost);
+}
+
+void test_parser_flags_duplicate_and_reordered_frames(void)
+{
+    const uint16_t counters[] = {65535, 65535, 1, 0, 2};
+    uint8_t ring_storage[256];
+    cff_ring_buffer_t ring_buffer;
+    cff_parser_t parser;
+    parse_counter_stream(&parser, &ring_buffer, ring_storage, sizeof(ring_storage), counters, 5);
+
+    TEST_ASSERT_TRUE(captured_frames[1].flags & CFF_FRAME_FLAG_COUNTER_DUPLICATE);
+    TEST_ASSERT_TRUE(captured_frames[2].flags & CFF_FRAME_FLAG_COUNTER_GAP);
+    TEST_ASSERT_TRUE(captured_frames[3].flags & CFF_FRAME_FLAG_COUNTER_REORDERED);
+    TEST_ASSERT_EQUAL(0, captured_frames[4].flags & (CFF_FRAME_FLAG_COUNTER_GAP | CFF_FRAME_FLAG_COUNTER_REORDERED));
+
+    // The late frame 0 was first counted as lost
+    TEST_ASSERT_EQUAL(0, parser.frames_lost);
+    TEST_ASSERT_EQUAL(1, parser.frames_duplicated);
+    TEST_ASSERT_EQUAL(1, parser.frames_reordered);
+    TEST_ASSERT_EQUAL(2, parser.last_frame_counter);
+}
+
+void test_parser_reset_keeps_frame_counter_totals(void)
+{
+    const uint16_t counters[] = {0, 2};
+    uint8_t ring_storage[256];
+    cff_ring_buffer_t ring_buffer;
+    cff_parser_t parser;
+    parse_counter_stream(&parser, &ring_buffer, ring_storage, sizeof(ring_storage), counters, 2);
+    TEST_ASSERT_EQUAL(1, parser.frames_lost);
+
+    cff_parser_reset(&parser);
+    TEST_ASSERT_EQUAL(1, parser.frames_lost);
+    TEST_ASSERT_EQUAL(2, parser.last_frame_counter);
+
+    cff_parser_init(&parser, &ring_buffer);
+    TEST_ASSERT_EQUAL(0, parser.frames_lost);
+    TEST_ASSERT_FALSE(parser.frame_counter_valid);
+}
+
+static cff_callback_result_en_t capture_frame_ex(const cff_frame_t *frame, void *user)
+{
+    (void) user;
+    frame_callback(frame);
+    return cff_callback_continue;
+}
+
+void test_parse_buffer_null_pointers(void)
+{
+    uint8_t data[4] = {0};
+    size_t frames_parsed = 1;
+    TEST_ASSERT_EQUAL(0, cff_parse_buffer(NULL, 4, capture_frame_ex, NULL, &frames_parsed));
+    TEST_ASSERT_EQUAL(0, frames_parsed);
+    TEST_ASSERT_EQUAL(0, cff_parse_buffer(data, 4, NULL, NULL, NULL));
+    TEST_ASSERT_EQUAL(0, cff_parse_buffer(data, 0, capture_frame_ex, NULL, NULL));
+}
+
+void test_parse_buffer_matches_ring_buffer_parse(void)
+{
+    // Garbage, a stray preamble byte, a corrupted frame and a false preamble between valid frames
+    uint8_t stream[256];
+    size_t stream_size = 0;
+    const char *payloads[] = {"First", "Second frame", "Corrupted", "Fourth", ""};
+    cff_frame_builder_t builder;
+    for (size_t i = 0; i < 5; i++) {
+        stream[stream_size++] = 0x42;
+        stream[stream_size++] = CFF_PREAMBLE_BYTE_0;
+        stream[stream_size++] = CFF_PREAMBLE_BYTE_0;
+        stream[stream_size++] = CFF_PREAMBLE_BYTE_1;
+        cff_frame_builder_init(&builder, &stream[stream_size], sizeof(stream) - stream_size);
+        builder.frame_counter = (uint16_t) i;
+        cff_build_frame(&builder, (const uint8_t *) payloads[i], strlen(payloads[i]));
+        if (i == 2) {
+            stream[stream_size + CFF_HEADER_SIZE_BYTES] ^= 0xFF;
+        }
+        stream_size += cff_calculate_frame_size_bytes(strlen(payloads[i]));
+    }
+
+    uint8_t ring_storage[256];
+    cff_ring_buffer_t ring_buffer;
+    setup_ring_buffer_from_data(&ring_buffer, ring_storage, sizeof(ring_storage), stream, stream_size);
+    TEST_ASSERT_EQUAL(4, cff_parse_frames(&ring_buffer, frame_callback));
+    cff_frame_t ring_frames[4];
+    memcpy(ring_frames, captured_frames, sizeof(ring_frames));
+
+    callback_count = 0;
+    size_t frames_parsed = 0;
+    TEST_ASSERT_EQUAL(stream_size, cff_parse_buffer(stream, stream_size, capture_frame_ex, NULL, &frames_parsed));
+    TEST_ASSERT_EQUAL(4, frames_parsed);
+    for (size_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(ring_frames[i].header.frame_counter, captured_frames[i].header.frame_counter);
+        TEST_ASSERT_EQUAL(ring_frames[i].payload_size_bytes, captured_frames[i].payload_size_bytes);
+        TEST_ASSERT_EQUAL(ring_frames[i].payload_crc, captured_frames[i].payload_crc);
+        TEST_ASSERT_TRUE(captured_frames[i].flags & CFF_FRAME_FLAG_PAYLOAD_CONTIGUOUS);
+        TEST_ASSERT_EQUAL_PTR(&stream[captured_frames[i].offset_bytes + CFF_HEADER_SIZE_BYTES],
+                              captured_frames[i].payload);
+    }
+}
+
+void test_parse_buffer_leaves_incomplete_frame_unconsumed(void)
+{
+    uint8_t stream[64];
+    size_t first_size = build_test_frame(stream, sizeof(stream), "First");
+    size_t second_size = build_test_frame(&stream[first_size], sizeof(stream) - first_size, "Second");
+
+    // Every cut inside the second frame consumes exactly the first one
+    for (size_t cut = 1; cut < second_size; cut++) {
+        callback_count = 0;
+        TEST_ASSERT_EQUAL(first_size, cff_parse_buffer(stream, first_size + cut, capture_frame_ex, NULL, NULL));
+        TEST_ASSERT_EQUAL(1, callback_count);
+    }
+
+    // A trailing first preamble byte is kept as well
+    uint8_t garbage[] = {0x11, 0x22, CFF_PREAMBLE_BYTE_0};
+    TEST_ASSERT_EQUAL(2, cff_parse_buffer(garbage, sizeof(garbage), capture_frame_ex, NULL, NULL));
+    garbage[2] = 0x33;
+    TEST_ASSERT_EQUAL(3, cff_parse_buffer(garbage, sizeof(garbage), capture_frame_ex, NULL, NULL));
+}
+
+void test_parse_buffer_stops_when_callback_asks(void)
+{
+    uint8_t stream[128];
+    size_t stream_size = build_test_stream(stream, sizeof(stream), 4);
+
+    link_context_t link = {0, 2, 0};
+    size_t frames_parsed = 0;
+    TEST_ASSERT_EQUAL(stream_size / 2, cff_parse_buffer(stream, stream_size, link_callback, &link, &frames_parsed));
+    TEST_ASSERT_EQUAL(2, frames_parsed);
+    TEST_ASSERT_EQUAL(1, link.last_frame_counter);
+}
@@ -0,0 +1,337 @@
+#include "cff.h"
+#include "unity.h"
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TEST_THREADS 1
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+// Sizes covering the masked (power-of-two) and compared index paths
+static const uint32_t test_sizes[] = {1, 2, 3, 7, 8, 16, 17, 31, 32, 64};
+static const size_t num_test_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
+
+void test_ring_buffer_init_rejects_oversized_buffer(void)
+{
+    uint8_t storage[4];
+    cff_ring_buffer_t ring_buffer;
+
+    cff_error_en_t result = cff_ring_buffer_init(&ring_buffer, storage, CFF_RING_BUFFER_MAX_SIZE + 1);
+    TEST_ASSERT_EQUAL(cff_error_not_supported, result);
+    TEST_ASSERT_EQUAL(cff_error_buffer_too_small, cff_ring_buffer_init(&ring_buffer, storage, 0));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_ring_buffer_init(NULL, storage, sizeof(storage)));
+    TEST_ASSERT_EQUAL(0, cff_ring_buffer_available_data(NULL));
+    TEST_ASSERT_EQUAL(0, cff_ring_buffer_free_space(NULL));
+}
+
+void test_ring_buffer_init_selects_index_mask(void)
+{
+    uint8_t storage[64];
+    cff_ring_buffer_t ring_buffer;
+
+    cff_ring_buffer_init(&ring_buffer, storage, 64);
+    TEST_ASSERT_EQUAL_HEX32(127, ring_buffer.index_mask);
+    cff_ring_buffer_init(&ring_buffer, storage, 1);
+    TEST_ASSERT_EQUAL_HEX32(1, ring_buffer.index_mask);
+    cff_ring_buffer_init(&ring_buffer, storage, 48);
+    TEST_ASSERT_EQUAL_HEX32(0, ring_buffer.index_mask);
+}
+
+void test_ring_buffer_full_and_empty_are_distinct(void)
+{
+    uint8_t storage[64];
+    uint8_t data[64];
+    memset(data, 0x5A, sizeof(data));
+
+    for (size_t i = 0; i < num_test_sizes; i++) {
+        uint32_t size = test_sizes[i];
+        cff_ring_buffer_t ring_buffer;
+        cff_ring_buffer_init(&ring_buffer, storage, size);
+        TEST_ASSERT_EQUAL(0, cff_ring_buffer_available_data(&ring_buffer));
+        TEST_ASSERT_EQUAL(size, cff_ring_buffer_free_space(&ring_buffer));
+
+        TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_append(&ring_buffer, data, size));
+        TEST_ASSERT_EQUAL(size, cff_ring_buffer_available_data(&ring_buffer));
+        TEST_ASSERT_EQUAL(0, cff_ring_buffer_free_space(&ring_buffer));
+        TEST_ASSERT_EQUAL(cff_error_insufficient_space, cff_ring_buffer_append(&ring_buffer, data, 1));
+
+        TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_advance(&ring_buffer, size));
+        TEST_ASSERT_EQUAL(0, cff_ring_buffer_available_data(&ring_buffer));
+        TEST_ASSERT_EQUAL(cff_error_insufficient_space, cff_ring_buffer_advance(&ring_buffer, 1));
+    }
+}
+
+void test_ring_buffer_data_survives_many_index_wraps(void)
+{
+    uint8_t storage[64];
+    uint8_t in[64];
+    uint8_t out[64];
+
+    for (size_t i = 0; i < num_test_sizes; i++) {
+        uint32_t size = test_sizes[i];
+        cff_ring_buffer_t ring_buffer;
+        cff_ring_buffer_init(&ring_buffer, storage, size);
+
+        // Chunk sizes that don't divide the size walk the indices through every position, several times over
+        uint8_t next_in = 0;
+        uint8_t next_out = 0;
+        for (uint32_t step = 0; step < 10 * size; step++) {
+            uint32_t chunk_size = 1 + step % size;
+            for (uint32_t j = 0; j < chunk_size; j++) {
+                in[j] = next_in++;
+            }
+            TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_append(&ring_buffer, in, chunk_size));
+            TEST_ASSERT_EQUAL(chunk_size, cff_ring_buffer_available_data(&ring_buffer));
+            TEST_ASSERT_TRUE(ring_buffer.append_index < 2 * size);
+
+            TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_consume(&ring_buffer, out, chunk_size));
+            for (uint32_t j = 0; j < chunk_size; j++) {
+                TEST_ASSERT_EQUAL_HEX8(next_out++, out[j]);
+            }
+            TEST_ASSERT_TRUE(ring_buffer.consume_index < 2 * size);
+        }
+    }
+}
+
+void test_ring_buffer_partial_fill_at_every_position(void)
+{
+    uint8_t storage[17];
+    uint8_t data[17];
+    uint8_t out[17];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) (i + 1);
+    }
+
+    // Append more than half, consume less, so the fill level crosses both index wrap points
+    cff_ring_buffer_t ring_buffer;
+    cff_ring_buffer_init(&ring_buffer, storage, sizeof(storage));
+    for (uint32_t start = 0; start < 2 * sizeof(storage); start++) {
+        TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_append(&ring_buffer, data, 11));
+        TEST_ASSERT_EQUAL(11, cff_ring_buffer_available_data(&ring_buffer));
+        TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_consume(&ring_buffer, out, 10));
+        TEST_ASSERT_EQUAL_MEMORY(data, out, 10);
+        TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_consume(&ring_buffer, out, 1));
+        TEST_ASSERT_EQUAL_HEX8(11, out[0]);
+        cff_ring_buffer_append(&ring_buffer, data, 1);
+        cff_ring_buffer_advance(&ring_buffer, 1);
+    }
+}
+
+#if defined(TEST_THREADS)
+
+// Shared between the producer thread and the consumer (the test itself)
+#define SPSC_TOTAL_BYTES (1024 * 1024)
+static cff_ring_buffer_t spsc_ring_buffer;
+static uint8_t spsc_storage[61]; // Small and not a power of two, so both sides wrap and contend constantly
+static const uint8_t *spsc_stream;
+static size_t spsc_stream_size;
+
+static void *spsc_producer(void *arg)
+{
+    (void) arg;
+    size_t offset = 0;
+    uint32_t chunk_size = 1;
+    while (offset < spsc_stream_size) {
+        uint32_t size = (uint32_t) CFF_MIN(chunk_size, spsc_stream_size - offset);
+        if (cff_ring_buffer_append(&spsc_ring_buffer, &spsc_stream[offset], size) == cff_error_none) {
+            offset += size;
+            chunk_size = chunk_size % 23 + 1;
+        }
+        else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void start_spsc_producer(pthread_t *thread, const uint8_t *stream, size_t stream_size)
+{
+    cff_ring_buffer_init(&spsc_ring_buffer, spsc_storage, sizeof(spsc_storage));
+    spsc_stream = stream;
+    spsc_stream_size = stream_size;
+    TEST_ASSERT_EQUAL(0, pthread_create(thread, NULL, spsc_producer, NULL));
+}
+
+void test_ring_buffer_spsc_threads_transfer_bytes_in_order(void)
+{
+    static uint8_t stream[SPSC_TOTAL_BYTES];
+    for (size_t i = 0; i < sizeof(stream); i++) {
+        stream[i] = (uint8_t) (i ^ (i >> 8));
+    }
+
+    pthread_t producer;
+    start_spsc_producer(&producer, stream, sizeof(stream));
+
+    // Consume in chunk sizes unrelated to the producer's, checking every byte
+    size_t received = 0;
+    uint32_t chunk_size = 1;
+    int mismatches = 0;
+    while (received < sizeof(stream)) {
+        uint8_t chunk[32];
+        uint32_t size = (uint32_t) CFF_MIN(CFF_MIN(chunk_size, cff_ring_buffer_available_data(&spsc_ring_buffer)),
+                                           sizeof(stream) - received);
+        if (size == 0) {
+            sched_yield();
+            continue;
+        }
+        TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_consume(&spsc_ring_buffer, chunk, size));
+        mismatches += memcmp(chunk, &stream[received], size) != 0;
+        received += size;
+        chunk_size = chunk_size % 31 + 1;
+    }
+
+    pthread_join(producer, NULL);
+    TEST_ASSERT_EQUAL(0, mismatches);
+    TEST_ASSERT_EQUAL(0, cff_ring_buffer_available_data(&spsc_ring_buffer));
+}
+
+static size_t spsc_frames_received = 0;
+static int spsc_frame_errors = 0;
+
+static void spsc_frame_callback(const cff_frame_t *frame)
+{
+    uint8_t payload[16];
+    cff_copy_frame_payload(frame, payload, sizeof(payload));
+    spsc_frame_errors += frame->header.frame_counter != (uint16_t) spsc_frames_received;
+    spsc_frame_errors += payload[0] != (uint8_t) spsc_frames_received;
+    spsc_frames_received++;
+}
+
+void test_ring_buffer_spsc_threads_parse_frames(void)
+{
+    // Frames with a 16 byte payload whose first byte echoes the frame counter
+    const size_t frame_count = 20000;
+    static uint8_t stream[20000 * (CFF_MIN_FRAME_SIZE_BYTES + 16)];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, stream, sizeof(stream));
+    for (size_t i = 0; i < frame_count; i++) {
+        uint8_t payload[16];
+        memset(payload, (int) i, sizeof(payload));
+        builder.buffer = &stream[i * cff_calculate_frame_size_bytes(16)];
+        cff_build_frame(&builder, payload, sizeof(payload));
+    }
+
+    spsc_frames_received = 0;
+    spsc_frame_errors = 0;
+    pthread_t producer;
+    start_spsc_producer(&producer, stream, sizeof(stream));
+
+    cff_parser_t parser;
+    cff_parser_init(&parser, &spsc_ring_buffer);
+    while (spsc_frames_received < frame_count) {
+        if (cff_parser_parse_frames(&parser, spsc_frame_callback) == 0) {
+            sched_yield();
+        }
+    }
+
+    pthread_join(producer, NULL);
+    TEST_ASSERT_EQUAL(0, spsc_frame_errors);
+    TEST_ASSERT_EQUAL(frame_count, spsc_frames_received);
+}
+
+#endif
+
+void test_ring_buffer_reserve_null_pointers(void)
+{
+    uint8_t storage[8];
+    cff_ring_buffer_t ring_buffer;
+    cff_ring_buffer_init(&ring_buffer, storage, sizeof(storage));
+    uint8_t *region;
+    uint32_t region_size;
+
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_ring_buffer_reserve(NULL, &region, &region_size));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_ring_buffer_reserve(&ring_buffer, NULL, &region_size));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_ring_buffer_reserve(&ring_buffer, &region, NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_ring_buffer_commit(NULL, 1));
+}
+
+void test_ring_buffer_reserve_returns_contiguous_free_space(void)
+{
+    uint8_t storage[10];
+    cff_ring_buffer_t ring_buffer;
+    cff_ring_buffer_init(&ring_buffer, storage, sizeof(storage));
+    uint8_t *region;
+    uint32_t region_size;
+
+    // Empty: the whole storage
+    TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_reserve(&ring_buffer, &region, &region_size));
+    TEST_ASSERT_EQUAL_PTR(storage, region);
+    TEST_ASSERT_EQUAL(10, region_size);
+
+    // Write 7 in place, consume 5: the region runs to the end of the storage only
+    memcpy(region, "ABCDEFG", 7);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_commit(&ring_buffer, 7));
+    cff_ring_buffer_advance(&ring_buffer, 5);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_reserve(&ring_buffer, &region, &region_size));
+    TEST_ASSERT_EQUAL_PTR(&storage[7], region);
+    TEST_ASSERT_EQUAL(3, region_size);
+
+    // After filling that, the rest of the free space is at the start of the storage, up to the consume index
+    memcpy(region, "HIJ", 3);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_commit(&ring_buffer, 3));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_reserve(&ring_buffer, &region, &region_size));
+    TEST_ASSERT_EQUAL_PTR(storage, region);
+    TEST_ASSERT_EQUAL(5, region_size);
+    memcpy(region, "KLMNO", 5);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_commit(&ring_buffer, 5));
+
+    // Full
+    TEST_ASSERT_EQUAL(cff_error_insufficient_space, cff_ring_buffer_reserve(&ring_buffer, &region, &region_size));
+    TEST_ASSERT_EQUAL(0, region_size);
+    TEST_ASSERT_EQUAL(cff_error_insufficient_space, cff_ring_buffer_commit(&ring_buffer, 1));
+
+    uint8_t out[10];
+    TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_consume(&ring_buffer, out, 10));
+    TEST_ASSERT_EQUAL_MEMORY("FGHIJKLMNO", out, 10);
+}
+
+static int frames_received = 0;
+
+static void count_frame(const cff_frame_t *frame)
+{
+    uint8_t payload[14];
+    TEST_ASSERT_EQUAL(cff_error_none, cff_copy_frame_payload(frame, payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL_MEMORY("Direct to ring", payload, sizeof(payload));
+    frames_received++;
+}
+
+void test_ring_buffer_reserve_commit_feeds_parser(void)
+{
+    uint8_t frame_buffer[64];
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, frame_buffer, sizeof(frame_buffer));
+    cff_build_frame(&builder, (const uint8_t *) "Direct to ring", 14);
+    size_t frame_size = cff_calculate_frame_size_bytes(14);
+
+    uint8_t storage[40];
+    cff_ring_buffer_t ring_buffer;
+    cff_ring_buffer_init(&ring_buffer, storage, sizeof(storage));
+    cff_parser_t parser;
+    cff_parser_init(&parser, &ring_buffer);
+    frames_received = 0;
+
+    // Receive frames the way a DMA driver would: straight into the reserved region, a few bytes per transfer
+    for (int frame = 0; frame < 3; frame++) {
+        size_t written = 0;
+        while (written < frame_size) {
+            uint8_t *region;
+            uint32_t region_size;
+            TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_reserve(&ring_buffer, &region, &region_size));
+            uint32_t transfer_size = (uint32_t) CFF_MIN(CFF_MIN(region_size, 9), frame_size - written);
+            memcpy(region, &frame_buffer[written], transfer_size);
+            TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_commit(&ring_buffer, transfer_size));
+            written += transfer_size;
+            cff_parser_parse_frames(&parser, count_frame);
+        }
+    }
+    TEST_ASSERT_EQUAL(3, frames_received);
+}
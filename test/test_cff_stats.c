@@ -0,0 +1,210 @@
+#include "cff.h"
+#include "unity.h"
+#include <string.h>
+
+// Built with CFF_ENABLE_STATS, see project.yml
+
+static uint8_t ring_storage[256];
+static cff_ring_buffer_t ring_buffer;
+static cff_stats_t stats;
+static int callback_count = 0;
+
+static void frame_callback(const cff_frame_t *frame)
+{
+    (void) frame;
+    callback_count++;
+}
+
+void setUp(void)
+{
+    callback_count = 0;
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+    cff_stats_reset(&stats);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_ring_buffer_set_stats(&ring_buffer, &stats));
+}
+
+void tearDown(void)
+{
+}
+
+// Build a frame with the given payload into buffer and return its size
+static size_t build_frame(uint8_t *buffer, size_t buffer_size, uint16_t frame_counter, const char *payload)
+{
+    cff_frame_builder_t builder;
+    cff_frame_builder_init(&builder, buffer, buffer_size);
+    builder.frame_counter = frame_counter;
+    cff_build_frame(&builder, (const uint8_t *) payload, strlen(payload));
+    return cff_calculate_frame_size_bytes(strlen(payload));
+}
+
+void test_stats_null_pointers(void)
+{
+    cff_stats_t snapshot;
+    cff_frame_builder_t builder;
+
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_stats_snapshot(NULL, &snapshot));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_stats_snapshot(&stats, NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_stats_reset(NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_ring_buffer_set_stats(NULL, &stats));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_frame_builder_set_stats(NULL, &stats));
+
+    // Detaching is allowed
+    uint8_t buffer[32];
+    cff_frame_builder_init(&builder, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_set_stats(&builder, NULL));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_build_frame(&builder, buffer, 0));
+}
+
+void test_stats_snapshot_and_reset(void)
+{
+    uint8_t data[10] = {0};
+    cff_stats_t snapshot;
+
+    cff_ring_buffer_append(&ring_buffer, data, sizeof(data));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_stats_snapshot(&stats, &snapshot));
+    TEST_ASSERT_EQUAL(10, snapshot.bytes_appended);
+
+    // The snapshot doesn't change with the live counters
+    cff_ring_buffer_append(&ring_buffer, data, sizeof(data));
+    TEST_ASSERT_EQUAL(10, snapshot.bytes_appended);
+    TEST_ASSERT_EQUAL(20, stats.bytes_appended);
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_stats_reset(&stats));
+    TEST_ASSERT_EQUAL(0, stats.bytes_appended);
+    TEST_ASSERT_EQUAL(0, stats.ring_high_water_mark);
+}
+
+void test_stats_ring_buffer_fill(void)
+{
+    uint8_t data[200] = {0};
+
+    cff_ring_buffer_append(&ring_buffer, data, 100);
+    cff_ring_buffer_advance(&ring_buffer, 100);
+    cff_ring_buffer_append(&ring_buffer, data, 60);
+    TEST_ASSERT_EQUAL(160, stats.bytes_appended);
+    TEST_ASSERT_EQUAL(100, stats.ring_high_water_mark);
+
+    // Writes through reserve and commit count the same way
+    CFF_RB_T *region;
+    uint32_t region_size;
+    cff_ring_buffer_reserve(&ring_buffer, &region, &region_size);
+    cff_ring_buffer_commit(&ring_buffer, 90);
+    TEST_ASSERT_EQUAL(250, stats.bytes_appended);
+    TEST_ASSERT_EQUAL(150, stats.ring_high_water_mark);
+
+    // A slow consumer shows up as rejected appends
+    TEST_ASSERT_EQUAL(cff_error_insufficient_space, cff_ring_buffer_append(&ring_buffer, data, 200));
+    TEST_ASSERT_EQUAL(cff_error_insufficient_space, cff_ring_buffer_commit(&ring_buffer, 200));
+    TEST_ASSERT_EQUAL(2, stats.append_overflows);
+    TEST_ASSERT_EQUAL(250, stats.bytes_appended);
+}
+
+void test_stats_parser_resync(void)
+{
+    uint8_t stream[200];
+    size_t size = 0;
+
+    // Noise containing a preamble with a bad header, then a valid frame
+    const uint8_t noise[] = {0x12, 0x34, CFF_PREAMBLE_BYTE_0, CFF_PREAMBLE_BYTE_1, 0, 0, 0, 0, 0, 0};
+    memcpy(stream, noise, sizeof(noise));
+    size += sizeof(noise);
+    size += build_frame(&stream[size], sizeof(stream) - size, 0, "first");
+
+    // A frame with a corrupted header right behind it
+    size_t header_frame_size = build_frame(&stream[size], sizeof(stream) - size, 1, "header");
+    stream[size + 2] ^= 0x01;
+    size += header_frame_size;
+
+    // A frame with a corrupted payload
+    size_t payload_frame_size = build_frame(&stream[size], sizeof(stream) - size, 2, "payload");
+    stream[size + CFF_HEADER_SIZE_BYTES] ^= 0x01;
+    size += payload_frame_size;
+
+    size += build_frame(&stream[size], sizeof(stream) - size, 3, "second");
+
+    // The header and part of the payload of a frame that hasn't fully arrived
+    uint8_t partial[32];
+    build_frame(partial, sizeof(partial), 4, "partial");
+    memcpy(&stream[size], partial, CFF_HEADER_SIZE_BYTES + 2);
+    size += CFF_HEADER_SIZE_BYTES + 2;
+
+    cff_ring_buffer_append(&ring_buffer, stream, (uint32_t) size);
+    TEST_ASSERT_EQUAL(2, cff_parse_frames(&ring_buffer, frame_callback));
+
+    TEST_ASSERT_EQUAL(2, callback_count);
+    TEST_ASSERT_EQUAL(2, stats.frames_parsed);
+    TEST_ASSERT_EQUAL(1, stats.preamble_false_positives);
+    TEST_ASSERT_EQUAL(1, stats.header_crc_errors);
+    TEST_ASSERT_EQUAL(1, stats.payload_crc_errors);
+    TEST_ASSERT_EQUAL(1, stats.incomplete_frame_stalls);
+    TEST_ASSERT_EQUAL(sizeof(noise) + header_frame_size + payload_frame_size, stats.bytes_skipped);
+
+    // More of the frame arriving is one more stall, all of it completes the frame
+    cff_ring_buffer_append(&ring_buffer, &partial[CFF_HEADER_SIZE_BYTES + 2], 2);
+    TEST_ASSERT_EQUAL(0, cff_parse_frames(&ring_buffer, frame_callback));
+    TEST_ASSERT_EQUAL(2, stats.incomplete_frame_stalls);
+
+    cff_ring_buffer_append(&ring_buffer, &partial[CFF_HEADER_SIZE_BYTES + 4], CFF_PAYLOAD_CRC_SIZE_BYTES + 3);
+    TEST_ASSERT_EQUAL(1, cff_parse_frames(&ring_buffer, frame_callback));
+    TEST_ASSERT_EQUAL(3, stats.frames_parsed);
+    TEST_ASSERT_EQUAL(2, stats.incomplete_frame_stalls);
+}
+
+void test_stats_parse_frame(void)
+{
+    uint8_t frame[32];
+    size_t frame_size = build_frame(frame, sizeof(frame), 0, "hello");
+    cff_frame_t parsed;
+
+    // Waiting for the rest of a frame
+    cff_ring_buffer_append(&ring_buffer, frame, 4);
+    TEST_ASSERT_EQUAL(cff_error_incomplete_frame, cff_parse_frame(&ring_buffer, &parsed));
+    cff_ring_buffer_append(&ring_buffer, &frame[4], (uint32_t) frame_size - 5);
+    TEST_ASSERT_EQUAL(cff_error_incomplete_frame, cff_parse_frame(&ring_buffer, &parsed));
+    TEST_ASSERT_EQUAL(2, stats.incomplete_frame_stalls);
+
+    cff_ring_buffer_append(&ring_buffer, &frame[frame_size - 1], 1);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_parse_frame(&ring_buffer, &parsed));
+    TEST_ASSERT_EQUAL(1, stats.frames_parsed);
+
+    // An empty ring buffer isn't a stall
+    TEST_ASSERT_EQUAL(cff_error_incomplete_frame, cff_parse_frame(&ring_buffer, &parsed));
+    TEST_ASSERT_EQUAL(2, stats.incomplete_frame_stalls);
+
+    frame[CFF_HEADER_SIZE_BYTES] ^= 0x01;
+    cff_ring_buffer_append(&ring_buffer, frame, (uint32_t) frame_size);
+    TEST_ASSERT_EQUAL(cff_error_invalid_payload_crc, cff_parse_frame(&ring_buffer, &parsed));
+    TEST_ASSERT_EQUAL(1, stats.payload_crc_errors);
+
+    cff_ring_buffer_advance(&ring_buffer, (uint32_t) frame_size);
+    frame[3] ^= 0x01;
+    cff_ring_buffer_append(&ring_buffer, frame, (uint32_t) frame_size);
+    TEST_ASSERT_EQUAL(cff_error_invalid_header_crc, cff_parse_frame(&ring_buffer, &parsed));
+    TEST_ASSERT_EQUAL(1, stats.header_crc_errors);
+    TEST_ASSERT_EQUAL(1, stats.frames_parsed);
+}
+
+void test_stats_builder(void)
+{
+    uint8_t buffer[64];
+    uint8_t payload[10] = {0};
+    cff_frame_builder_t builder;
+    cff_span_t segments[CFF_FRAME_SEGMENT_COUNT];
+
+    cff_frame_builder_init(&builder, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_set_stats(&builder, &stats));
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_build_frame(&builder, payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_batch_build_frame(&builder, payload, 0));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_build_frame_segments(&builder, payload, 4, segments));
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_begin(&builder, 2));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_append(&builder, payload, 2));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_frame_builder_end(&builder));
+
+    // Failed builds aren't counted
+    TEST_ASSERT_EQUAL(cff_error_buffer_too_small, cff_build_frame(&builder, payload, 100));
+
+    TEST_ASSERT_EQUAL(4, stats.frames_built);
+    TEST_ASSERT_EQUAL(4 * CFF_MIN_FRAME_SIZE_BYTES + 16, stats.bytes_built);
+}
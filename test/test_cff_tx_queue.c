@@ -0,0 +1,222 @@
+#include "cff.h"
+#include "unity.h"
+#include <string.h>
+
+#define MAX_TRANSFERS 16
+
+static cff_tx_queue_t queue;
+static uint8_t queue_buffer[128];
+
+// Stands in for the DMA: records each transfer and everything sent
+static size_t transfer_sizes[MAX_TRANSFERS];
+static size_t transfer_count;
+static uint8_t wire[1024];
+static size_t wire_size;
+
+static void start_transfer(const uint8_t *data, size_t data_size_bytes, void *user)
+{
+    TEST_ASSERT_EQUAL_PTR(&queue, user);
+    TEST_ASSERT_TRUE(transfer_count < MAX_TRANSFERS);
+    TEST_ASSERT_TRUE(wire_size + data_size_bytes <= sizeof(wire));
+    transfer_sizes[transfer_count++] = data_size_bytes;
+    memcpy(&wire[wire_size], data, data_size_bytes);
+    wire_size += data_size_bytes;
+}
+
+// CRC provider that raises the DMA-done "interrupt" while a frame is being built
+static int interrupts_pending;
+
+static uint16_t interrupting_crc_begin(void *context)
+{
+    (void) context;
+    if (interrupts_pending > 0) {
+        interrupts_pending--;
+        TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_transfer_complete(&queue));
+    }
+    return CFF_CRC_INIT;
+}
+
+static uint16_t interrupting_crc_update(void *context, uint16_t crc, const uint8_t *data, size_t data_size_bytes)
+{
+    (void) context;
+    for (size_t i = 0; i < data_size_bytes; i++) {
+        crc ^= (uint16_t) (data[i] << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ CFF_CRC_POLYNOMIAL) : (uint16_t) (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t interrupting_crc_finish(void *context, uint16_t crc)
+{
+    (void) context;
+    return crc;
+}
+
+static const cff_crc_provider_t interrupting_provider = {interrupting_crc_begin, interrupting_crc_update,
+                                                         interrupting_crc_finish, NULL};
+
+// Frame counters of the frames received from the wire
+static uint16_t received_counters[64];
+static size_t received_count;
+
+static void frame_callback(const cff_frame_t *frame)
+{
+    received_counters[received_count++] = frame->header.frame_counter;
+}
+
+static size_t receive_wire(void)
+{
+    uint8_t ring_storage[1024];
+    cff_ring_buffer_t ring_buffer;
+    cff_ring_buffer_init(&ring_buffer, ring_storage, sizeof(ring_storage));
+    cff_ring_buffer_append(&ring_buffer, wire, (uint32_t) wire_size);
+    return cff_parse_frames(&ring_buffer, frame_callback);
+}
+
+void setUp(void)
+{
+    transfer_count = 0;
+    wire_size = 0;
+    received_count = 0;
+    interrupts_pending = 0;
+    TEST_ASSERT_EQUAL(cff_error_none,
+                      cff_tx_queue_init(&queue, queue_buffer, sizeof(queue_buffer), start_transfer, &queue));
+}
+
+void tearDown(void)
+{
+    cff_crc_set_provider(NULL);
+}
+
+void test_tx_queue_init_errors(void)
+{
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_tx_queue_init(NULL, queue_buffer, 64, start_transfer, NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_tx_queue_init(&queue, NULL, 64, start_transfer, NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_tx_queue_init(&queue, queue_buffer, 64, NULL, NULL));
+    TEST_ASSERT_EQUAL(cff_error_buffer_too_small,
+                      cff_tx_queue_init(&queue, queue_buffer, 2 * CFF_MIN_FRAME_SIZE_BYTES - 1, start_transfer, NULL));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_tx_queue_enqueue(NULL, queue_buffer, 1));
+    TEST_ASSERT_EQUAL(cff_error_null_pointer, cff_tx_queue_transfer_complete(NULL));
+    TEST_ASSERT_FALSE(cff_tx_queue_idle(NULL));
+}
+
+void test_tx_queue_idle_link_sends_at_once(void)
+{
+    const uint8_t payload[] = "hello";
+
+    TEST_ASSERT_TRUE(cff_tx_queue_idle(&queue));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_enqueue(&queue, payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL(1, transfer_count);
+    TEST_ASSERT_EQUAL(cff_calculate_frame_size_bytes(sizeof(payload)), transfer_sizes[0]);
+    TEST_ASSERT_FALSE(cff_tx_queue_idle(&queue));
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_transfer_complete(&queue));
+    TEST_ASSERT_TRUE(cff_tx_queue_idle(&queue));
+    TEST_ASSERT_EQUAL(1, transfer_count);
+    TEST_ASSERT_EQUAL(cff_error_invalid_state, cff_tx_queue_transfer_complete(&queue));
+}
+
+void test_tx_queue_coalesces_frames_while_busy(void)
+{
+    uint8_t payload[4] = {1, 2, 3, 4};
+
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_enqueue(&queue, payload, sizeof(payload)));
+    }
+    // The first frame went out alone, the other four wait for it
+    TEST_ASSERT_EQUAL(1, transfer_count);
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_transfer_complete(&queue));
+    TEST_ASSERT_EQUAL(2, transfer_count);
+    TEST_ASSERT_EQUAL(4 * cff_calculate_frame_size_bytes(sizeof(payload)), transfer_sizes[1]);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_transfer_complete(&queue));
+    TEST_ASSERT_TRUE(cff_tx_queue_idle(&queue));
+
+    TEST_ASSERT_EQUAL(5, queue.frames_enqueued);
+    TEST_ASSERT_EQUAL(2, queue.transfers_started);
+
+    // Counters are in enqueue order across transfers
+    TEST_ASSERT_EQUAL(5, receive_wire());
+    for (uint16_t i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(i, received_counters[i]);
+    }
+}
+
+void test_tx_queue_full_until_completion(void)
+{
+    uint8_t payload[20] = {0};
+    size_t frame_size_bytes = cff_calculate_frame_size_bytes(sizeof(payload));
+    size_t frames_per_half = (sizeof(queue_buffer) / 2) / frame_size_bytes;
+
+    // One frame in flight, then fill the other half
+    TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_enqueue(&queue, payload, sizeof(payload)));
+    for (size_t i = 0; i < frames_per_half; i++) {
+        TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_enqueue(&queue, payload, sizeof(payload)));
+    }
+    TEST_ASSERT_EQUAL(cff_error_buffer_full, cff_tx_queue_enqueue(&queue, payload, sizeof(payload)));
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_transfer_complete(&queue));
+    TEST_ASSERT_EQUAL(frames_per_half * frame_size_bytes, transfer_sizes[1]);
+    TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_enqueue(&queue, payload, sizeof(payload)));
+
+    // A frame larger than a half can never be sent
+    uint8_t large[sizeof(queue_buffer) / 2] = {0};
+    TEST_ASSERT_EQUAL(cff_error_buffer_too_small, cff_tx_queue_enqueue(&queue, large, sizeof(large)));
+
+    while (!cff_tx_queue_idle(&queue)) {
+        TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_transfer_complete(&queue));
+    }
+    TEST_ASSERT_EQUAL(frames_per_half + 2, receive_wire());
+    for (uint16_t i = 0; i < received_count; i++) {
+        TEST_ASSERT_EQUAL(i, received_counters[i]);
+    }
+}
+
+void test_tx_queue_completion_during_enqueue(void)
+{
+    uint8_t payload[8] = {0};
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_enqueue(&queue, payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_enqueue(&queue, payload, sizeof(payload)));
+
+    // The transfer completes while the third frame is being built. The fill half is left alone and the enqueue
+    // sends both waiting frames once it is done.
+    TEST_ASSERT_EQUAL(cff_error_none, cff_crc_set_provider(&interrupting_provider));
+    interrupts_pending = 1;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_enqueue(&queue, payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL(0, interrupts_pending);
+    TEST_ASSERT_EQUAL(2, transfer_count);
+    TEST_ASSERT_EQUAL(2 * cff_calculate_frame_size_bytes(sizeof(payload)), transfer_sizes[1]);
+
+    TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_transfer_complete(&queue));
+    TEST_ASSERT_TRUE(cff_tx_queue_idle(&queue));
+    TEST_ASSERT_EQUAL(3, receive_wire());
+}
+
+void test_tx_queue_completion_during_enqueue_into_full_half(void)
+{
+    uint8_t payload[20] = {0};
+    size_t frames_per_half = (sizeof(queue_buffer) / 2) / cff_calculate_frame_size_bytes(sizeof(payload));
+
+    for (size_t i = 0; i < frames_per_half + 1; i++) {
+        TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_enqueue(&queue, payload, sizeof(payload)));
+    }
+
+    // The fill half is full and the transfer completes just after an enqueue has begun, before it finds no room.
+    // The completion leaves the full half to the enqueue, which hands it over and retries.
+    queue.enqueue_in_progress = true;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_transfer_complete(&queue));
+    TEST_ASSERT_EQUAL(1, transfer_count);
+    queue.enqueue_in_progress = false;
+    TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_enqueue(&queue, payload, sizeof(payload)));
+    TEST_ASSERT_EQUAL(2, transfer_count);
+    TEST_ASSERT_EQUAL(frames_per_half + 2, queue.frames_enqueued);
+
+    while (!cff_tx_queue_idle(&queue)) {
+        TEST_ASSERT_EQUAL(cff_error_none, cff_tx_queue_transfer_complete(&queue));
+    }
+    TEST_ASSERT_EQUAL(frames_per_half + 2, receive_wire());
+    TEST_ASSERT_EQUAL(frames_per_half + 1, received_counters[received_count - 1]);
+}
@@ -0,0 +1,128 @@
+// Command line tool to build a sidecar index for a capture file and look frames up through it.
+//
+//   cff_index build <capture> [index] [threads]   write <index> (default <capture>.idx)
+//   cff_index frame <capture> <index> <n>          print frame n
+//   cff_index counters <capture> <index> <first> [last]
+//                                                  print frames whose extended counter is in [first, last]
+//
+// Extended counters are the frame counter with its rollover epoch above it, (epoch << 16) | counter.
+
+#include "cff.h"
+#include "cff_capture.h"
+#include "cff_index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int usage(void)
+{
+    fprintf(stderr, "usage: cff_index build <capture> [index] [threads]\n"
+                    "       cff_index frame <capture> <index> <n>\n"
+                    "       cff_index counters <capture> <index> <first> [last]\n");
+    return 2;
+}
+
+static void print_frame(const cff_index_t *index, const cff_capture_t *capture, uint64_t entry_index)
+{
+    cff_index_entry_t entry;
+    cff_index_entry(index, entry_index, &entry);
+
+    cff_frame_t frame;
+    cff_error_en_t error = cff_index_read_frame(index, capture->data, capture->size_bytes, entry_index, &frame);
+    printf("#%llu offset %llu counter %llu (epoch %u, %u) payload %u bytes", (unsigned long long) entry_index,
+           (unsigned long long) entry.offset_bytes, (unsigned long long) cff_index_entry_counter(&entry),
+           (unsigned) entry.epoch, (unsigned) entry.frame_counter, (unsigned) entry.payload_size_bytes);
+    if (error != cff_error_none) {
+        printf(" - does not match the capture (error %d)\n", (int) error);
+        return;
+    }
+
+    printf(":");
+    for (size_t i = 0; i < frame.payload_size_bytes && i < 32; i++) {
+        printf(" %02x", frame.payload[i]);
+    }
+    printf(frame.payload_size_bytes > 32 ? " ...\n" : "\n");
+}
+
+static int build(int argc, char **argv)
+{
+    const char *capture_path = argv[2];
+    char default_index_path[4096];
+    snprintf(default_index_path, sizeof(default_index_path), "%s.idx", capture_path);
+    const char *index_path = argc > 3 ? argv[3] : default_index_path;
+    size_t thread_count = argc > 4 ? (size_t) strtoul(argv[4], NULL, 10) : 4;
+
+    cff_capture_t capture;
+    if (cff_capture_open(&capture, capture_path) != cff_error_none) {
+        fprintf(stderr, "cannot open %s\n", capture_path);
+        return 1;
+    }
+
+    uint64_t frames_indexed = 0;
+    cff_error_en_t error = cff_index_build(capture.data, capture.size_bytes, thread_count, index_path, &frames_indexed);
+    cff_capture_close(&capture);
+    if (error != cff_error_none) {
+        fprintf(stderr, "cannot write %s (error %d)\n", index_path, (int) error);
+        return 1;
+    }
+
+    printf("%llu frames indexed in %s\n", (unsigned long long) frames_indexed, index_path);
+    return 0;
+}
+
+static int look_up(int argc, char **argv)
+{
+    uint64_t first = strtoull(argv[4], NULL, 0);
+    uint64_t last = argc > 5 ? strtoull(argv[5], NULL, 0) : first;
+    if (first > last) {
+        return usage();
+    }
+
+    cff_capture_t capture;
+    if (cff_capture_open(&capture, argv[2]) != cff_error_none) {
+        fprintf(stderr, "cannot open %s\n", argv[2]);
+        return 1;
+    }
+    cff_index_t index;
+    if (cff_index_open(&index, argv[3]) != cff_error_none) {
+        fprintf(stderr, "%s is not a valid index\n", argv[3]);
+        cff_capture_close(&capture);
+        return 1;
+    }
+
+    if (strcmp(argv[1], "frame") == 0) {
+        if (first < index.entry_count) {
+            print_frame(&index, &capture, first);
+        }
+        else {
+            fprintf(stderr, "the capture has %llu frames\n", (unsigned long long) index.entry_count);
+        }
+    }
+    else {
+        uint64_t begin;
+        uint64_t end = index.entry_count;
+        cff_index_find_counter(&index, first, &begin);
+        // last + 1 would wrap to 0, and every counter is at most UINT64_MAX
+        if (last != UINT64_MAX) {
+            cff_index_find_counter(&index, last + 1, &end);
+        }
+        for (uint64_t i = begin; i < end; i++) {
+            print_frame(&index, &capture, i);
+        }
+    }
+
+    cff_index_close(&index);
+    cff_capture_close(&capture);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 3 && strcmp(argv[1], "build") == 0) {
+        return build(argc, argv);
+    }
+    if (argc >= 5 && (strcmp(argv[1], "frame") == 0 || strcmp(argv[1], "counters") == 0)) {
+        return look_up(argc, argv);
+    }
+    return usage();
+}